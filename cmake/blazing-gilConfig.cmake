@@ -7,6 +7,7 @@ if(${CMAKE_FIND_PACKAGE_NAME}_FIND_REQUIRED)
 endif()
 find_package(Boost COMPONENTS filesystem ${blazingGilExtraArgs})
 find_package(blaze  ${blazingGilExtraArgs})
+find_package(Threads ${blazingGilExtraArgs})
 
 include(${CMAKE_CURRENT_LIST_DIR}/blazing-gilTargets.cmake)
 
@@ -14,6 +14,7 @@
 #include <limits>
 
 #include <flash/core.hpp>
+#include <flash/kernels.hpp>
 #include <flash/numeric.hpp>
 
 namespace gil = boost::gil;
@@ -30,9 +31,8 @@ void run(const std::string& input_file, double delta_t, double kappa, std::uint6
     auto mat = flash::to_matrix_channeled(view);
     auto diffused = flash::anisotropic_diffusion(mat, delta_t, kappa, iteration_count);
 
-    auto image = flash::from_matrix<ImageType>(diffused);
-    auto diffused_min = flash::channelwise_min(diffused);
-    auto diffused_max = flash::channelwise_max(diffused);
+    auto image = flash::from_matrix<ImageType>(flash::saturate_round_conversion{}, diffused);
+    const auto [diffused_min, diffused_max] = flash::channelwise_minmax(diffused);
 
     std::cout << "diffused min: " << diffused_min << '\n'
               << "diffused max: " << diffused_max << '\n';
@@ -83,9 +83,9 @@ int main(int argc, char* argv[])
             sum_after += mat(i, j)[0];
         }
     }
-    auto image = flash::from_matrix<gil::gray8_image_t>(diffused);
-    auto diffused_min = flash::channelwise_min(diffused);
-    auto diffused_max = flash::channelwise_max(diffused);
+    auto image =
+        flash::from_matrix<gil::gray8_image_t>(flash::saturate_round_conversion{}, diffused);
+    const auto [diffused_min, diffused_max] = flash::channelwise_minmax(diffused);
 
     std::cout << "diffused min: " << diffused_min << '\n'
               << "diffused max: " << diffused_max << '\n';
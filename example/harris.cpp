@@ -10,7 +10,10 @@
 #include <iostream>
 #include <limits>
 
+#include <flash/color.hpp>
 #include <flash/core.hpp>
+#include <flash/kernels.hpp>
+#include <flash/matrix_image.hpp>
 #include <flash/numeric.hpp>
 
 namespace gil = boost::gil;
@@ -48,11 +51,7 @@ int main(int argc, char* argv[])
     gil::rgb8_image_t input;
     gil::read_image(input_file, input, gil::png_tag{});
 
-    gil::gray8_image_t gray(input.dimensions());
-    gil::copy_and_convert_pixels(gil::view(input), gil::view(gray));
-
-    auto image = flash::to_matrix(gil::view(gray));
-    blaze::DynamicMatrix<std::int16_t> mat(image);
+    auto mat = flash::rgb_to_gray<std::uint8_t>(gil::view(input));
     auto harris = flash::harris(mat, k);
     harris = blaze::map(harris, [](std::int64_t x) {
         if (x >= 0)
@@ -61,7 +60,7 @@ int main(int argc, char* argv[])
             return static_cast<std::int64_t>(0);
     });
 
-    image = flash::remap_to<unsigned char>(harris);
+    blaze::DynamicMatrix<unsigned char> image = flash::remap_to<unsigned char>(harris);
     for (std::size_t i = 0; i < image.rows(); ++i) {
         for (std::size_t j = 0; j < image.columns(); ++j) {
             if (harris(i, j) >= threshold) {
@@ -73,6 +72,6 @@ int main(int argc, char* argv[])
     std::cout << "Gradient range: " << blaze::max(harris) << ' ' << blaze::min(harris) << '\n'
               << "Final gray image range: " << static_cast<int>(blaze::max(image)) << ' '
               << static_cast<int>(blaze::min(image)) << '\n';
-    gil::write_view(harris_response_file, gil::view(gray), gil::png_tag{});
+    gil::write_view(harris_response_file, flash::as_view(image), gil::png_tag{});
     gil::write_view(output_file, gil::view(input), gil::png_tag{});
 }
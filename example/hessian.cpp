@@ -7,7 +7,9 @@
 
 #include <CLI/CLI.hpp>
 
+#include <flash/color.hpp>
 #include <flash/core.hpp>
+#include <flash/kernels.hpp>
 #include <flash/numeric.hpp>
 
 #include <iostream>
@@ -52,12 +54,8 @@ int main(int argc, char* argv[])
     gil::rgb8_image_t input;
     gil::read_image(input_file, input, gil::png_tag{});
 
-    gil::gray8_image_t gray(input.dimensions());
-    gil::copy_and_convert_pixels(gil::view(input), gil::view(gray));
-
-    auto image = flash::to_matrix(gil::view(gray));
-    blaze::DynamicMatrix<std::int16_t> mat(image);
-    auto hessian_result = flash::hessian(mat);
+    auto image = flash::rgb_to_gray<std::uint8_t>(gil::view(input));
+    auto hessian_result = flash::hessian(image);
     auto thresholded_dets =
         blaze::evaluate(blaze::map(hessian_result.determinants, [dets_threshold](auto x) {
             return x < dets_threshold ? 0 : x;
@@ -66,19 +64,16 @@ int main(int argc, char* argv[])
         blaze::evaluate(blaze::map(hessian_result.traces, [traces_threshold](auto x) {
             return x < traces_threshold ? 0 : x;
         }));
-    auto dets_nonmax_map = flash::nonmax_map(thresholded_dets, 3);
-    auto trace_nonmax_map = flash::nonmax_map(thresholded_traces, 3);
+    // pixels that are a maximum in both maps are kept, the rest is marked
+    auto marked = ~(flash::nonmax_mask(thresholded_dets, 3) &
+                    flash::nonmax_mask(thresholded_traces, 3));
 
     auto determinants_map =
         flash::to_gray8_image(flash::remap_to<unsigned char>(hessian_result.determinants));
     auto traces_map = flash::to_gray8_image(flash::remap_to<unsigned char>(hessian_result.traces));
-    for (std::size_t i = 0; i < image.rows(); ++i) {
-        for (std::size_t j = 0; j < image.columns(); ++j) {
-            if (!dets_nonmax_map(i, j) || !trace_nonmax_map(i, j)) {
-                gil::view(input)(j, i) = gil::rgb8_pixel_t(0, 255, 0);
-            }
-        }
-    }
+    marked.for_each_set([&input](std::size_t i, std::size_t j) {
+        gil::view(input)(j, i) = gil::rgb8_pixel_t(0, 255, 0);
+    });
 
     std::cout << "Gradient range: " << blaze::max(hessian_result.determinants) << ' '
               << blaze::min(hessian_result.determinants) << '\n'
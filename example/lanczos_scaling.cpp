@@ -38,9 +38,11 @@ int main(int argc, char* argv[])
     gil::gray8_image_t input;
     gil::read_image(input_file, input, gil::png_tag{});
 
-    blaze::DynamicMatrix<unsigned char> image = flash::to_matrix(gil::view(input));
-    auto resized = flash::scale(flash::lanczos_method{}, image, new_width, new_height, 3);
-    std::cout << resized.rows() << ' ' << resized.columns() << '\n';
-    auto resized_image = flash::to_gray8_image(resized);
+    gil::gray8_image_t resized_image(new_width, new_height);
+    flash::scale(flash::lanczos_method{},
+                 flash::as_matrix(gil::view(input)),
+                 gil::view(resized_image),
+                 a);
+    std::cout << resized_image.height() << ' ' << resized_image.width() << '\n';
     gil::write_view(output_file, gil::view(resized_image), gil::png_tag{});
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <boost/gil/image_view.hpp>
 #include <boost/gil/typedefs.hpp>
 #include <flash/core.hpp>
+#include <flash/kernels.hpp>
 #include <iostream>
 
 namespace gil = boost::gil;
@@ -4,6 +4,7 @@
 #include <boost/gil/typedefs.hpp>
 
 #include <flash/core.hpp>
+#include <flash/matrix_image.hpp>
 #include <iostream>
 
 int main()
@@ -11,9 +12,8 @@ int main()
     blaze::DynamicMatrix<unsigned char> matrix(16, 16, 255);
     auto padded = flash::pad(matrix, 8, 0);
 
-    auto image = flash::to_gray8_image(padded);
     boost::gil::write_view(
-        "output.png", boost::gil::view(image), boost::gil::png_tag{});
+        "output.png", flash::as_view(padded), boost::gil::png_tag{});
 
     std::cout << padded.rows() << ' ' << padded.columns() << '\n';
     for (std::size_t i = 0; i < padded.rows(); ++i) {
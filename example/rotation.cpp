@@ -0,0 +1,50 @@
+#include <blaze/Blaze.h>
+#include <flash/core.hpp>
+#include <flash/warp.hpp>
+
+#include <boost/gil/extension/io/png.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/image_view.hpp>
+#include <boost/gil/typedefs.hpp>
+
+#include <CLI/CLI.hpp>
+
+#include <cmath>
+#include <string>
+
+namespace gil = boost::gil;
+
+int main(int argc, char* argv[])
+{
+    std::string input_file;
+    std::string output_file;
+    double angle = 0;
+
+    CLI::App app{"Rotation around image center using affine warp"};
+    app.add_option("i,--input", input_file, "PNG Grayscale input file")
+        ->required()
+        ->check(CLI::ExistingFile);
+    app.add_option("o,--output", output_file, "PNG file that will contain grayscale output")
+        ->required();
+    app.add_option("a,--angle", angle, "Rotation angle in degrees")->required();
+
+    CLI11_PARSE(app, argc, argv);
+
+    gil::gray8_image_t input;
+    gil::read_image(input_file, input, gil::png_tag{});
+
+    const double radians = angle * flash::pi / 180;
+    const double center_x = input.width() / 2.0;
+    const double center_y = input.height() / 2.0;
+    const double cosine = std::cos(radians);
+    const double sine = std::sin(radians);
+    flash::affine_transform rotation{
+        {cosine, -sine, center_x - cosine * center_x + sine * center_y},
+        {sine, cosine, center_y - sine * center_x - cosine * center_y}};
+
+    auto source = flash::as_matrix(gil::view(input));
+    auto rotated = flash::warp_affine(
+        source, rotation, input.width(), input.height(), flash::bilinear_interpolation{});
+    auto output = flash::to_gray8_image(rotated);
+    gil::write_view(output_file, gil::view(output), gil::png_tag{});
+}
@@ -7,8 +7,11 @@
 
 #include <CLI/CLI.hpp>
 
+#include <flash/color.hpp>
 #include <flash/convolution.hpp>
 #include <flash/core.hpp>
+#include <flash/kernels.hpp>
+#include <flash/matrix_image.hpp>
 
 #include <iostream>
 #include <limits>
@@ -33,11 +36,7 @@ int main(int argc, char* argv[])
     gil::rgb8_image_t input;
     gil::read_image(input_file, input, gil::png_tag{});
 
-    gil::gray8_image_t gray(input.dimensions());
-    gil::copy_and_convert_pixels(gil::view(input), gil::view(gray));
-
-    auto image = flash::to_matrix(gil::view(gray));
-    blaze::DynamicMatrix<std::int16_t> mat(image);
+    auto mat = flash::rgb_to_gray<std::int16_t>(gil::view(input));
     auto dx = flash::convolve(mat, flash::sobel_x);
 
     auto dy = flash::convolve(mat, flash::sobel_y);
@@ -45,13 +44,10 @@ int main(int argc, char* argv[])
     auto gradient =
         blaze::map(dx, dy, [](std::int16_t x, std::int16_t y) { return std::sqrt(x * x + y * y); });
 
-    image = flash::remap_to<unsigned char>(gradient);
+    blaze::DynamicMatrix<unsigned char> image = flash::remap_to<unsigned char>(gradient);
 
     std::cout << "Gradient range: " << blaze::max(gradient) << ' ' << blaze::min(gradient) << '\n'
               << "Final gray image range: " << static_cast<int>(blaze::max(image)) << ' '
               << static_cast<int>(blaze::min(image)) << '\n';
-    // gil::write_view(argv[2],
-    // gil::color_converted_view<gil::gray16_pixel_t>(gil::view(gray)),
-    // gil::png_tag{});
-    gil::write_view(output_file, gil::view(gray), gil::png_tag{});
+    gil::write_view(output_file, flash::as_view(image), gil::png_tag{});
 }
@@ -0,0 +1,207 @@
+#ifndef BLAZING_GIL_ALIGNED_IMAGE_HPP
+#define BLAZING_GIL_ALIGNED_IMAGE_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/core.hpp>
+
+#include <boost/gil/image.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+
+namespace flash
+{
+/// alignment of rows of `aligned_image`, enough for the widest SIMD registers (AVX-512)
+constexpr std::size_t simd_row_alignment = 64;
+
+namespace detail
+{
+template <typename Pixel, bool IsPlanar>
+constexpr std::size_t image_element_size_v =
+    IsPlanar ? sizeof(typename boost::gil::channel_type<Pixel>::type) : sizeof(Pixel);
+} // namespace detail
+
+/** \brief `gil::image` whose rows start at 64 byte boundary and are padded with zeros
+
+    Rows are padded to a multiple of 64 bytes (and of the pixel size, e.g. 192 bytes for rgb8),
+    so `as_matrix` and `as_matrix_channeled` of the image can be `aligned, padded` Blaze matrices,
+    which lets Blaze skip peeling and remainder loops. The padding is kept zeroed, as Blaze
+    requires for padded matrices.
+
+    The type is a drop-in replacement of `gil::image`, including `gil::read_image`, which
+    recreates images through `recreate(width, height)` that is hidden here to keep the alignment.
+    Do note that writing through `gil::view` of the image never touches the padding, but writing
+    into the padding through a Blaze matrix does break the assumption.
+
+    \tparam Pixel The pixel type, e.g. `gil::gray8_pixel_t`
+    \tparam IsPlanar Whether channels are stored in separate planes
+*/
+template <typename Pixel, bool IsPlanar = false>
+class aligned_image : public boost::gil::image<Pixel, IsPlanar>
+{
+  public:
+    using base_type = boost::gil::image<Pixel, IsPlanar>;
+    using typename base_type::point_t;
+    using typename base_type::x_coord_t;
+    using typename base_type::y_coord_t;
+
+    static constexpr std::size_t alignment =
+        std::lcm(simd_row_alignment, detail::image_element_size_v<Pixel, IsPlanar>);
+
+    aligned_image() : base_type(alignment) {}
+
+    explicit aligned_image(const point_t& dimensions) : base_type(dimensions, alignment)
+    {
+        zero_padding();
+    }
+
+    aligned_image(x_coord_t width, y_coord_t height) : base_type(width, height, alignment)
+    {
+        zero_padding();
+    }
+
+    aligned_image(x_coord_t width, y_coord_t height, const Pixel& value)
+        : base_type(width, height, value, alignment)
+    {
+        zero_padding();
+    }
+
+    aligned_image(const aligned_image& other) : base_type(other) { zero_padding(); }
+    aligned_image(aligned_image&& other) = default;
+
+    aligned_image& operator=(const aligned_image& other)
+    {
+        base_type::operator=(other);
+        zero_padding();
+        return *this;
+    }
+
+    aligned_image& operator=(aligned_image&& other) = default;
+
+    void recreate(const point_t& dimensions)
+    {
+        base_type::recreate(dimensions, alignment);
+        zero_padding();
+    }
+
+    void recreate(x_coord_t width, y_coord_t height) { recreate(point_t(width, height)); }
+
+    void recreate(const point_t& dimensions, const Pixel& value)
+    {
+        base_type::recreate(dimensions, value, alignment);
+        zero_padding();
+    }
+
+    void recreate(x_coord_t width, y_coord_t height, const Pixel& value)
+    {
+        recreate(point_t(width, height), value);
+    }
+
+    /// distance between the starts of consecutive rows in units of `Pixel` (channels if planar)
+    std::size_t spacing() const
+    {
+        return boost::gil::const_view(*this).pixels().row_size() /
+               detail::image_element_size_v<Pixel, IsPlanar>;
+    }
+
+  private:
+    void zero_padding()
+    {
+        auto image_view = boost::gil::view(*this);
+        constexpr std::size_t plane_count =
+            IsPlanar ? boost::gil::num_channels<Pixel>::value : 1;
+        const std::size_t row_size = image_view.pixels().row_size();
+        const std::size_t used_size =
+            image_view.width() * detail::image_element_size_v<Pixel, IsPlanar>;
+        for (signed_size i = 0; i < image_view.height(); ++i) {
+            for (std::size_t plane = 0; plane < plane_count; ++plane) {
+                auto* row =
+                    reinterpret_cast<unsigned char*>(detail::channel_pointer(image_view, i, plane));
+                std::fill(row + used_size, row + row_size, static_cast<unsigned char>(0));
+            }
+        }
+    }
+};
+
+namespace detail
+{
+template <typename View>
+auto as_aligned_matrix(View source, std::size_t spacing)
+{
+    static_assert(boost::gil::num_channels<View>::value == 1,
+                  "as_matrix works only with single channel images, use as_matrix_channeled");
+    auto* data = channel_pointer(source, 0, 0);
+    using element_type = std::remove_pointer_t<decltype(data)>;
+    return blaze::CustomMatrix<element_type, blaze::aligned, blaze::padded>(
+        data, source.height(), source.width(), spacing);
+}
+
+template <typename View>
+auto as_aligned_matrix_channeled(View source, std::size_t spacing)
+{
+    static_assert(!boost::gil::is_planar<View>::value,
+                  "planar images cannot be viewed as matrix of vectors");
+    using pixel_t = typename View::value_type;
+    using channel_t = true_channel_type_t<typename boost::gil::channel_type<View>::type>;
+    using vector_t = blaze::StaticVector<channel_t,
+                                         boost::gil::num_channels<View>::value,
+                                         blaze::rowMajor,
+                                         blaze::unaligned,
+                                         blaze::unpadded>;
+    using pixel_reference = std::remove_reference_t<typename View::reference>;
+    using element_type =
+        std::conditional_t<std::is_const_v<pixel_reference>, const vector_t, vector_t>;
+    static_assert(sizeof(pixel_t) == sizeof(vector_t),
+                  "The function is made to believe that pixel and corresponding vector types are"
+                  "layout compatible, but they are not");
+    return blaze::CustomMatrix<element_type, blaze::aligned, blaze::padded>(
+        reinterpret_cast<element_type*>(&source(0, 0)), source.height(), source.width(), spacing);
+}
+} // namespace detail
+
+/** \brief constructs `aligned, padded` `blaze::CustomMatrix` out of a single channel
+    `aligned_image`
+
+    Same as `as_matrix` of the image's view, but the alignment and padding flags are set, and the
+    spacing of the matrix is the row size of the image.
+
+    \return A `CustomMatrix<ChannelType, aligned, padded>`
+*/
+template <typename Pixel, bool IsPlanar>
+auto as_matrix(aligned_image<Pixel, IsPlanar>& image)
+{
+    return detail::as_aligned_matrix(boost::gil::view(image), image.spacing());
+}
+
+template <typename Pixel, bool IsPlanar>
+auto as_matrix(const aligned_image<Pixel, IsPlanar>& image)
+{
+    return detail::as_aligned_matrix(boost::gil::const_view(image), image.spacing());
+}
+
+/** \brief constructs `aligned, padded` `blaze::CustomMatrix` of `StaticVector`s out of an
+    interleaved `aligned_image`
+
+    Same layout compatibility requirements as `as_matrix_channeled` apply, only unpadded vectors
+    are supported.
+
+    \return A `CustomMatrix<StaticVector<ChannelType, num_channels, rowMajor, unaligned,
+    unpadded>, aligned, padded>`
+*/
+template <typename Pixel>
+auto as_matrix_channeled(aligned_image<Pixel, false>& image)
+{
+    return detail::as_aligned_matrix_channeled(boost::gil::view(image), image.spacing());
+}
+
+template <typename Pixel>
+auto as_matrix_channeled(const aligned_image<Pixel, false>& image)
+{
+    return detail::as_aligned_matrix_channeled(boost::gil::const_view(image), image.spacing());
+}
+} // namespace flash
+
+#endif
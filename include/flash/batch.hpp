@@ -0,0 +1,324 @@
+#ifndef BLAZING_GIL_BATCH_HPP
+#define BLAZING_GIL_BATCH_HPP
+
+#include <blaze/Blaze.h>
+#include <boost/gil/image.hpp>
+#include <boost/gil/image_view.hpp>
+
+#include <flash/convolution.hpp>
+#include <flash/core.hpp>
+#include <flash/parallel.hpp>
+#include <flash/scaling.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace flash
+{
+/** \brief Many images of the same size, interleaved across SIMD lanes
+
+    Meant for large numbers of small images, e.g. thumbnails, where allocations, kernel flips
+    and filter setup of one call per image cost as much as the work itself. Images are stored
+    in groups of `Lanes`: a group is a matrix of `rows()` by `columns() * Lanes` elements, in
+    which the values of one pixel position of all images of the group are adjacent. Batched
+    operations do their setup once, process a pixel position of a whole group with vector
+    instructions and distribute groups over threads with `parallel_for`. Lanes of the last
+    group past `size()` are zero.
+
+    \tparam T Scalar element type, multi channel images are batched one plane at a time
+    \tparam Lanes Images per group, 16 `float`s fill an AVX-512 register
+*/
+template <typename T, std::size_t Lanes = 16>
+class image_batch
+{
+  public:
+    static_assert(std::is_arithmetic_v<T>, "batches hold scalar elements");
+    static_assert(Lanes > 0, "groups must have at least one lane");
+
+    using element_type = T;
+    using group_type = blaze::DynamicMatrix<T>;
+    static constexpr std::size_t lanes = Lanes;
+
+    image_batch() = default;
+
+    image_batch(std::size_t count, std::size_t rows, std::size_t columns)
+        : image_count(count), row_count(rows), column_count(columns),
+          groups((count + Lanes - 1) / Lanes, group_type(rows, columns * Lanes, T{}))
+    {
+    }
+
+    /// number of images
+    std::size_t size() const noexcept { return image_count; }
+    std::size_t rows() const noexcept { return row_count; }
+    std::size_t columns() const noexcept { return column_count; }
+    std::size_t group_count() const noexcept { return groups.size(); }
+
+    group_type& group(std::size_t index) { return groups[index]; }
+    const group_type& group(std::size_t index) const { return groups[index]; }
+
+    /// the `Lanes` values of pixel (i, j), one for every image of the group
+    T* lanes_at(std::size_t group, std::size_t i, std::size_t j)
+    {
+        return groups[group].data(i) + j * Lanes;
+    }
+
+    const T* lanes_at(std::size_t group, std::size_t i, std::size_t j) const
+    {
+        return groups[group].data(i) + j * Lanes;
+    }
+
+    T& operator()(std::size_t image, std::size_t i, std::size_t j)
+    {
+        return groups[image / Lanes](i, j * Lanes + image % Lanes);
+    }
+
+    const T& operator()(std::size_t image, std::size_t i, std::size_t j) const
+    {
+        return groups[image / Lanes](i, j * Lanes + image % Lanes);
+    }
+
+    /** \brief Copies `image` into slot `index`
+
+        A 3-D tensor of images can be loaded slice by slice through `CustomMatrix`es.
+    */
+    template <typename MT, bool SO>
+    void set(std::size_t index, const blaze::DenseMatrix<MT, SO>& image)
+    {
+        check_slot(index, (~image).rows(), (~image).columns());
+        for (std::size_t i = 0; i < row_count; ++i) {
+            for (std::size_t j = 0; j < column_count; ++j) {
+                (*this)(index, i, j) = static_cast<T>((~image)(i, j));
+            }
+        }
+    }
+
+    /// copies `channel` of every pixel of `view` into slot `index`
+    template <typename View>
+    void set_view(std::size_t index, const View& view, std::size_t channel = 0)
+    {
+        if (channel >= boost::gil::num_channels<View>::value) {
+            throw std::invalid_argument("channel index exceeds available channels in the view");
+        }
+        check_slot(index, view.height(), view.width());
+        auto& target = groups[index / Lanes];
+        const auto lane = index % Lanes;
+        for (std::size_t i = 0; i < row_count; ++i) {
+            auto it = view.row_begin(static_cast<signed_size>(i));
+            auto* row = target.data(i) + lane;
+            for (std::size_t j = 0; j < column_count; ++j) {
+                row[j * Lanes] = static_cast<T>(it[j][channel]);
+            }
+        }
+    }
+
+    /// copy of the image in slot `index`
+    blaze::DynamicMatrix<T> image(std::size_t index) const
+    {
+        check_slot(index, row_count, column_count);
+        blaze::DynamicMatrix<T> result(row_count, column_count);
+        for (std::size_t i = 0; i < row_count; ++i) {
+            for (std::size_t j = 0; j < column_count; ++j) {
+                result(i, j) = (*this)(index, i, j);
+            }
+        }
+        return result;
+    }
+
+  private:
+    void check_slot(std::size_t index, std::size_t rows, std::size_t columns) const
+    {
+        if (index >= image_count) {
+            throw std::out_of_range("image index exceeds the size of the batch");
+        }
+        if (rows != row_count || columns != column_count) {
+            throw std::invalid_argument("image dimensions must match the batch");
+        }
+    }
+
+    std::size_t image_count = 0;
+    std::size_t row_count = 0;
+    std::size_t column_count = 0;
+    std::vector<group_type> groups;
+};
+
+/** \brief Batch of the matrices in [first, last), which must all have the same dimensions
+
+    \tparam T The element type of the batch, the element type of the matrices by default
+*/
+template <typename T = void, std::size_t Lanes = 16, typename Iterator>
+auto make_batch(Iterator first, Iterator last)
+{
+    using matrix_type = typename std::iterator_traits<Iterator>::value_type;
+    using element_type = std::conditional_t<std::is_void_v<T>,
+                                            std::remove_cv_t<blaze::ElementType_t<matrix_type>>,
+                                            T>;
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    if (count == 0) {
+        return image_batch<element_type, Lanes>();
+    }
+    image_batch<element_type, Lanes> result(count, first->rows(), first->columns());
+    for (std::size_t index = 0; first != last; ++first, ++index) {
+        result.set(index, *first);
+    }
+    return result;
+}
+
+/** \brief Batch of `channel` of the views in [first, last), which must all have the same size
+
+    \tparam T The element type of the batch, the channel type of the views by default
+*/
+template <typename T = void, std::size_t Lanes = 16, typename Iterator>
+auto to_batch(Iterator first, Iterator last, std::size_t channel = 0)
+{
+    using view_type = typename std::iterator_traits<Iterator>::value_type;
+    using channel_type = true_channel_type_t<typename boost::gil::channel_type<view_type>::type>;
+    using element_type = std::conditional_t<std::is_void_v<T>, channel_type, T>;
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    if (count == 0) {
+        return image_batch<element_type, Lanes>();
+    }
+    image_batch<element_type, Lanes> result(count, first->height(), first->width());
+    for (std::size_t index = 0; first != last; ++first, ++index) {
+        result.set_view(index, *first, channel);
+    }
+    return result;
+}
+
+/** \brief Converts every image of `batch` into a single channel image of type `ImageType`
+
+    \arg policy How elements are converted into channel values, truncation by default, see
+    `from_matrix`
+*/
+template <typename ImageType, typename T, std::size_t Lanes, typename Policy = truncate_conversion>
+std::vector<ImageType> from_batch(const image_batch<T, Lanes>& batch, Policy policy = {})
+{
+    using channel_t = true_channel_type_t<typename boost::gil::channel_type<ImageType>::type>;
+    static_assert(boost::gil::num_channels<ImageType>::value == 1,
+                  "batches convert into single channel images");
+
+    std::vector<ImageType> images(batch.size());
+    parallel_for(0, batch.size(), [&](std::size_t index) {
+        auto& image = images[index];
+        image.recreate(batch.columns(), batch.rows());
+        auto view = boost::gil::view(image);
+        for (std::size_t i = 0; i < batch.rows(); ++i) {
+            auto* row = detail::channel_pointer(view, static_cast<signed_size>(i), 0);
+            for (std::size_t j = 0; j < batch.columns(); ++j) {
+                row[j] = convert_channel<channel_t>(batch(index, i, j), policy);
+            }
+        }
+    });
+    return images;
+}
+
+/** \brief Convolves every image of `source` with `original_kernel`, as `convolve` does
+
+    The kernel is flipped once for the whole batch, and every kernel element is applied to a
+    pixel position of all images of a group at once.
+
+    \tparam Result The element type of the result and of the accumulation, the element type of
+    `source` by default
+*/
+template <typename Result = void, typename T, std::size_t Lanes, typename Kernel>
+auto convolve(const image_batch<T, Lanes>& source, const Kernel& original_kernel)
+{
+    using result_type = std::conditional_t<std::is_void_v<Result>, T, Result>;
+    using kernel_element = std::remove_cv_t<blaze::ElementType_t<Kernel>>;
+    // the type of `result_type * kernel_element`, as in the `blaze::sum` of `convolve`
+    using accumulator = decltype(result_type{} * kernel_element{});
+
+    const auto kernel = flip_kernel(original_kernel);
+    const auto kernel_size = kernel.rows();
+    const auto m = source.rows();
+    const auto n = source.columns();
+    image_batch<result_type, Lanes> result(source.size(), m, n);
+    if (m < kernel_size || n < kernel_size) {
+        return result;
+    }
+
+    parallel_for(0, source.group_count(), [&](std::size_t group) {
+        accumulator sums[Lanes];
+        for (std::size_t i = kernel_size; i < m; ++i) {
+            for (std::size_t j = kernel_size; j < n; ++j) {
+                std::fill_n(sums, Lanes, accumulator{});
+                for (std::size_t a = 0; a < kernel_size; ++a) {
+                    for (std::size_t b = 0; b < kernel_size; ++b) {
+                        const auto weight = kernel(a, b);
+                        const auto* values =
+                            source.lanes_at(group, i - kernel_size + a, j - kernel_size + b);
+                        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                            sums[lane] += static_cast<result_type>(values[lane]) * weight;
+                        }
+                    }
+                }
+                auto* target = result.lanes_at(group, i, j);
+                for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                    target[lane] = static_cast<result_type>(sums[lane]);
+                }
+            }
+        }
+    });
+    return result;
+}
+
+/** \brief Resizes every image of `source` with the filters of `scanline_scaler`
+
+    Filter taps are computed once for the whole batch. Every group is resampled horizontally
+    into a buffer of `double`s and then vertically, a tap at a time for all images of the group.
+
+    \tparam Method One of `nearest_neighbor`, `bilinear_interpolation` or `lanczos_method`
+    \arg a The Lanczos window size, ignored by other methods
+*/
+template <typename Method, typename T, std::size_t Lanes>
+image_batch<T, Lanes> scale(Method method, const image_batch<T, Lanes>& source,
+                            std::size_t new_width, std::size_t new_height, signed_size a = 3)
+{
+    if (source.rows() == 0 || source.columns() == 0 || new_width == 0 || new_height == 0) {
+        throw std::invalid_argument("cannot scale from or to an empty image");
+    }
+    const auto horizontal = detail::make_resampling_taps(method, source.columns(), new_width, a);
+    const auto vertical = detail::make_resampling_taps(method, source.rows(), new_height, a);
+
+    image_batch<T, Lanes> result(source.size(), new_height, new_width);
+    parallel_for(0, source.group_count(), [&](std::size_t group) {
+        blaze::DynamicMatrix<double> resampled(source.rows(), new_width * Lanes, 0.0);
+        for (std::size_t i = 0; i < source.rows(); ++i) {
+            for (std::size_t x = 0; x < new_width; ++x) {
+                const auto* weights = horizontal.weights.data() + x * horizontal.taps_per_sample;
+                auto* sums = resampled.data(i) + x * Lanes;
+                for (std::size_t k = 0; k < horizontal.count[x]; ++k) {
+                    const auto* values = source.lanes_at(group, i, horizontal.first[x] + k);
+                    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                        sums[lane] += weights[k] * values[lane];
+                    }
+                }
+            }
+        }
+
+        double sums[Lanes];
+        for (std::size_t y = 0; y < new_height; ++y) {
+            const auto* weights = vertical.weights.data() + y * vertical.taps_per_sample;
+            for (std::size_t x = 0; x < new_width; ++x) {
+                std::fill_n(sums, Lanes, 0.0);
+                for (std::size_t k = 0; k < vertical.count[y]; ++k) {
+                    const auto* values = resampled.data(vertical.first[y] + k) + x * Lanes;
+                    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                        sums[lane] += weights[k] * values[lane];
+                    }
+                }
+                auto* target = result.lanes_at(group, y, x);
+                for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                    target[lane] = detail::from_accumulator<T>(sums[lane]);
+                }
+            }
+        }
+    });
+    return result;
+}
+} // namespace flash
+
+#endif
@@ -0,0 +1,307 @@
+#ifndef BLAZING_GIL_BITMASK_HPP
+#define BLAZING_GIL_BITMASK_HPP
+
+#include <blaze/Blaze.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace flash
+{
+namespace detail
+{
+inline std::size_t popcount(std::uint64_t word) noexcept
+{
+#if defined(_MSC_VER)
+    return static_cast<std::size_t>(__popcnt64(word));
+#else
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#endif
+}
+
+/// index of the lowest set bit, `word` must not be zero
+inline std::size_t count_trailing_zeros(std::uint64_t word) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<std::size_t>(index);
+#else
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#endif
+}
+} // namespace detail
+
+/** \brief Matrix of booleans packed into 64 bit words, e.g. for detector and threshold outputs
+
+    Uses an eighth of the memory of `DynamicMatrix<bool>`, and logical operations between masks,
+    counting and scanning for set pixels work on 64 pixels at once. Every row starts at a new
+    word, column `j` of a row is bit `j % 64` of word `j / 64`. Bits past the last column are
+    always zero, which `count` and `for_each_set` rely on.
+*/
+class bitmask
+{
+  public:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    bitmask() = default;
+
+    bitmask(std::size_t rows, std::size_t columns, bool value = false)
+        : row_count(rows), column_count(columns), stride((columns + word_bits - 1) / word_bits),
+          words(rows * stride, value ? ~word_type(0) : word_type(0))
+    {
+        if (value) {
+            clear_tails();
+        }
+    }
+
+    std::size_t rows() const noexcept { return row_count; }
+    std::size_t columns() const noexcept { return column_count; }
+    /// number of words every row occupies
+    std::size_t words_per_row() const noexcept { return stride; }
+
+    bool operator()(std::size_t i, std::size_t j) const noexcept
+    {
+        return (words[i * stride + j / word_bits] >> (j % word_bits)) & 1u;
+    }
+
+    void set(std::size_t i, std::size_t j, bool value = true) noexcept
+    {
+        auto& word = words[i * stride + j / word_bits];
+        const auto bit = word_type(1) << (j % word_bits);
+        word = value ? word | bit : word & ~bit;
+    }
+
+    word_type* row_words(std::size_t i) noexcept { return words.data() + i * stride; }
+    const word_type* row_words(std::size_t i) const noexcept { return words.data() + i * stride; }
+
+    /// mask of the valid bits of the last word of every row
+    word_type tail_mask() const noexcept
+    {
+        const auto used = column_count % word_bits;
+        return used == 0 ? ~word_type(0) : (word_type(1) << used) - 1;
+    }
+
+    /// number of set pixels
+    std::size_t count() const noexcept
+    {
+        std::size_t result = 0;
+        for (auto word : words) {
+            result += detail::popcount(word);
+        }
+        return result;
+    }
+
+    bool any() const noexcept
+    {
+        return std::any_of(words.begin(), words.end(), [](word_type word) { return word != 0; });
+    }
+
+    /** \brief Invokes `function(i, j)` for every set pixel, in row major order
+
+        Zero words are skipped as a whole, set bits are found with a trailing zero count.
+    */
+    template <typename Function>
+    void for_each_set(Function function) const
+    {
+        for (std::size_t i = 0; i < row_count; ++i) {
+            const auto* row = row_words(i);
+            for (std::size_t k = 0; k < stride; ++k) {
+                for (auto word = row[k]; word != 0; word &= word - 1) {
+                    function(i, k * word_bits + detail::count_trailing_zeros(word));
+                }
+            }
+        }
+    }
+
+    bitmask& operator&=(const bitmask& other)
+    {
+        return combine(other, [](word_type lhs, word_type rhs) { return lhs & rhs; });
+    }
+
+    bitmask& operator|=(const bitmask& other)
+    {
+        return combine(other, [](word_type lhs, word_type rhs) { return lhs | rhs; });
+    }
+
+    bitmask& operator^=(const bitmask& other)
+    {
+        return combine(other, [](word_type lhs, word_type rhs) { return lhs ^ rhs; });
+    }
+
+    bitmask operator~() const
+    {
+        bitmask result(*this);
+        for (auto& word : result.words) {
+            word = ~word;
+        }
+        result.clear_tails();
+        return result;
+    }
+
+    bool operator==(const bitmask& other) const
+    {
+        return row_count == other.row_count && column_count == other.column_count &&
+               words == other.words;
+    }
+
+    bool operator!=(const bitmask& other) const { return !(*this == other); }
+
+    /// restores the invariant after writing whole words through `row_words`
+    void clear_tails() noexcept
+    {
+        if (stride == 0) {
+            return;
+        }
+        const auto mask = tail_mask();
+        for (std::size_t i = 0; i < row_count; ++i) {
+            words[i * stride + stride - 1] &= mask;
+        }
+    }
+
+  private:
+    template <typename Operation>
+    bitmask& combine(const bitmask& other, Operation operation)
+    {
+        if (row_count != other.row_count || column_count != other.column_count) {
+            throw std::invalid_argument("masks must have the same dimensions");
+        }
+        for (std::size_t index = 0; index < words.size(); ++index) {
+            words[index] = operation(words[index], other.words[index]);
+        }
+        return *this;
+    }
+
+    std::size_t row_count = 0;
+    std::size_t column_count = 0;
+    std::size_t stride = 0;
+    std::vector<word_type> words;
+};
+
+inline bitmask operator&(bitmask lhs, const bitmask& rhs)
+{
+    lhs &= rhs;
+    return lhs;
+}
+
+inline bitmask operator|(bitmask lhs, const bitmask& rhs)
+{
+    lhs |= rhs;
+    return lhs;
+}
+
+inline bitmask operator^(bitmask lhs, const bitmask& rhs)
+{
+    lhs ^= rhs;
+    return lhs;
+}
+
+/** \brief Mask of the elements of `source` for which `predicate(element)` holds
+
+    Bits of a word are accumulated without branches, so that comparisons like
+    `[t](auto x) { return x >= t; }` compile into SIMD compares and mask extraction.
+*/
+template <typename MT, bool SO, typename Predicate>
+bitmask make_mask(const blaze::DenseMatrix<MT, SO>& source, Predicate predicate)
+{
+    constexpr auto word_bits = bitmask::word_bits;
+    bitmask result((~source).rows(), (~source).columns());
+    for (std::size_t i = 0; i < result.rows(); ++i) {
+        auto* row = result.row_words(i);
+        for (std::size_t k = 0; k < result.words_per_row(); ++k) {
+            const auto first = k * word_bits;
+            const auto last = std::min(first + word_bits, result.columns());
+            bitmask::word_type word = 0;
+            for (std::size_t j = first; j < last; ++j) {
+                word |= bitmask::word_type(predicate((~source)(i, j)) ? 1 : 0) << (j - first);
+            }
+            row[k] = word;
+        }
+    }
+    return result;
+}
+
+/// `DynamicMatrix<bool>` with the pixels of `mask`, for interoperation with Blaze
+inline blaze::DynamicMatrix<bool> to_bool_matrix(const bitmask& mask)
+{
+    blaze::DynamicMatrix<bool> result(mask.rows(), mask.columns(), false);
+    mask.for_each_set([&result](std::size_t i, std::size_t j) { result(i, j) = true; });
+    return result;
+}
+
+namespace detail
+{
+/// ORs every row with itself shifted by one column in both directions
+inline void dilate_rows(bitmask& mask)
+{
+    constexpr auto top = bitmask::word_bits - 1;
+    const auto words = mask.words_per_row();
+    for (std::size_t i = 0; i < mask.rows(); ++i) {
+        auto* row = mask.row_words(i);
+        bitmask::word_type carry_in = 0;
+        for (std::size_t k = 0; k < words; ++k) {
+            const auto word = row[k];
+            const auto next = k + 1 < words ? row[k + 1] : 0;
+            row[k] = word | (word << 1) | carry_in | (word >> 1) | (next << top);
+            carry_in = word >> top;
+        }
+    }
+    mask.clear_tails();
+}
+
+/// ORs every row with the rows above and below
+inline void dilate_columns(bitmask& mask)
+{
+    const auto words = mask.words_per_row();
+    std::vector<bitmask::word_type> previous(words, 0);
+    std::vector<bitmask::word_type> current(words);
+    for (std::size_t i = 0; i < mask.rows(); ++i) {
+        auto* row = mask.row_words(i);
+        std::copy_n(row, words, current.begin());
+        for (std::size_t k = 0; k < words; ++k) {
+            auto word = current[k] | previous[k];
+            if (i + 1 < mask.rows()) {
+                word |= mask.row_words(i + 1)[k];
+            }
+            row[k] = word;
+        }
+        std::swap(previous, current);
+    }
+}
+} // namespace detail
+
+/** \brief Binary dilation with a square of `2 * radius + 1` pixels
+
+    Pixels outside of the mask are unset. The square is decomposed into `radius` dilations by
+    3x3, each of which is a pair of shifted ORs on whole words.
+*/
+inline bitmask dilate(bitmask mask, std::size_t radius)
+{
+    for (std::size_t step = 0; step < radius; ++step) {
+        detail::dilate_rows(mask);
+        detail::dilate_columns(mask);
+    }
+    return mask;
+}
+
+/** \brief Binary erosion with a square of `2 * radius + 1` pixels
+
+    The dual of `dilate`, pixels outside of the mask are considered set, so that the borders of
+    the image do not erode the mask.
+*/
+inline bitmask erode(const bitmask& mask, std::size_t radius)
+{
+    return ~dilate(~mask, radius);
+}
+} // namespace flash
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef BLAZING_GIL_BORDER_HPP
+#define BLAZING_GIL_BORDER_HPP
+
+#include <blaze/Blaze.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace flash
+{
+/// Values outside of the matrix are `value`
+template <typename T>
+struct constant_border {
+    T value;
+};
+
+template <typename T>
+constant_border(T) -> constant_border<T>;
+
+/// Values outside of the matrix are those of the nearest edge element, `aaa|abc|ccc`
+struct replicate_border {
+};
+
+/// The matrix is mirrored around its edge elements, which are not repeated, `cb|abc|ba`
+struct reflect_border {
+};
+
+/// The matrix is repeated periodically, `bc|abc|ab`
+struct wrap_border {
+};
+
+/// true for the border policies above, keeps policies apart from other arguments in overloads
+template <typename Policy>
+constexpr bool is_border_policy_v =
+    std::is_same_v<Policy, replicate_border> || std::is_same_v<Policy, reflect_border> ||
+    std::is_same_v<Policy, wrap_border>;
+
+template <typename T>
+constexpr bool is_border_policy_v<constant_border<T>> = true;
+
+namespace detail
+{
+inline std::ptrdiff_t border_index(replicate_border, std::ptrdiff_t index, std::ptrdiff_t size)
+{
+    return std::clamp<std::ptrdiff_t>(index, 0, size - 1);
+}
+
+inline std::ptrdiff_t border_index(reflect_border, std::ptrdiff_t index, std::ptrdiff_t size)
+{
+    if (size == 1) {
+        return 0;
+    }
+    const auto period = 2 * (size - 1);
+    index %= period;
+    if (index < 0) {
+        index += period;
+    }
+    return index < size ? index : period - index;
+}
+
+inline std::ptrdiff_t border_index(wrap_border, std::ptrdiff_t index, std::ptrdiff_t size)
+{
+    index %= size;
+    return index < 0 ? index + size : index;
+}
+
+template <typename T, typename Matrix>
+auto border_value(const constant_border<T>& policy, const Matrix&, std::ptrdiff_t, std::ptrdiff_t)
+{
+    return policy.value;
+}
+
+template <typename Policy, typename Matrix>
+auto border_value(const Policy& policy, const Matrix& matrix, std::ptrdiff_t i, std::ptrdiff_t j)
+{
+    return matrix(border_index(policy, i, static_cast<std::ptrdiff_t>(matrix.rows())),
+                  border_index(policy, j, static_cast<std::ptrdiff_t>(matrix.columns())));
+}
+} // namespace detail
+
+/** \brief Read-only matrix of `source` surrounded by `padding` elements generated by a border
+    policy, without copying anything
+
+    Semantically like a Blaze view, the source matrix must outlive it. It can be assigned to a
+    matrix to materialize the padded matrix, but filters are meant to read through `get`, which
+    takes source coordinates and may step outside the source, or better to split their loops
+    with `for_each_border_region` and read the source directly in the interior.
+
+    \tparam MT The concrete type of the source matrix
+    \tparam Policy One of `constant_border`, `replicate_border`, `reflect_border` or `wrap_border`
+*/
+template <typename MT, typename Policy>
+class padded_matrix_view
+    : public blaze::DenseMatrix<padded_matrix_view<MT, Policy>, blaze::rowMajor>
+{
+  public:
+    using This = padded_matrix_view;
+    using BaseType = blaze::DenseMatrix<This, blaze::rowMajor>;
+    using ElementType = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    using ResultType = blaze::DynamicMatrix<ElementType, blaze::rowMajor>;
+    using OppositeType = blaze::DynamicMatrix<ElementType, blaze::columnMajor>;
+    using TransposeType = blaze::DynamicMatrix<ElementType, blaze::columnMajor>;
+    using ReturnType = ElementType;
+    using CompositeType = const This&;
+
+    static constexpr bool simdEnabled = false;
+    static constexpr bool smpAssignable = false;
+
+    padded_matrix_view(const MT& source, std::size_t padding, Policy policy)
+        : matrix(source), padding(padding), policy(policy)
+    {
+        if (matrix.rows() == 0 || matrix.columns() == 0) {
+            throw std::invalid_argument("cannot pad an empty matrix");
+        }
+    }
+
+    std::size_t rows() const noexcept { return matrix.rows() + 2 * padding; }
+    std::size_t columns() const noexcept { return matrix.columns() + 2 * padding; }
+
+    /// element in padded coordinates, the source starts at (padding, padding)
+    ReturnType operator()(std::size_t i, std::size_t j) const
+    {
+        const auto offset = static_cast<std::ptrdiff_t>(padding);
+        return get(static_cast<std::ptrdiff_t>(i) - offset,
+                   static_cast<std::ptrdiff_t>(j) - offset);
+    }
+
+    ReturnType at(std::size_t i, std::size_t j) const
+    {
+        if (i >= rows() || j >= columns()) {
+            throw std::out_of_range("Invalid padded matrix access index");
+        }
+        return (*this)(i, j);
+    }
+
+    /// element in source coordinates, any coordinates are valid, not only those of the padding
+    ReturnType get(std::ptrdiff_t i, std::ptrdiff_t j) const
+    {
+        if (i >= 0 && j >= 0 && i < static_cast<std::ptrdiff_t>(matrix.rows()) &&
+            j < static_cast<std::ptrdiff_t>(matrix.columns())) {
+            return matrix(i, j);
+        }
+        return detail::border_value(policy, matrix, i, j);
+    }
+
+    const MT& source() const noexcept { return matrix; }
+
+    template <typename Other>
+    bool canAlias(const Other* alias) const noexcept
+    {
+        return matrix.canAlias(alias);
+    }
+
+    template <typename Other>
+    bool isAliased(const Other* alias) const noexcept
+    {
+        return matrix.isAliased(alias);
+    }
+
+    bool isAligned() const noexcept { return false; }
+    bool canSMPAssign() const noexcept { return false; }
+
+  private:
+    // expressions are held by value, like Blaze views do
+    std::conditional_t<blaze::IsExpression_v<MT>, const MT, const MT&> matrix;
+    std::size_t padding;
+    Policy policy;
+};
+
+/** \brief Lazily padded `source`, see `padded_matrix_view`
+
+    \arg source The matrix to pad, must not be empty
+    \arg padding The number of elements added on each side
+    \arg policy How the values outside of `source` are generated
+*/
+template <typename MT, bool SO, typename Policy>
+padded_matrix_view<MT, Policy> padded_view(const blaze::DenseMatrix<MT, SO>& source,
+                                           std::size_t padding, Policy policy)
+{
+    return padded_matrix_view<MT, Policy>(~source, padding, policy);
+}
+
+/** \brief Splits a `rows` by `columns` iteration for a filter reaching `radius` elements around
+    each element
+
+    `interior(i, first, last)` is called for row spans [first, last) whose neighbourhoods are
+    inside the matrix, so the filter can read the source unchecked and the compiler can
+    vectorize the span. `edge(i, j)` is called for every other element, that needs border
+    handling, e.g. through `padded_matrix_view::get`. Rows are visited in order.
+*/
+template <typename Interior, typename Edge>
+void for_each_border_region(std::size_t rows, std::size_t columns, std::size_t radius,
+                            Interior interior, Edge edge)
+{
+    const bool has_interior = rows > 2 * radius && columns > 2 * radius;
+    for (std::size_t i = 0; i < rows; ++i) {
+        if (!has_interior || i < radius || i >= rows - radius) {
+            for (std::size_t j = 0; j < columns; ++j) {
+                edge(i, j);
+            }
+            continue;
+        }
+        for (std::size_t j = 0; j < radius; ++j) {
+            edge(i, j);
+        }
+        interior(i, radius, columns - radius);
+        for (std::size_t j = columns - radius; j < columns; ++j) {
+            edge(i, j);
+        }
+    }
+}
+} // namespace flash
+
+#endif
@@ -0,0 +1,407 @@
+#ifndef BLAZING_GIL_COLOR_HPP
+#define BLAZING_GIL_COLOR_HPP
+
+#include <blaze/Blaze.h>
+#include <blaze/math/typetraits/IsMatrix.h>
+
+#include <flash/conversion.hpp>
+#include <flash/core.hpp>
+#include <flash/planar.hpp>
+
+#include <boost/gil/color_base_algorithm.hpp>
+#include <boost/gil/rgb.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace flash
+{
+namespace detail
+{
+/* Conversions read red, green and blue of every pixel straight from the source view or
+   channeled matrix and write the destination matrix in the same pass, there is no intermediate
+   image. Channels of up to 16 bits are converted in Q14 fixed point with 32 bit integers, so
+   the row loops vectorize into integer multiply-add instructions (e.g. pmaddwd on x86), wider
+   and floating point channels are converted in floating point.
+*/
+
+constexpr int color_shift = 14;
+constexpr std::int32_t color_one = 1 << color_shift;
+
+struct color_weights {
+    double red;
+    double green;
+    double blue;
+};
+
+// JPEG (full range BT.601) luma and color differences
+constexpr color_weights luma_weights{0.299, 0.587, 0.114};
+constexpr color_weights blue_difference_weights{-0.168736, -0.331264, 0.5};
+constexpr color_weights red_difference_weights{0.5, -0.418688, -0.081312};
+
+constexpr std::int32_t to_fixed(double value)
+{
+    return static_cast<std::int32_t>(value * color_one + (value < 0 ? -0.5 : 0.5));
+}
+
+template <typename Channel>
+constexpr bool fixed_point_color_v = std::is_integral_v<Channel> && sizeof(Channel) <= 2;
+
+/// the value of a neutral color difference, half of the channel range
+template <typename Channel>
+constexpr double chroma_offset()
+{
+    if constexpr (std::is_integral_v<Channel>) {
+        return (static_cast<double>(std::numeric_limits<Channel>::max()) + 1) / 2;
+    } else {
+        return 0.5;
+    }
+}
+
+/// largest channel value, 1 for floating point channels as in GIL
+template <typename Channel>
+constexpr double channel_range()
+{
+    if constexpr (std::is_integral_v<Channel>) {
+        return static_cast<double>(std::numeric_limits<Channel>::max());
+    } else {
+        return 1.0;
+    }
+}
+
+/// `red * weights.red + green * weights.green + blue * weights.blue + offset`, rounded
+/// to nearest for fixed point channels
+template <typename Channel>
+auto weighted_sum(const color_weights& weights, Channel red, Channel green, Channel blue,
+                  double offset = 0)
+{
+    if constexpr (fixed_point_color_v<Channel>) {
+        // the offset keeps the sum non negative for every valid input, so the shift is a floor
+        return (static_cast<std::int32_t>(red) * to_fixed(weights.red) +
+                static_cast<std::int32_t>(green) * to_fixed(weights.green) +
+                static_cast<std::int32_t>(blue) * to_fixed(weights.blue) + to_fixed(offset) +
+                color_one / 2) >>
+               color_shift;
+    } else {
+        using compute_type = std::conditional_t<std::is_same_v<Channel, float>, float, double>;
+        return static_cast<compute_type>(red) * static_cast<compute_type>(weights.red) +
+               static_cast<compute_type>(green) * static_cast<compute_type>(weights.green) +
+               static_cast<compute_type>(blue) * static_cast<compute_type>(weights.blue) +
+               static_cast<compute_type>(offset);
+    }
+}
+
+template <typename View>
+using view_pixel_channel_t = true_channel_type_t<typename boost::gil::channel_type<View>::type>;
+
+/** \brief Calls `function(i, j, red, green, blue)` for every pixel of `source`
+
+    \arg source An RGB(A) view in any channel order and layout, or a matrix of `StaticVector`s
+    holding red, green and blue in this order
+*/
+template <typename Source, typename Function>
+void for_each_rgb(const Source& source, Function function)
+{
+    namespace gil = boost::gil;
+    if constexpr (blaze::IsMatrix_v<Source>) {
+        static_assert(blaze::ElementType_t<Source>::size() >= 3,
+                      "the matrix elements must have at least red, green and blue channels");
+        for (std::size_t i = 0; i < source.rows(); ++i) {
+            for (std::size_t j = 0; j < source.columns(); ++j) {
+                const auto& vector = source(i, j);
+                function(i, j, vector[0], vector[1], vector[2]);
+            }
+        }
+    } else {
+        using pixel_t = typename Source::value_type;
+        static_assert(gil::contains_color<pixel_t, gil::red_t>::value &&
+                          gil::contains_color<pixel_t, gil::green_t>::value &&
+                          gil::contains_color<pixel_t, gil::blue_t>::value,
+                      "the view must have red, green and blue channels");
+        using channel_t = view_pixel_channel_t<Source>;
+        for (signed_size i = 0; i < source.height(); ++i) {
+            const auto row = source.row_begin(i);
+            for (signed_size j = 0; j < source.width(); ++j) {
+                const auto& pixel = row[j];
+                function(static_cast<std::size_t>(i),
+                         static_cast<std::size_t>(j),
+                         static_cast<channel_t>(gil::get_color(pixel, gil::red_t())),
+                         static_cast<channel_t>(gil::get_color(pixel, gil::green_t())),
+                         static_cast<channel_t>(gil::get_color(pixel, gil::blue_t())));
+            }
+        }
+    }
+}
+
+template <typename Source, bool IsMatrix = blaze::IsMatrix_v<Source>>
+struct rgb_channel {
+    using type = view_pixel_channel_t<Source>;
+};
+
+template <typename Source>
+struct rgb_channel<Source, true> {
+    using type = blaze::ElementType_t<blaze::ElementType_t<Source>>;
+};
+
+template <typename Source>
+using rgb_channel_t = typename rgb_channel<Source>::type;
+
+/// rows and columns of a view or a matrix
+template <typename Source>
+std::pair<std::size_t, std::size_t> rgb_dimensions(const Source& source)
+{
+    if constexpr (blaze::IsMatrix_v<Source>) {
+        return {source.rows(), source.columns()};
+    } else {
+        return {static_cast<std::size_t>(source.height()),
+                static_cast<std::size_t>(source.width())};
+    }
+}
+
+template <typename Source, typename MT, bool SO>
+void rgb_to_gray(const Source& source, blaze::DenseMatrix<MT, SO>& result)
+{
+    using channel_t = rgb_channel_t<Source>;
+    using element_t = blaze::ElementType_t<MT>;
+    const auto [rows, columns] = rgb_dimensions(source);
+    if ((~result).rows() != rows || (~result).columns() != columns) {
+        throw std::invalid_argument("the result must have the dimensions of the source");
+    }
+    for_each_rgb(source, [&result](std::size_t i, std::size_t j, auto red, auto green, auto blue) {
+        (~result)(i, j) = convert_channel<element_t>(
+            weighted_sum<channel_t>(luma_weights, red, green, blue), saturate_round_conversion{});
+    });
+}
+
+template <typename U, typename Source>
+planar_matrix<U, 3> rgb_to_ycbcr(const Source& source)
+{
+    using channel_t = rgb_channel_t<Source>;
+    constexpr auto offset = chroma_offset<channel_t>();
+    const auto [rows, columns] = rgb_dimensions(source);
+    planar_matrix<U, 3> result(rows, columns);
+    auto& luma = result.plane(0);
+    auto& blue_difference = result.plane(1);
+    auto& red_difference = result.plane(2);
+    for_each_rgb(source, [&](std::size_t i, std::size_t j, auto red, auto green, auto blue) {
+        const saturate_round_conversion policy{};
+        luma(i, j) =
+            convert_channel<U>(weighted_sum<channel_t>(luma_weights, red, green, blue), policy);
+        blue_difference(i, j) = convert_channel<U>(
+            weighted_sum<channel_t>(blue_difference_weights, red, green, blue, offset), policy);
+        red_difference(i, j) = convert_channel<U>(
+            weighted_sum<channel_t>(red_difference_weights, red, green, blue, offset), policy);
+    });
+    return result;
+}
+
+/// sRGB transfer function, 256 entry table for 8 bit channels
+template <typename Channel>
+double srgb_to_linear(Channel value)
+{
+    auto linearize = [](double normalized) {
+        return normalized <= 0.04045 ? normalized / 12.92
+                                     : std::pow((normalized + 0.055) / 1.055, 2.4);
+    };
+    if constexpr (std::is_integral_v<Channel> && sizeof(Channel) == 1) {
+        static const auto table = [&linearize]() {
+            std::array<double, 256> result{};
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                const double normalized = static_cast<double>(i) / channel_range<Channel>();
+                result[i] = linearize(normalized);
+            }
+            return result;
+        }();
+        return table[static_cast<std::uint8_t>(value)];
+    } else {
+        return linearize(static_cast<double>(value) / channel_range<Channel>());
+    }
+}
+
+inline double linear_to_srgb(double value)
+{
+    return value <= 0.0031308 ? 12.92 * value : 1.055 * std::pow(value, 1 / 2.4) - 0.055;
+}
+
+// CIE Lab with D65 white point
+constexpr double lab_epsilon = 6.0 / 29.0;
+constexpr double white_x = 0.95047;
+constexpr double white_z = 1.08883;
+
+inline double lab_forward(double t)
+{
+    return t > lab_epsilon * lab_epsilon * lab_epsilon
+               ? std::cbrt(t)
+               : t / (3 * lab_epsilon * lab_epsilon) + 4.0 / 29.0;
+}
+
+inline double lab_inverse(double f)
+{
+    return f > lab_epsilon ? f * f * f : 3 * lab_epsilon * lab_epsilon * (f - 4.0 / 29.0);
+}
+} // namespace detail
+
+/** \brief Converts an RGB source to luma in a single pass, writing into `result`
+
+    Luma is computed with JPEG (BT.601) weights, `0.299 R + 0.587 G + 0.114 B`, in Q14 fixed point
+    for channels of up to 16 bits. The value is in the scale of the source channels and is
+    saturated into the element type of `result`, e.g. `int16` for Sobel input.
+
+    \arg source An RGB or RGBA view in any channel order, or a matrix of `StaticVector`s holding
+    red, green and blue in this order
+    \arg result A matrix with the dimensions of `source`
+*/
+template <typename Source, typename MT, bool SO>
+void rgb_to_gray(const Source& source, blaze::DenseMatrix<MT, SO>& result)
+{
+    detail::rgb_to_gray(source, result);
+}
+
+/** \brief Converts an RGB source to a luma matrix of `U`, replaces `copy_and_convert_pixels` to a
+    gray image followed by `to_matrix`
+
+    \tparam U The element type of the result
+*/
+template <typename U, typename Source>
+blaze::DynamicMatrix<U> rgb_to_gray(const Source& source)
+{
+    const auto [rows, columns] = detail::rgb_dimensions(source);
+    blaze::DynamicMatrix<U> result(rows, columns);
+    detail::rgb_to_gray(source, result);
+    return result;
+}
+
+/** \brief Converts an RGB source to full range YCbCr, as used by JPEG
+
+    Color differences are offset by half of the source channel range, e.g. 128 for 8 bit
+    channels.
+
+    \tparam U The element type of the planes
+    \arg source An RGB or RGBA view, or a matrix of `StaticVector`s holding red, green and blue
+
+    \return `planar_matrix<U, 3>` with Y, Cb and Cr planes
+*/
+template <typename U, typename Source>
+planar_matrix<U, 3> rgb_to_ycbcr(const Source& source)
+{
+    return detail::rgb_to_ycbcr<U>(source);
+}
+
+/** \brief Converts full range YCbCr planes back to RGB, writing into `view`
+
+    Values are expected in the scale of the view's channels, as produced by `rgb_to_ycbcr` of a
+    view of the same type. Results are rounded and saturated into the channel range.
+*/
+template <typename T, typename View>
+void ycbcr_to_rgb(const planar_matrix<T, 3>& source, View view)
+{
+    namespace gil = boost::gil;
+    using channel_t = detail::view_pixel_channel_t<View>;
+    if (source.rows() != static_cast<std::size_t>(view.height()) ||
+        source.columns() != static_cast<std::size_t>(view.width())) {
+        throw std::invalid_argument("the view must have the dimensions of the matrix");
+    }
+    constexpr auto offset = detail::chroma_offset<channel_t>();
+    const saturate_round_conversion policy{};
+    const auto& luma = source.plane(0);
+    const auto& blue_difference = source.plane(1);
+    const auto& red_difference = source.plane(2);
+    for (signed_size i = 0; i < view.height(); ++i) {
+        const auto row = view.row_begin(i);
+        const auto ui = static_cast<std::size_t>(i);
+        for (signed_size j = 0; j < view.width(); ++j) {
+            const auto uj = static_cast<std::size_t>(j);
+            const double y = static_cast<double>(luma(ui, uj));
+            const double cb = static_cast<double>(blue_difference(ui, uj)) - offset;
+            const double cr = static_cast<double>(red_difference(ui, uj)) - offset;
+            auto&& pixel = row[j];
+            gil::get_color(pixel, gil::red_t()) =
+                convert_channel<channel_t>(y + 1.402 * cr, policy);
+            gil::get_color(pixel, gil::green_t()) =
+                convert_channel<channel_t>(y - 0.344136 * cb - 0.714136 * cr, policy);
+            gil::get_color(pixel, gil::blue_t()) =
+                convert_channel<channel_t>(y + 1.772 * cb, policy);
+        }
+    }
+}
+
+/** \brief Converts an sRGB source to CIE Lab (D65 white point)
+
+    The sRGB transfer function is a 256 entry table for 8 bit channels. L is in [0, 100], a and
+    b are roughly in [-128, 127].
+
+    \tparam U The element type of the planes, floating point unless truncation is acceptable
+    \return `planar_matrix<U, 3>` with L, a and b planes
+*/
+template <typename U = float, typename Source>
+planar_matrix<U, 3> rgb_to_lab(const Source& source)
+{
+    const auto [rows, columns] = detail::rgb_dimensions(source);
+    planar_matrix<U, 3> result(rows, columns);
+    auto& lightness = result.plane(0);
+    auto& a_plane = result.plane(1);
+    auto& b_plane = result.plane(2);
+    detail::for_each_rgb(source, [&](std::size_t i, std::size_t j, auto red, auto green,
+                                     auto blue) {
+        const double r = detail::srgb_to_linear(red);
+        const double g = detail::srgb_to_linear(green);
+        const double b = detail::srgb_to_linear(blue);
+        const double fx = detail::lab_forward(
+            (0.4124564 * r + 0.3575761 * g + 0.1804375 * b) / detail::white_x);
+        const double fy = detail::lab_forward(0.2126729 * r + 0.7151522 * g + 0.0721750 * b);
+        const double fz = detail::lab_forward(
+            (0.0193339 * r + 0.1191920 * g + 0.9503041 * b) / detail::white_z);
+        const saturate_round_conversion policy{};
+        lightness(i, j) = convert_channel<U>(116 * fy - 16, policy);
+        a_plane(i, j) = convert_channel<U>(500 * (fx - fy), policy);
+        b_plane(i, j) = convert_channel<U>(200 * (fy - fz), policy);
+    });
+    return result;
+}
+
+/// Converts CIE Lab planes (D65 white point) back to sRGB, writing into `view`
+template <typename T, typename View>
+void lab_to_rgb(const planar_matrix<T, 3>& source, View view)
+{
+    namespace gil = boost::gil;
+    using channel_t = detail::view_pixel_channel_t<View>;
+    if (source.rows() != static_cast<std::size_t>(view.height()) ||
+        source.columns() != static_cast<std::size_t>(view.width())) {
+        throw std::invalid_argument("the view must have the dimensions of the matrix");
+    }
+    constexpr auto range = detail::channel_range<channel_t>();
+    const saturate_round_conversion policy{};
+    auto encode = [range, policy](double linear) {
+        const double clamped = std::clamp(linear, 0.0, 1.0);
+        return convert_channel<channel_t>(detail::linear_to_srgb(clamped) * range, policy);
+    };
+    for (signed_size i = 0; i < view.height(); ++i) {
+        const auto row = view.row_begin(i);
+        const auto ui = static_cast<std::size_t>(i);
+        for (signed_size j = 0; j < view.width(); ++j) {
+            const auto uj = static_cast<std::size_t>(j);
+            const double fy = (static_cast<double>(source.plane(0)(ui, uj)) + 16) / 116;
+            const double fx = fy + static_cast<double>(source.plane(1)(ui, uj)) / 500;
+            const double fz = fy - static_cast<double>(source.plane(2)(ui, uj)) / 200;
+            const double x = detail::white_x * detail::lab_inverse(fx);
+            const double y = detail::lab_inverse(fy);
+            const double z = detail::white_z * detail::lab_inverse(fz);
+            auto&& pixel = row[j];
+            gil::get_color(pixel, gil::red_t()) =
+                encode(3.2404542 * x - 1.5371385 * y - 0.4985314 * z);
+            gil::get_color(pixel, gil::green_t()) =
+                encode(-0.9692660 * x + 1.8760108 * y + 0.0415560 * z);
+            gil::get_color(pixel, gil::blue_t()) =
+                encode(0.0556434 * x - 0.2040259 * y + 1.0572252 * z);
+        }
+    }
+}
+} // namespace flash
+
+#endif
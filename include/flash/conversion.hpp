@@ -0,0 +1,143 @@
+#ifndef BLAZING_GIL_CONVERSION_HPP
+#define BLAZING_GIL_CONVERSION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace flash
+{
+/// `static_cast`, fractions are truncated and out of range values wrap, the default
+struct truncate_conversion {
+};
+
+/// floating point values are rounded to nearest (halves away from zero) for integral targets
+struct round_conversion {
+};
+
+/// values are clamped into the range of the target type
+struct saturate_conversion {
+};
+
+/// values are rounded to nearest and then clamped, e.g. what writing a `double` result into an
+/// 8 bit image needs
+struct saturate_round_conversion {
+};
+
+/// true for the conversion policies above, keeps policies apart from views in overloads
+template <typename Policy>
+constexpr bool is_conversion_policy_v =
+    std::is_same_v<Policy, truncate_conversion> || std::is_same_v<Policy, round_conversion> ||
+    std::is_same_v<Policy, saturate_conversion> ||
+    std::is_same_v<Policy, saturate_round_conversion>;
+
+namespace detail
+{
+/* All conversions below are branch free (besides the compile time ones) min/max/trunc sequences,
+   so row loops calling them vectorize into SIMD convert, round and pack instructions, e.g.
+   cvttpd2dq, roundpd and packuswb on x86, instead of needing a separate clamping pass.
+*/
+
+template <typename Target, typename Source>
+constexpr bool rounds_v = std::is_integral_v<Target> && std::is_floating_point_v<Source>;
+
+/* Adding a half before flooring is not exact, e.g. 0.49999997f + 0.5f rounds to 1.0f. The
+   fraction left by truncation is always representable, so it is compared instead.
+*/
+template <typename Source>
+Source round_half_away(Source value)
+{
+    const Source whole = std::trunc(value);
+    const Source fraction = value - whole;
+    return whole + (fraction >= Source(0.5) ? Source(1) : Source(0)) -
+           (fraction <= Source(-0.5) ? Source(1) : Source(0));
+}
+
+/// the largest `Source` not above the maximum of `Target`, which itself may round up in `Source`
+template <typename Target, typename Source>
+constexpr Source highest_exact()
+{
+    constexpr int lost_digits =
+        std::numeric_limits<Target>::digits - std::numeric_limits<Source>::digits;
+    if constexpr (lost_digits > 0) {
+        // e.g. 2^31 - 2^7 for std::int32_t and float, the float just below 2^31
+        constexpr auto step = std::make_unsigned_t<Target>(1) << lost_digits;
+        return static_cast<Source>(std::numeric_limits<Target>::max() - (step - 1));
+    } else {
+        return static_cast<Source>(std::numeric_limits<Target>::max());
+    }
+}
+
+template <typename Target, typename Source>
+Target saturate_value(Source value)
+{
+    static_assert(std::is_arithmetic_v<Target> && std::is_arithmetic_v<Source>,
+                  "only arithmetic values can be saturated");
+    constexpr auto low = std::numeric_limits<Target>::lowest();
+    constexpr auto high = std::numeric_limits<Target>::max();
+    if constexpr (std::is_floating_point_v<Target>) {
+        return static_cast<Target>(value);
+    } else if constexpr (std::is_floating_point_v<Source>) {
+        // NaN is not handled, like in static_cast it has no meaningful integral value
+        // casting a value at or above `Source(high)`, which may be `high + 1`, is undefined, the
+        // cast is done on a value clamped to the range Source represents exactly, and `high`
+        // is selected afterwards
+        const auto clamped =
+            std::min(std::max(value, static_cast<Source>(low)), highest_exact<Target, Source>());
+        const auto result = static_cast<Target>(clamped);
+        return value >= static_cast<Source>(high) ? high : result;
+    } else if constexpr (std::is_signed_v<Source> == std::is_signed_v<Target>) {
+        using wide = std::common_type_t<Source, Target>;
+        return static_cast<Target>(
+            std::clamp<wide>(value, static_cast<wide>(low), static_cast<wide>(high)));
+    } else if constexpr (std::is_signed_v<Source>) {
+        using wide = std::common_type_t<std::make_unsigned_t<Source>, Target>;
+        const auto positive = static_cast<wide>(std::max<Source>(value, 0));
+        return static_cast<Target>(std::min<wide>(positive, static_cast<wide>(high)));
+    } else {
+        using wide = std::common_type_t<Source, std::make_unsigned_t<Target>>;
+        return static_cast<Target>(std::min<wide>(value, static_cast<wide>(high)));
+    }
+}
+} // namespace detail
+
+/** \brief Converts a single channel value to `Target` according to the conversion policy
+
+    \tparam Target An arithmetic type, e.g. a channel type stripped by `true_channel_type_t`
+    \arg value An arithmetic value
+*/
+template <typename Target, typename Source>
+Target convert_channel(const Source& value, truncate_conversion)
+{
+    return static_cast<Target>(value);
+}
+
+template <typename Target, typename Source>
+Target convert_channel(const Source& value, round_conversion)
+{
+    if constexpr (detail::rounds_v<Target, Source>) {
+        return static_cast<Target>(detail::round_half_away(value));
+    } else {
+        return static_cast<Target>(value);
+    }
+}
+
+template <typename Target, typename Source>
+Target convert_channel(const Source& value, saturate_conversion)
+{
+    return detail::saturate_value<Target>(value);
+}
+
+template <typename Target, typename Source>
+Target convert_channel(const Source& value, saturate_round_conversion)
+{
+    if constexpr (detail::rounds_v<Target, Source>) {
+        return detail::saturate_value<Target>(detail::round_half_away(value));
+    } else {
+        return detail::saturate_value<Target>(value);
+    }
+}
+} // namespace flash
+
+#endif
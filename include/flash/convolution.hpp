@@ -3,7 +3,18 @@
 
 #include <blaze/Blaze.h>
 
+#include <flash/border.hpp>
 #include <flash/core.hpp>
+#include <flash/half.hpp>
+#include <flash/range.hpp>
+#include <flash/workspace.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace flash
 {
@@ -13,10 +24,12 @@ using kernel2d = blaze::DynamicMatrix<T>;
 template <typename T, std::size_t M, std::size_t N>
 using kernel2d_fixed = blaze::StaticMatrix<T, M, N>;
 
-static const kernel2d_fixed<std::int16_t, 3, 3> sobel_x{
-    {1, 0, -1}, {2, 0, -2}, {1, 0, -1}};
-static const kernel2d_fixed<std::int16_t, 3, 3> sobel_y{
-    {1, 2, 1}, {0, 0, 0}, {-1, -2, -1}};
+/// coefficients of `sobel_x` and `sobel_y`, usable in constant expressions like `convolved_range`
+constexpr std::int16_t sobel_x_coefficients[3][3] = {{1, 0, -1}, {2, 0, -2}, {1, 0, -1}};
+constexpr std::int16_t sobel_y_coefficients[3][3] = {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}};
+
+static const kernel2d_fixed<std::int16_t, 3, 3> sobel_x{sobel_x_coefficients};
+static const kernel2d_fixed<std::int16_t, 3, 3> sobel_y{sobel_y_coefficients};
 
 template <typename T = float>
 kernel2d<T> gaussian_kernel(std::size_t size, double sigma)
@@ -35,46 +48,118 @@ kernel2d<T> gaussian_kernel(std::size_t size, double sigma)
         });
 }
 
+/** \brief Creates normalized 1D Gaussian kernel
+
+    The kernel covers 3 sigma on each side of the center, thus it has `2 * ceil(3 * sigma) + 1`
+    elements. As Gaussian is separable, blurring rows and then columns with it is equivalent to
+    convolving with `gaussian_kernel` of the same sigma, at a fraction of the cost.
+*/
+template <typename T = float>
+blaze::DynamicVector<T> gaussian_kernel_1d(double sigma)
+{
+    const auto radius = static_cast<std::size_t>(std::ceil(3 * sigma));
+    blaze::DynamicVector<T> kernel(2 * radius + 1);
+    double total = 0;
+    for (std::size_t i = 0; i < kernel.size(); ++i) {
+        const double x = static_cast<double>(i) - static_cast<double>(radius);
+        const double weight = std::exp(-(x * x) / (2 * sigma * sigma));
+        kernel[i] = static_cast<T>(weight);
+        total += weight;
+    }
+    kernel /= static_cast<T>(total);
+
+    return kernel;
+}
+
+/** \brief Blurs `source` with Gaussian of given sigma as two 1D passes
+
+    Borders are handled by replicating the edge pixels. A non positive sigma returns a copy of
+    `source` converted to `T`.
+
+    \tparam T The element type of the result and of the intermediate buffer
+*/
+template <typename T = float, typename MT, bool SO>
+blaze::DynamicMatrix<T> gaussian_blur(const blaze::DenseMatrix<MT, SO>& source, double sigma)
+{
+    const auto m = (~source).rows();
+    const auto n = (~source).columns();
+    if (sigma <= 0 || m == 0 || n == 0) {
+        return blaze::DynamicMatrix<T>(~source);
+    }
+
+    const auto kernel = gaussian_kernel_1d<T>(sigma);
+    const auto radius = static_cast<signed_size>(kernel.size() / 2);
+    auto clamp_index = [](signed_size index, std::size_t size) {
+        return static_cast<std::size_t>(
+            detail::border_index(replicate_border{}, index, static_cast<signed_size>(size)));
+    };
+
+    blaze::DynamicMatrix<T> horizontal(m, n);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const auto first = static_cast<signed_size>(j) - radius;
+            T sum{};
+            for (std::size_t k = 0; k < kernel.size(); ++k) {
+                const auto column = clamp_index(first + static_cast<signed_size>(k), n);
+                sum += kernel[k] * static_cast<T>((~source)(i, column));
+            }
+            horizontal(i, j) = sum;
+        }
+    }
+
+    // whole rows at once, so that Blaze can vectorize the vertical pass
+    blaze::DynamicMatrix<T> result(m, n);
+    for (std::size_t i = 0; i < m; ++i) {
+        const auto first = static_cast<signed_size>(i) - radius;
+        auto target = blaze::row(result, i);
+        target = kernel[0] * blaze::row(horizontal, clamp_index(first, m));
+        for (std::size_t k = 1; k < kernel.size(); ++k) {
+            const auto source_row = clamp_index(first + static_cast<signed_size>(k), m);
+            target += kernel[k] * blaze::row(horizontal, source_row);
+        }
+    }
+
+    return result;
+}
+
 template <typename T = float>
 kernel2d<T> mean_kernel(std::size_t size)
 {
     return kernel2d<T>(size, size, 1.0 / (size * size));
 }
 
-template <typename Kernel>
-Kernel flip_kernel(const Kernel& source)
+namespace detail
+{
+/// writes the flipped `source` into `result`, which must have the same dimensions
+template <typename Kernel, typename Result>
+void flip_kernel_into(const Kernel& source, Result& result)
 {
     auto m = source.rows();
     auto n = source.columns();
-    // temporary fix for diverging constructors
-    // for different matrix types
-    // should be fast enough, as kernels are
-    // usually small
-    Kernel result(source);
     for (std::size_t i = 0; i < m; ++i) {
         for (std::size_t j = 0; j < n; ++j) {
             result(j, i) = source(m - i - 1, n - j - 1);
         }
     }
-
-    return result;
 }
 
-template <typename MT, bool SO, typename Kernel>
-auto convolve(const blaze::DenseMatrix<MT, SO>& source,
-              const Kernel& original_kernel)
-{
-    using T = remove_cvref_t<decltype(std::declval<MT>()(0, 0))>;
+/** \brief `result` must be zeroed and have the dimensions of `source`, borders are left untouched
 
-    auto kernel = flip_kernel(original_kernel);
+    Source elements are converted to the compute type of the element type of `result` (see
+    `compute_type_t`) before being multiplied, so that a wider result also widens the
+    accumulation, and `float16` or `bfloat16` results are accumulated in `float`.
+*/
+template <typename MT, bool SO, typename Kernel, typename Result>
+void convolve_into(const blaze::DenseMatrix<MT, SO>& source, const Kernel& kernel, Result& result)
+{
+    using storage_type = blaze::ElementType_t<Result>;
+    using accumulator = compute_type_t<storage_type>;
     auto m = (~source).rows();
     auto n = (~source).columns();
-
-    blaze::DynamicMatrix<T> result(m, n, 0);
     auto kernel_size = kernel.rows();
 
     if (m < kernel_size || n < kernel_size) {
-        return result;
+        return;
     }
 
     for (std::size_t i = kernel_size; i < m; ++i) {
@@ -84,9 +169,158 @@ auto convolve(const blaze::DenseMatrix<MT, SO>& source,
                                             j - kernel_size,
                                             kernel_size,
                                             kernel_size);
-            result(i, j) = blaze::sum(current % kernel);
+            if constexpr (std::is_same_v<blaze::ElementType_t<MT>, accumulator>) {
+                result(i, j) = static_cast<storage_type>(blaze::sum(current % kernel));
+            } else {
+                auto widened =
+                    blaze::map(current, [](const auto& x) { return static_cast<accumulator>(x); });
+                result(i, j) = static_cast<storage_type>(
+                    static_cast<accumulator>(blaze::sum(widened % kernel)));
+            }
         }
     }
+}
+
+/** \brief Same as `convolve_into`, but the kernel is centered on every element of `result` and
+    neighbours outside of `source` are generated by `border`
+
+    The interior is read from `source` directly, only the frame of `radius` elements goes through
+    `padded_matrix_view::get`. `kernel` must be flipped, square and of odd size.
+*/
+template <typename MT, bool SO, typename Kernel, typename Policy, typename Result>
+void convolve_into(const blaze::DenseMatrix<MT, SO>& source, const Kernel& kernel,
+                   const Policy& border, Result& result)
+{
+    using storage_type = blaze::ElementType_t<Result>;
+    using accumulator = compute_type_t<storage_type>;
+    // the type `blaze::sum` of the interior accumulates in
+    using product_type =
+        decltype(std::declval<accumulator>() * std::declval<blaze::ElementType_t<Kernel>>());
+    if ((~source).rows() == 0 || (~source).columns() == 0) {
+        return;
+    }
+    const auto kernel_size = kernel.rows();
+    const auto radius = kernel_size / 2;
+    const auto padded = padded_view(~source, radius, border);
+
+    for_each_border_region(
+        (~source).rows(),
+        (~source).columns(),
+        radius,
+        [&](std::size_t i, std::size_t first, std::size_t last) {
+            for (std::size_t j = first; j < last; ++j) {
+                auto current = blaze::submatrix(
+                    ~source, i - radius, j - radius, kernel_size, kernel_size);
+                if constexpr (std::is_same_v<blaze::ElementType_t<MT>, accumulator>) {
+                    result(i, j) = static_cast<storage_type>(blaze::sum(current % kernel));
+                } else {
+                    auto widened = blaze::map(
+                        current, [](const auto& x) { return static_cast<accumulator>(x); });
+                    result(i, j) = static_cast<storage_type>(
+                        static_cast<accumulator>(blaze::sum(widened % kernel)));
+                }
+            }
+        },
+        [&](std::size_t i, std::size_t j) {
+            const auto top = static_cast<signed_size>(i) - static_cast<signed_size>(radius);
+            const auto left = static_cast<signed_size>(j) - static_cast<signed_size>(radius);
+            product_type sum{};
+            for (std::size_t k = 0; k < kernel_size; ++k) {
+                for (std::size_t l = 0; l < kernel_size; ++l) {
+                    const auto value = padded.get(top + static_cast<signed_size>(k),
+                                                  left + static_cast<signed_size>(l));
+                    sum += static_cast<accumulator>(value) * kernel(k, l);
+                }
+            }
+            result(i, j) = static_cast<storage_type>(static_cast<accumulator>(sum));
+        });
+}
+} // namespace detail
+
+template <typename Kernel>
+Kernel flip_kernel(const Kernel& source)
+{
+    // temporary fix for diverging constructors
+    // for different matrix types
+    // should be fast enough, as kernels are
+    // usually small
+    Kernel result(source);
+    detail::flip_kernel_into(source, result);
+
+    return result;
+}
+
+/** \brief Convolves `source` with `original_kernel`
+
+    Elements whose neighbourhood reaches outside of `source` are left zero, use the overload
+    taking a border policy to compute them too.
+
+    \tparam Result The element type of the result and of the accumulation, the element type of
+    `source` by default. Integral sources overflow when it is too narrow for the kernel, e.g.
+    `std::uint8_t` images convolved with `sobel_x`, use `convolved_range` to select one.
+    `float16` and `bfloat16` halve the size of the result, the accumulation is then in `float`.
+*/
+template <typename Result = void, typename MT, bool SO, typename Kernel>
+auto convolve(const blaze::DenseMatrix<MT, SO>& source,
+              const Kernel& original_kernel)
+{
+    using T = std::conditional_t<std::is_void_v<Result>,
+                                 remove_cvref_t<decltype(std::declval<MT>()(0, 0))>,
+                                 Result>;
+
+    auto kernel = flip_kernel(original_kernel);
+    blaze::DynamicMatrix<T> result((~source).rows(), (~source).columns(), 0);
+    detail::convolve_into(source, kernel, result);
+
+    return result;
+}
+
+/** \brief Convolves `source` with `original_kernel` centered on every element, neighbours
+    outside of `source` are generated by `border`
+
+    \tparam Result Same as for `convolve` without a border policy
+    \arg original_kernel A square kernel of odd size
+    \arg border One of `constant_border`, `replicate_border`, `reflect_border` or `wrap_border`
+
+    \return A `DynamicMatrix` of the dimensions of `source`
+*/
+template <typename Result = void, typename MT, bool SO, typename Kernel, typename Policy,
+          typename = std::enable_if_t<is_border_policy_v<Policy>>>
+auto convolve(const blaze::DenseMatrix<MT, SO>& source, const Kernel& original_kernel,
+              Policy border)
+{
+    using T = std::conditional_t<std::is_void_v<Result>,
+                                 remove_cvref_t<decltype(std::declval<MT>()(0, 0))>,
+                                 Result>;
+    if (original_kernel.rows() != original_kernel.columns() || original_kernel.rows() % 2 == 0) {
+        throw std::invalid_argument("kernel must be square and of odd size");
+    }
+
+    auto kernel = flip_kernel(original_kernel);
+    blaze::DynamicMatrix<T> result((~source).rows(), (~source).columns());
+    detail::convolve_into(source, kernel, border, result);
+
+    return result;
+}
+
+/** \brief Same as `convolve`, but the result and the flipped kernel are taken from `arena`
+
+    \return A `workspace::matrix_type<T>`, valid until `arena` is reset
+*/
+template <typename Result = void, typename MT, bool SO, typename Kernel>
+auto convolve(const blaze::DenseMatrix<MT, SO>& source, const Kernel& original_kernel,
+              workspace& arena)
+{
+    using T = std::conditional_t<std::is_void_v<Result>,
+                                 remove_cvref_t<decltype(std::declval<MT>()(0, 0))>,
+                                 Result>;
+    using kernel_element_type = blaze::ElementType_t<Kernel>;
+
+    auto kernel =
+        arena.matrix<kernel_element_type>(original_kernel.rows(), original_kernel.columns());
+    detail::flip_kernel_into(original_kernel, kernel);
+    auto result = arena.matrix<T>((~source).rows(), (~source).columns());
+    detail::convolve_into(source, kernel, result);
 
     return result;
 }
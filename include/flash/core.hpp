@@ -2,20 +2,29 @@
 #define BLAZING_GIL_CORE_HPP
 
 #include <algorithm>
+#include <array>
 #include <blaze/Blaze.h>
 #include <blaze/math/AlignmentFlag.h>
 #include <blaze/math/PaddingFlag.h>
 #include <blaze/math/StorageOrder.h>
 #include <blaze/math/dense/StaticVector.h>
 #include <blaze/math/expressions/Forward.h>
+#include <blaze/math/typetraits/IsContiguous.h>
 #include <blaze/math/typetraits/IsDenseVector.h>
 #include <blaze/math/typetraits/IsStatic.h>
 #include <blaze/math/typetraits/UnderlyingElement.h>
 #include <boost/gil/algorithm.hpp>
 #include <boost/gil/image.hpp>
 #include <boost/gil/image_view.hpp>
+#include <boost/gil/metafunctions.hpp>
 #include <boost/gil/pixel.hpp>
 #include <boost/gil/typedefs.hpp>
+#include <cmath>
+#include <flash/border.hpp>
+#include <flash/conversion.hpp>
+#include <flash/reduction.hpp>
+#include <flash/transpose.hpp>
+#include <flash/workspace.hpp>
 #include <functional>
 #include <limits>
 #include <stdexcept>
@@ -92,17 +101,18 @@ struct true_channel_type<boost::gil::float64_t> {
 template <typename ChannelType>
 using true_channel_type_t = typename true_channel_type<ChannelType>::type;
 
+/** \brief Reduces every channel of a matrix of `StaticVector`s with `reducer`
+
+    Runs on the reduction engine of `flash/reduction.hpp`, in parallel and in a fixed order, so
+    `reducer` must be associative and commutative, as with `blaze::reduce`.
+
+    \arg reducer Binary function of two channel values
+*/
 template <typename MT, bool StorageOrder, typename Reducer>
 blaze::UnderlyingElement_t<MT> channelwise_reduce(const blaze::DenseMatrix<MT, StorageOrder>& input,
                                                   Reducer reducer)
 {
-    using result_type = blaze::UnderlyingElement_t<MT>;
-    return blaze::reduce(input, [reducer](result_type old, result_type current) {
-        for (std::size_t i = 0; i < current.size(); ++i) {
-            old[i] = reducer(old[i], current[i]);
-        }
-        return old;
-    });
+    return detail::reduce_matrix(input, detail::channelwise_operation<Reducer>{reducer});
 }
 
 template <typename MT, bool StorageOrder, typename Compare = std::less<>>
@@ -121,6 +131,101 @@ blaze::UnderlyingElement_t<MT> channelwise_max(const blaze::DenseMatrix<MT, Stor
         input, [compare](auto lhs, auto rhs) { return (compare(rhs, lhs)) ? lhs : rhs; });
 }
 
+namespace detail
+{
+/* The conversion kernels below walk rows through raw channel pointers instead of going through
+   GIL locators for every pixel. With the step known at compile time the loops are plain strided
+   loads and stores, which compilers turn into SIMD shuffles (e.g. vpshufb, vpermd on x86) for
+   the common 1, 2, 3 and 4 channel layouts.
+*/
+
+/// true for memory based views without x step, e.g. views of `gil::image`
+template <typename View>
+constexpr bool is_basic_view_v = boost::gil::view_is_basic<View>::value;
+
+/// distance between consecutive values of one channel in a row of a basic view
+template <typename View>
+constexpr std::size_t channel_step_v =
+    boost::gil::is_planar<View>::value ? 1 : boost::gil::num_channels<View>::value;
+
+template <typename Matrix, bool SO>
+constexpr bool is_row_contiguous_v = SO == blaze::rowMajor && blaze::IsContiguous_v<Matrix>;
+
+/// pointer to `channel` of the first pixel of the row, with GIL's scoped channel types stripped
+template <typename View>
+auto channel_pointer(const View& view, signed_size row, std::size_t channel)
+{
+    auto* pointer = &(*view.row_begin(row))[channel];
+    using channel_t = std::remove_pointer_t<decltype(pointer)>;
+    using true_t = true_channel_type_t<std::remove_const_t<channel_t>>;
+    using result_t = std::conditional_t<std::is_const_v<channel_t>, const true_t*, true_t*>;
+    return reinterpret_cast<result_t>(pointer);
+}
+
+template <std::size_t Step, typename Source, typename Target>
+void gather_row(const Source* source, std::size_t count, Target* target)
+{
+    for (std::size_t j = 0; j < count; ++j) {
+        target[j] = static_cast<Target>(source[j * Step]);
+    }
+}
+
+template <std::size_t Step, typename Source, typename Target,
+          typename Policy = truncate_conversion>
+void scatter_row(const Source* source, std::size_t count, Target* target, Policy policy = {})
+{
+    for (std::size_t j = 0; j < count; ++j) {
+        target[j * Step] = convert_channel<Target>(source[j], policy);
+    }
+}
+
+/// copies pixels of the row into vectors, `target` points to `StaticVector`s of `N` elements
+template <std::size_t N, typename View, typename Vector>
+void pixels_to_vectors(const View& view, signed_size row, Vector* target)
+{
+    using element_type = blaze::UnderlyingElement_t<Vector>;
+    const std::size_t width = view.width();
+    if constexpr (boost::gil::is_planar<View>::value) {
+        for (std::size_t channel = 0; channel < N; ++channel) {
+            const auto* source = channel_pointer(view, row, channel);
+            for (std::size_t j = 0; j < width; ++j) {
+                target[j][channel] = static_cast<element_type>(source[j]);
+            }
+        }
+    } else {
+        const auto* source = channel_pointer(view, row, 0);
+        for (std::size_t j = 0; j < width; ++j) {
+            for (std::size_t channel = 0; channel < N; ++channel) {
+                target[j][channel] = static_cast<element_type>(source[j * N + channel]);
+            }
+        }
+    }
+}
+
+/// copies vectors into pixels of the row, `source` points to `StaticVector`s of `N` elements
+template <std::size_t N, typename View, typename Vector, typename Policy = truncate_conversion>
+void vectors_to_pixels(const Vector* source, const View& view, signed_size row, Policy policy = {})
+{
+    using channel_t = std::remove_pointer_t<decltype(channel_pointer(view, row, 0))>;
+    const std::size_t width = view.width();
+    if constexpr (boost::gil::is_planar<View>::value) {
+        for (std::size_t channel = 0; channel < N; ++channel) {
+            auto* target = channel_pointer(view, row, channel);
+            for (std::size_t j = 0; j < width; ++j) {
+                target[j] = convert_channel<channel_t>(source[j][channel], policy);
+            }
+        }
+    } else {
+        auto* target = channel_pointer(view, row, 0);
+        for (std::size_t j = 0; j < width; ++j) {
+            for (std::size_t channel = 0; channel < N; ++channel) {
+                target[j * N + channel] = convert_channel<channel_t>(source[j][channel], policy);
+            }
+        }
+    }
+}
+} // namespace detail
+
 /** \brief Extract `channel`th value from each pixel in `view` and writes into `result`
 
    The function can be used with multi channel views, just the `channel` argument might need to be
@@ -141,11 +246,26 @@ void to_matrix(View view, blaze::DenseMatrix<MT, SO>& result, std::size_t channe
     if (channel >= num_channels) {
         throw std::invalid_argument("channel index exceeds available channels in the view");
     }
-    (~result) = blaze::generate(
-        view.height(), view.width(), [&view, channel](std::size_t i, std::size_t j) {
-            using element_type = blaze::UnderlyingElement_t<MT>;
-            return static_cast<element_type>(view(j, i)[channel]);
-        });
+    if constexpr (detail::is_basic_view_v<View> && detail::is_row_contiguous_v<MT, SO>) {
+        blaze::resize(~result, view.height(), view.width(), false);
+        for (signed_size i = 0; i < view.height(); ++i) {
+            detail::gather_row<detail::channel_step_v<View>>(
+                detail::channel_pointer(view, i, channel), view.width(), (~result).data(i));
+        }
+    } else if constexpr (detail::is_basic_view_v<View> && SO == blaze::columnMajor &&
+                         blaze::IsContiguous_v<MT>) {
+        // gathered into rows like above, which are then transposed blockwise into the columns
+        blaze::DynamicMatrix<blaze::ElementType_t<MT>> rows(view.height(), view.width());
+        to_matrix(view, rows, channel);
+        blaze::resize(~result, view.height(), view.width(), false);
+        detail::transpose_storage(rows, ~result);
+    } else {
+        (~result) = blaze::generate(
+            view.height(), view.width(), [&view, channel](std::size_t i, std::size_t j) {
+                using element_type = blaze::UnderlyingElement_t<MT>;
+                return static_cast<element_type>(view(j, i)[channel]);
+            });
+    }
 }
 
 /** \brief Converts an image view into `DynamicMatrix<ChannelType>`, where each entry corresponds to
@@ -212,10 +332,21 @@ auto pixel_to_vector(const PixelType& pixel)
 template <typename View>
 auto to_matrix_channeled(View view)
 {
-    return blaze::evaluate(
-        blaze::generate(view.height(), view.width(), [&view](std::size_t i, std::size_t j) {
-            return pixel_to_vector(view(j, i));
-        }));
+    if constexpr (detail::is_basic_view_v<View>) {
+        constexpr auto num_channels = boost::gil::num_channels<View>::value;
+        using channel_type = true_channel_type_t<typename boost::gil::channel_type<View>::type>;
+        blaze::DynamicMatrix<blaze::StaticVector<channel_type, num_channels>> result(
+            view.height(), view.width());
+        for (signed_size i = 0; i < view.height(); ++i) {
+            detail::pixels_to_vectors<num_channels>(view, i, result.data(i));
+        }
+        return result;
+    } else {
+        return blaze::evaluate(
+            blaze::generate(view.height(), view.width(), [&view](std::size_t i, std::size_t j) {
+                return pixel_to_vector(view(j, i));
+            }));
+    }
 }
 
 /** \brief constructs `blaze::CustomMatrix` out of `image_view`
@@ -302,37 +433,167 @@ auto as_matrix_channeled(ImageView source)
         reinterpret_cast<element_type*>(&source(0, 0)), source.height(), source.width());
 }
 
-// perform linear mapping from source range to destination range
-// only use with blaze::min and blaze::max
-// note that this is intended to narrow from source range
-// to destination range
+namespace detail
+{
+/** \brief Linear mapping in multiply-add form, `value * scale + offset`
+
+    The result is clamped into the destination range and rounded to nearest for integral
+    destination types. A degenerate source range maps everything to `dst_min`.
+*/
+template <typename U>
+struct linear_map {
+    double scale;
+    double offset;
+    double low;
+    double high;
+
+    linear_map(double src_min, double src_length, U dst_min, U dst_max, double dst_length)
+        : scale(src_length == 0 ? 0.0 : dst_length / src_length),
+          offset(static_cast<double>(dst_min) - src_min * scale),
+          low(static_cast<double>(dst_min)), high(static_cast<double>(dst_max))
+    {
+    }
+
+    template <typename T>
+    U operator()(const T& value) const
+    {
+        const double mapped = std::clamp(static_cast<double>(value) * scale + offset, low, high);
+        if constexpr (std::is_integral_v<U>) {
+            return static_cast<U>(std::floor(mapped + 0.5));
+        } else {
+            return static_cast<U>(mapped);
+        }
+    }
+};
+
+template <typename View>
+using view_channel_t = true_channel_type_t<typename boost::gil::channel_type<View>::type>;
+
+/// range of channel values of the view, [0, 1] for floating point channels as in GIL
+template <typename View>
+view_channel_t<View> channel_min()
+{
+    using traits = boost::gil::channel_traits<typename boost::gil::channel_type<View>::type>;
+    return static_cast<view_channel_t<View>>(traits::min_value());
+}
+
+template <typename View>
+view_channel_t<View> channel_max()
+{
+    using traits = boost::gil::channel_traits<typename boost::gil::channel_type<View>::type>;
+    return static_cast<view_channel_t<View>>(traits::max_value());
+}
+
+/// the mapping of `remap_to`, range lengths are `max - min`
+template <typename U, typename T>
+linear_map<U> make_remap(T src_min, T src_max, U dst_min, U dst_max)
+{
+    return linear_map<U>(static_cast<double>(src_min),
+                         static_cast<double>(src_max) - static_cast<double>(src_min),
+                         dst_min,
+                         dst_max,
+                         static_cast<double>(dst_max) - static_cast<double>(dst_min));
+}
+
+/// the mapping of `remap_to_channeled`, range lengths are `max - min + 1`
+template <typename U, typename T>
+linear_map<U> make_channeled_remap(T src_min, T src_max, U dst_min, U dst_max)
+{
+    return linear_map<U>(static_cast<double>(src_min),
+                         static_cast<double>(src_max) - static_cast<double>(src_min) + 1,
+                         dst_min,
+                         dst_max,
+                         static_cast<double>(dst_max) - static_cast<double>(dst_min) + 1);
+}
+
+template <typename U, typename VT, std::size_t... indices>
+auto make_channeled_remaps(const VT& src_min, const VT& src_max, U dst_min, U dst_max,
+                           std::index_sequence<indices...>)
+{
+    return std::array<linear_map<U>, sizeof...(indices)>{
+        make_channeled_remap(src_min[indices], src_max[indices], dst_min, dst_max)...};
+}
+} // namespace detail
+
+/** \brief Linear mapping from source range to destination range
+
+    Intended to narrow from source range to destination range, e.g. for visualization. The
+    mapping is precomputed into `value * scale + offset` form, results are rounded to nearest
+    and clamped into the destination range.
+
+    \tparam U The element type of the result
+    \arg source The matrix to remap
+    \arg src_min The minimum of the source range, e.g. from `minmax`
+    \arg src_max The maximum of the source range
+    \arg dst_min The minimum of the resulting range
+    \arg dst_max The maximum of the resulting range
+
+    \return A lazy Blaze expression with elements of type `U`
+*/
 template <typename U, typename MT, bool StorageOrder, typename T>
 auto remap_to(const blaze::DenseMatrix<MT, StorageOrder>& source, T src_min, T src_max,
               U dst_min = std::numeric_limits<U>::min(), U dst_max = std::numeric_limits<U>::max())
 {
-    // ensure that dst_max - dst_min will not overflow
-    return blaze::map(source,
-                      [src_min,
-                       dst_min,
-                       src_length = src_max - src_min,
-                       dst_length = static_cast<T>(dst_max) - dst_min](T value) {
-                          // attempt to avoid integral inaccuracy
-                          return static_cast<U>(dst_min + static_cast<double>(value - src_min) /
-                                                              src_length * dst_length);
-                      });
+    return blaze::map(~source, detail::make_remap(src_min, src_max, dst_min, dst_max));
 }
 
+/// Remaps the full range of `source`, found with a single `minmax` pass, into the range of `U`
 template <typename U, typename MT, bool StorageOrder>
 auto remap_to(const blaze::DenseMatrix<MT, StorageOrder>& source)
 {
-    return remap_to<U>(source, blaze::min(source), blaze::max(source));
+    const auto [src_min, src_max] = flash::minmax(source);
+    return remap_to<U>(source, src_min, src_max);
+}
+
+/** \brief Remaps the full range of `source` into the channel range of `destination` and writes
+    the result directly into it
+
+    Two passes over the source in total, one `minmax` and one writing pass, no intermediate
+    matrix is created.
+
+    \arg source Matrix of scalars, the same size as the view
+    \arg destination Single channel view to write into
+*/
+template <typename MT, bool SO, typename Locator>
+void remap_to(const blaze::DenseMatrix<MT, SO>& source,
+              const boost::gil::image_view<Locator>& destination)
+{
+    using view_type = boost::gil::image_view<Locator>;
+    static_assert(boost::gil::num_channels<view_type>::value == 1,
+                  "destination view must have single channel pixels");
+    if ((~source).rows() != static_cast<std::size_t>(destination.height()) ||
+        (~source).columns() != static_cast<std::size_t>(destination.width())) {
+        throw std::invalid_argument("the view and the matrix must have the same size");
+    }
+
+    const auto [src_min, src_max] = flash::minmax(source);
+    const auto map = detail::make_remap(src_min,
+                                        src_max,
+                                        detail::channel_min<view_type>(),
+                                        detail::channel_max<view_type>());
+    blaze::CompositeType_t<MT> matrix(~source);
+    for (signed_size i = 0; i < destination.height(); ++i) {
+        if constexpr (detail::is_basic_view_v<view_type>) {
+            auto* target = detail::channel_pointer(destination, i, 0);
+            for (signed_size j = 0; j < destination.width(); ++j) {
+                target[j] = map(matrix(i, j));
+            }
+        } else {
+            for (signed_size j = 0; j < destination.width(); ++j) {
+                destination(j, i)[0] = map(matrix(i, j));
+            }
+        }
+    }
 }
 
 /** \brief Remap channeled matrix into another range
 
     The class takes minimum and maximum along each channel and remaps it into new range. Do note
     that if a wider type is specified, `dst_min` and `dst_max` vectors has to be manually specified
-    and different than type min/max. Otherwise, overflow is guaranteed.
+    and different than type min/max.
+
+    Minimums and maximums of all channels are found in a single `channelwise_minmax` pass, the
+    per channel mappings are precomputed into `value * scale + offset` form.
 
     \tparam U The type of the resulting matrix
     \arg dst_min The minimum of the resulting range, do set manually if remapping into wider range
@@ -351,43 +612,69 @@ auto remap_to_channeled(const blaze::DenseMatrix<MT, SO>& source,
 {
     using source_vector_type = blaze::UnderlyingElement_t<MT>;
     constexpr auto vector_size = source_vector_type::size();
-    using element_type = blaze::UnderlyingElement_t<source_vector_type>;
     static_assert(blaze::IsStatic_v<source_vector_type> &&
                   blaze::IsDenseVector_v<source_vector_type>);
-    auto src_min_elems = channelwise_min(source);
-    auto src_max_elems = channelwise_max(source);
-
-    using result_vector_type = blaze::StaticVector<U, source_vector_type::size()>;
-
-    // pick according to std::common_type rules to make
-    // more resistant to overflow/underflow and accuracy loss
-    using proxy_type = std::common_type_t<element_type, U>;
-    using proxy_vector = blaze::StaticVector<proxy_type, source_vector_type::size()>;
-
-    result_vector_type dst_min_elems;
-    std::fill(dst_min_elems.begin(), dst_min_elems.end(), dst_min);
-    result_vector_type dst_max_elems;
-    std::fill(dst_max_elems.begin(), dst_max_elems.end(), dst_max);
-
-    proxy_vector src_range_length = src_max_elems - src_min_elems + 1;
-    proxy_vector dst_range_length = dst_max_elems - dst_min_elems + 1;
-
-    return blaze::evaluate(blaze::map(
-        (~source),
-        [src_min_elems, dst_min_elems, src_range_length, dst_range_length](
-            const source_vector_type& elem) {
-            result_vector_type result{};
-            for (std::size_t i = 0; i < vector_size; ++i) {
-                result[i] = dst_min_elems[i] +
-                            (static_cast<double>(elem[i] -
-                                                 src_min_elems[i]) / // cast to double to make more
-                                                                     // resistant to accuracy loss
-                             src_range_length[i] *
-                             dst_range_length[i]);
-            }
+    using result_vector_type = blaze::StaticVector<U, vector_size>;
+
+    const auto [src_min_elems, src_max_elems] = channelwise_minmax(source);
+    const auto maps = detail::make_channeled_remaps(
+        src_min_elems, src_max_elems, dst_min, dst_max, std::make_index_sequence<vector_size>{});
+
+    return blaze::evaluate(blaze::map((~source), [maps](const source_vector_type& elem) {
+        result_vector_type result{};
+        for (std::size_t i = 0; i < vector_size; ++i) {
+            result[i] = maps[i](elem[i]);
+        }
+        return result;
+    }));
+}
+
+/** \brief Remaps every channel of `source` into the channel range of `destination` and writes
+    the result directly into it
+
+    Same mapping as `remap_to_channeled`, without creating the intermediate matrix.
 
-            return result;
-        }));
+    \arg source Matrix of `StaticVector`s, the same size as the view
+    \arg destination View with as many channels as the vectors have elements
+*/
+template <typename MT, bool SO, typename Locator>
+void remap_to_channeled(const blaze::DenseMatrix<MT, SO>& source,
+                        const boost::gil::image_view<Locator>& destination)
+{
+    using view_type = boost::gil::image_view<Locator>;
+    using source_vector_type = blaze::UnderlyingElement_t<MT>;
+    constexpr auto vector_size = source_vector_type::size();
+    static_assert(boost::gil::num_channels<view_type>::value == vector_size,
+                  "the view must have as many channels as the vectors have elements");
+    if ((~source).rows() != static_cast<std::size_t>(destination.height()) ||
+        (~source).columns() != static_cast<std::size_t>(destination.width())) {
+        throw std::invalid_argument("the view and the matrix must have the same size");
+    }
+
+    const auto [src_min_elems, src_max_elems] = channelwise_minmax(source);
+    const auto maps = detail::make_channeled_remaps(src_min_elems,
+                                                    src_max_elems,
+                                                    detail::channel_min<view_type>(),
+                                                    detail::channel_max<view_type>(),
+                                                    std::make_index_sequence<vector_size>{});
+    blaze::CompositeType_t<MT> matrix(~source);
+    for (signed_size i = 0; i < destination.height(); ++i) {
+        if constexpr (detail::is_basic_view_v<view_type>) {
+            for (std::size_t channel = 0; channel < vector_size; ++channel) {
+                auto* target = detail::channel_pointer(destination, i, channel);
+                constexpr auto step = detail::channel_step_v<view_type>;
+                for (signed_size j = 0; j < destination.width(); ++j) {
+                    target[j * step] = maps[channel](matrix(i, j)[channel]);
+                }
+            }
+        } else {
+            for (signed_size j = 0; j < destination.width(); ++j) {
+                for (std::size_t channel = 0; channel < vector_size; ++channel) {
+                    destination(j, i)[channel] = maps[channel](matrix(i, j)[channel]);
+                }
+            }
+        }
+    }
 }
 
 inline boost::gil::gray8_image_t to_gray8_image(const blaze::DynamicMatrix<std::uint8_t>& source)
@@ -406,16 +693,19 @@ inline boost::gil::gray8_image_t to_gray8_image(const blaze::DynamicMatrix<std::
     \tparam VT The concrete vector type
     \arg vector The source vector to convert into `PixelType`
     \tparam TransposeFlag Transpose flag for the vector
+    \arg policy How entries are converted into channel values, see `flash/conversion.hpp`
 
     \return A pixel where each channel corresponds to entry in the vector, in the same order
 */
-template <typename PixelType, typename VT, bool TransposeFlag>
-auto vector_to_pixel(const blaze::DenseVector<VT, TransposeFlag>& vector)
+template <typename PixelType, typename VT, bool TransposeFlag,
+          typename Policy = truncate_conversion>
+auto vector_to_pixel(const blaze::DenseVector<VT, TransposeFlag>& vector, Policy policy = {})
 {
+    using channel_t = true_channel_type_t<typename boost::gil::channel_type<PixelType>::type>;
     auto num_channels = boost::gil::num_channels<PixelType>{};
     PixelType pixel{};
     for (std::size_t i = 0; i < num_channels; ++i) {
-        pixel[i] = (~vector)[i];
+        pixel[i] = convert_channel<channel_t>((~vector)[i], policy);
     }
 
     return pixel;
@@ -423,24 +713,47 @@ auto vector_to_pixel(const blaze::DenseVector<VT, TransposeFlag>& vector)
 
 namespace detail
 {
-template <typename ImageView, typename PixelType = typename ImageView::value_type, typename MT>
+template <typename ImageView, typename PixelType = typename ImageView::value_type, typename MT,
+          typename Policy>
 void from_matrix(std::true_type /*is_vector*/, ImageView view,
-                 const blaze::DenseMatrix<MT, blaze::rowMajor>& data)
+                 const blaze::DenseMatrix<MT, blaze::rowMajor>& data, Policy policy)
 {
-    for (signed_size i = 0; i < view.height(); ++i) {
-        for (signed_size j = 0; j < view.width(); ++j) {
-            view(j, i) = vector_to_pixel<PixelType>((~data)(i, j));
+    using vector_type = blaze::UnderlyingElement_t<MT>;
+    constexpr auto num_channels = boost::gil::num_channels<PixelType>::value;
+    // row pointers write channels in the layout of the view, converting through a different
+    // `PixelType` has to go pixel by pixel to let GIL map channels by color
+    if constexpr (is_basic_view_v<ImageView> && is_row_contiguous_v<MT, blaze::rowMajor> &&
+                  std::is_same_v<PixelType, typename ImageView::value_type> &&
+                  vector_type::size() == num_channels) {
+        for (signed_size i = 0; i < view.height(); ++i) {
+            vectors_to_pixels<num_channels>((~data).data(i), view, i, policy);
+        }
+    } else {
+        for (signed_size i = 0; i < view.height(); ++i) {
+            for (signed_size j = 0; j < view.width(); ++j) {
+                view(j, i) = vector_to_pixel<PixelType>((~data)(i, j), policy);
+            }
         }
     }
 }
 
-template <typename ImageView, typename PixelType = typename ImageView::value_type, typename MT>
+template <typename ImageView, typename PixelType = typename ImageView::value_type, typename MT,
+          typename Policy>
 void from_matrix(std::false_type /*is not vector*/, ImageView view,
-                 const blaze::DenseMatrix<MT, blaze::rowMajor>& data)
+                 const blaze::DenseMatrix<MT, blaze::rowMajor>& data, Policy policy)
 {
-    for (signed_size i = 0; i < view.height(); ++i) {
-        for (signed_size j = 0; j < view.width(); ++j) {
-            view(j, i)[0] = (~data)(i, j);
+    using channel_t = true_channel_type_t<typename boost::gil::channel_type<PixelType>::type>;
+    if constexpr (is_basic_view_v<ImageView> && is_row_contiguous_v<MT, blaze::rowMajor> &&
+                  std::is_same_v<PixelType, typename ImageView::value_type>) {
+        for (signed_size i = 0; i < view.height(); ++i) {
+            scatter_row<channel_step_v<ImageView>>(
+                (~data).data(i), view.width(), channel_pointer(view, i, 0), policy);
+        }
+    } else {
+        for (signed_size i = 0; i < view.height(); ++i) {
+            for (signed_size j = 0; j < view.width(); ++j) {
+                view(j, i)[0] = convert_channel<channel_t>((~data)(i, j), policy);
+            }
         }
     }
 }
@@ -457,15 +770,18 @@ void from_matrix(std::false_type /*is not vector*/, ImageView view,
     \tparam MT The concrete matrix type
     \tparam SO Either rowMajor or columnMajor
     \arg data The data to convert into image
+    \arg policy How elements are converted into channel values, truncation by default, e.g.
+    `saturate_round_conversion` to write floating point results into integral images without a
+    separate clamping pass
 */
 template <typename ImageType, typename PixelType = typename ImageType::value_type, typename MT,
-          bool SO>
-ImageType from_matrix(const blaze::DenseMatrix<MT, SO>& data)
+          bool SO, typename Policy = truncate_conversion,
+          typename = std::enable_if_t<is_conversion_policy_v<Policy>>>
+ImageType from_matrix(const blaze::DenseMatrix<MT, SO>& data, Policy policy = {})
 {
     ImageType result((~data).columns(), (~data).rows());
     auto view = boost::gil::view(result);
-    detail::from_matrix<decltype(view), PixelType>(
-        blaze::IsDenseVector<blaze::UnderlyingElement_t<MT>>{}, view, data);
+    from_matrix<decltype(view), PixelType>(data, view, policy);
     return result;
 }
 
@@ -479,15 +795,39 @@ ImageType from_matrix(const blaze::DenseMatrix<MT, SO>& data)
     \tparam PixelType the type of pixels that the resulting image is made of
     \tparam MT The concrete type of matrix
     \tparam SO Either rowMajor or columnMajor
+    \arg policy How elements are converted into channel values, truncation by default
 */
 template <typename ImageView, typename PixelType = typename ImageView::value_type, typename MT,
-          bool SO>
-void from_matrix(const blaze::DenseMatrix<MT, SO>& data, ImageView view)
+          bool SO, typename Policy = truncate_conversion>
+void from_matrix(const blaze::DenseMatrix<MT, SO>& data, ImageView view, Policy policy = {})
+{
+    if constexpr (SO == blaze::columnMajor) {
+        // pixels are written row by row, so the columns are transposed into rows blockwise first
+        const auto rows = to_storage_order<blaze::rowMajor>(data);
+        detail::from_matrix<decltype(view), PixelType>(
+            blaze::IsDenseVector<blaze::UnderlyingElement_t<MT>>{}, view, rows, policy);
+    } else {
+        detail::from_matrix<decltype(view), PixelType>(
+            blaze::IsDenseVector<blaze::UnderlyingElement_t<MT>>{}, view, data, policy);
+    }
+}
+
+/** \brief Converts a matrix into a new image of type `ImageType`, see `from_matrix`
+
+    \arg policy How elements are converted into channel values, truncation by default
+*/
+template <typename ImageType, typename Policy = truncate_conversion, typename MT, bool SO>
+ImageType to_image(const blaze::DenseMatrix<MT, SO>& data, Policy policy = {})
 {
-    detail::from_matrix<decltype(view), PixelType>(
-        blaze::IsDenseVector<blaze::UnderlyingElement_t<MT>>{}, view, data);
+    return from_matrix<ImageType>(data, policy);
 }
 
+/** \brief Copies `source` into a bigger matrix surrounded by `pad_count` elements of
+    `padding_value`
+
+    Prefer `padded_view`, which supplies border values without copying, unless the padded matrix
+    itself is needed.
+*/
 template <typename MT, bool StorageOrder, typename U>
 auto pad(const blaze::DenseMatrix<MT, StorageOrder>& source, std::size_t pad_count,
          const U& padding_value)
@@ -497,29 +837,28 @@ auto pad(const blaze::DenseMatrix<MT, StorageOrder>& source, std::size_t pad_cou
     if (pad_count == 0) {
         return blaze::DynamicMatrix<element_type>(source);
     }
-    blaze::DynamicMatrix<element_type> result((~source).rows() + pad_count * 2,
-                                              (~source).columns() + pad_count * 2);
-
-    auto full_resulting_width = (~source).columns() + pad_count * 2;
-    // first pad_count rows
-    blaze::submatrix(result, 0, 0, pad_count, full_resulting_width) = padding_value;
-    // last pad_count rows
-    blaze::submatrix(result, (~source).rows() + pad_count, 0, pad_count, full_resulting_width) =
-        padding_value;
-
-    auto vertical_block_height = (~source).rows();
-    // left pad_count columns, do note that top pad_count rows are already
-    // filled
-    blaze::submatrix(result, pad_count, 0, vertical_block_height, pad_count) = padding_value;
-    // right pad_count columns, do note that top pad_count rows are already
-    // filled
-    blaze::submatrix(
-        result, pad_count, (~source).columns() + pad_count, vertical_block_height, pad_count) =
-        padding_value;
-
-    // don't forget to copy the original contents
-    blaze::submatrix(result, pad_count, pad_count, (~source).rows(), (~source).columns()) = source;
+    const constant_border<element_type> border{static_cast<element_type>(padding_value)};
+    return blaze::DynamicMatrix<element_type>(padded_view(source, pad_count, border));
+}
+
+/** \brief Same as `pad`, but the padded matrix is taken from `arena`
 
+    \return A `workspace::matrix_type`, valid until `arena` is reset
+*/
+template <typename MT, bool StorageOrder, typename U>
+auto pad(const blaze::DenseMatrix<MT, StorageOrder>& source, std::size_t pad_count,
+         const U& padding_value, workspace& arena)
+{
+    using element_type = blaze::UnderlyingElement_t<MT>;
+    static_assert(std::is_convertible_v<element_type, U>);
+    auto result = arena.matrix<element_type>((~source).rows() + pad_count * 2,
+                                             (~source).columns() + pad_count * 2);
+    if (pad_count == 0) {
+        result = ~source;
+        return result;
+    }
+    const constant_border<element_type> border{static_cast<element_type>(padding_value)};
+    result = padded_view(source, pad_count, border);
     return result;
 }
 
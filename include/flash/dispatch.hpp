@@ -0,0 +1,153 @@
+#ifndef BLAZING_GIL_DISPATCH_HPP
+#define BLAZING_GIL_DISPATCH_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/dispatch_table.hpp>
+#include <flash/scaling.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/* Matrix level entry points of the hot kernels compiled into blazing-gil-dispatch, available
+   when the project is configured with BLAZING_GIL_DISPATCH=ON and the consuming target links
+   blazing-gil::dispatch. They loop over rows in the instruction set of the consumer and call
+   row kernels of the level selected at startup, see `active_isa`.
+*/
+namespace flash
+{
+namespace dispatch
+{
+/** \brief `saturate_round_conversion` of a `float` or `double` matrix into bytes
+
+    \return A `DynamicMatrix<std::uint8_t>`
+*/
+template <typename MT>
+blaze::DynamicMatrix<std::uint8_t> to_bytes(const blaze::DenseMatrix<MT, blaze::rowMajor>& source)
+{
+    using element_type = blaze::ElementType_t<MT>;
+    static_assert(std::is_same_v<element_type, float> || std::is_same_v<element_type, double>,
+                  "only float and double matrices are dispatched");
+
+    const blaze::DynamicMatrix<element_type> rows(~source);
+    blaze::DynamicMatrix<std::uint8_t> result(rows.rows(), rows.columns());
+    const auto& table = kernels();
+    for (std::size_t i = 0; i < rows.rows(); ++i) {
+        if constexpr (std::is_same_v<element_type, float>) {
+            table.saturate_round_f32_u8(rows.data(i), result.data(i), rows.columns());
+        } else {
+            table.saturate_round_f64_u8(rows.data(i), result.data(i), rows.columns());
+        }
+    }
+    return result;
+}
+
+/** \brief Convolution with a 3x3 kernel, the result has the dimensions of `source`
+
+    Unlike `flash::convolve`, borders replicate the edge elements instead of being left at zero,
+    and the result is centered on the source element.
+*/
+inline blaze::DynamicMatrix<float> convolve_3x3(const blaze::DynamicMatrix<float>& source,
+                                                const float (&kernel)[3][3])
+{
+    // flipped, the row kernel correlates
+    float flipped[9];
+    for (std::size_t k = 0; k < 9; ++k) {
+        flipped[k] = kernel[2 - k / 3][2 - k % 3];
+    }
+
+    const auto rows = source.rows();
+    blaze::DynamicMatrix<float> result(rows, source.columns());
+    const auto& table = kernels();
+    for (std::size_t i = 0; i < rows; ++i) {
+        const auto above = i == 0 ? 0 : i - 1;
+        const auto below = std::min(i + 1, rows - 1);
+        table.convolve_3x3_f32(source.data(above),
+                               source.data(i),
+                               source.data(below),
+                               flipped,
+                               result.data(i),
+                               source.columns());
+    }
+    return result;
+}
+
+/** \brief Resizes `source` with the same filters as `flash::scale`
+
+    \tparam Method One of `nearest_neighbor`, `bilinear_interpolation` or `lanczos_method`
+    \arg a The Lanczos window size, ignored by other methods
+*/
+template <typename Method>
+blaze::DynamicMatrix<float> scale(Method method, const blaze::DynamicMatrix<float>& source,
+                                  std::size_t new_width, std::size_t new_height,
+                                  signed_size a = 3)
+{
+    if (source.rows() == 0 || source.columns() == 0 || new_width == 0 || new_height == 0) {
+        throw std::invalid_argument("cannot scale from or to an empty image");
+    }
+    const auto horizontal = detail::make_resampling_taps(method, source.columns(), new_width, a);
+    const auto vertical = detail::make_resampling_taps(method, source.rows(), new_height, a);
+    const std::vector<float> weights(horizontal.weights.begin(), horizontal.weights.end());
+    const auto& table = kernels();
+
+    // every tap is read, including the zero weighted ones past the last column
+    std::vector<float> padded_row(source.columns() + horizontal.taps_per_sample, 0.0f);
+    blaze::DynamicMatrix<float> resampled(source.rows(), new_width);
+    for (std::size_t i = 0; i < source.rows(); ++i) {
+        std::copy_n(source.data(i), source.columns(), padded_row.begin());
+        table.resample_row_f32(padded_row.data(),
+                               horizontal.first.data(),
+                               weights.data(),
+                               horizontal.taps_per_sample,
+                               resampled.data(i),
+                               new_width);
+    }
+
+    blaze::DynamicMatrix<float> result(new_height, new_width, 0.0f);
+    for (std::size_t i = 0; i < new_height; ++i) {
+        for (std::size_t k = 0; k < vertical.count[i]; ++k) {
+            const auto weight =
+                static_cast<float>(vertical.weights[i * vertical.taps_per_sample + k]);
+            table.accumulate_row_f32(
+                resampled.data(vertical.first[i] + k), weight, result.data(i), new_width);
+        }
+    }
+    return result;
+}
+
+/// `flash::anisotropic_diffusion<float>` of a scalar matrix on the dispatched row kernel
+inline blaze::DynamicMatrix<float> anisotropic_diffusion(const blaze::DynamicMatrix<float>& input,
+                                                         double delta_t, double kappa,
+                                                         std::uint64_t iteration_count)
+{
+    const auto rows = input.rows();
+    blaze::DynamicMatrix<float> current(input);
+    blaze::DynamicMatrix<float> next(rows, input.columns());
+    const auto step = static_cast<float>(delta_t);
+    const auto inverse_kappa = static_cast<float>(1 / kappa);
+    const auto& table = kernels();
+    for (std::uint64_t counter = 0; counter < iteration_count; ++counter) {
+        for (std::size_t i = 0; i < rows; ++i) {
+            const auto above = i == 0 ? 0 : i - 1;
+            const auto below = std::min(i + 1, rows - 1);
+            table.diffuse_row_f32(current.data(above),
+                                  current.data(i),
+                                  current.data(below),
+                                  next.data(i),
+                                  input.columns(),
+                                  step,
+                                  inverse_kappa);
+        }
+        // swaps the buffers of the two DynamicMatrix objects without copying
+        swap(current, next);
+    }
+    return current;
+}
+} // namespace dispatch
+} // namespace flash
+
+#endif
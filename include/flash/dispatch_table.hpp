@@ -0,0 +1,73 @@
+#ifndef BLAZING_GIL_DISPATCH_TABLE_HPP
+#define BLAZING_GIL_DISPATCH_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/* Interface of the compiled blazing-gil-dispatch library. This header includes nothing but
+   standard headers on purpose: it is included by translation units compiled for different
+   instruction sets, and any inline function they share could be merged by the linker into the
+   variant of the widest instruction set, which would then run on machines lacking it.
+*/
+namespace flash
+{
+namespace dispatch
+{
+/// instruction set levels the library is compiled for, in increasing order
+enum class isa { baseline, sse42, avx2, avx512 };
+
+/** \brief Row kernels of one instruction set level
+
+    All pointers are to rows of `count` (or `columns`) contiguous elements, rows must not
+    overlap unless stated otherwise.
+*/
+struct kernel_table {
+    isa level;
+
+    /// `target[j] = clamp(round(source[j]), 0, 255)`, the `saturate_round_conversion` of bytes
+    void (*saturate_round_f32_u8)(const float* source, std::uint8_t* target, std::size_t count);
+    void (*saturate_round_f64_u8)(const double* source, std::uint8_t* target,
+                                  std::size_t count);
+
+    /// 3x3 convolution of three consecutive rows with replicated left and right borders
+    void (*convolve_3x3_f32)(const float* above, const float* middle, const float* below,
+                             const float* kernel, float* target, std::size_t columns);
+
+    /// `target[j] = sum(weights[j * taps + k] * source[first[j] + k])`, horizontal resampling
+    void (*resample_row_f32)(const float* source, const std::size_t* first,
+                             const float* weights, std::size_t taps, float* target,
+                             std::size_t count);
+
+    /// `target[j] += weight * source[j]`, vertical resampling
+    void (*accumulate_row_f32)(const float* source, float weight, float* target,
+                               std::size_t count);
+
+    /// one Perona-Malik step of the middle row, with replicated left and right borders
+    void (*diffuse_row_f32)(const float* above, const float* middle, const float* below,
+                            float* target, std::size_t columns, float step,
+                            float inverse_kappa);
+};
+
+/// the highest level supported by the processor and the operating system
+isa detected_isa() noexcept;
+
+/** \brief The level whose kernels `kernels` returns
+
+    The detected level, unless the `FLASH_ISA` environment variable names a lower one
+    (`baseline`, `sse4.2`, `avx2` or `avx512`), which is useful to test every variant on a
+    single machine. Levels above the detected one, or not compiled into the library, are
+    lowered to the nearest available one. Decided once on first use.
+*/
+isa active_isa() noexcept;
+
+/// kernels of the active level
+const kernel_table& kernels() noexcept;
+
+/// kernels of `level`, or of the nearest lower level compiled into the library
+const kernel_table& kernels(isa level) noexcept;
+
+const char* isa_name(isa level) noexcept;
+} // namespace dispatch
+} // namespace flash
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef BLAZING_GIL_HALF_HPP
+#define BLAZING_GIL_HALF_HPP
+
+#include <blaze/Blaze.h>
+#include <blaze/math/typetraits/IsVector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__F16C__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace flash
+{
+namespace detail
+{
+inline std::uint32_t float_bits(float value) noexcept
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(std::uint32_t bits) noexcept
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// IEEE binary16 encoding of `value`, rounded to nearest even
+inline std::uint16_t float_to_half_bits(float value) noexcept
+{
+#if defined(__F16C__)
+    return static_cast<std::uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+    constexpr std::uint32_t float_infinity = 0xffu << 23;
+    constexpr std::uint32_t half_overflow = (127u + 16u) << 23;
+    constexpr std::uint32_t half_normal_min = 113u << 23;
+    // adding 0.5f aligns the subnormal half mantissa with the lowest bits of the float
+    constexpr std::uint32_t subnormal_magic = 126u << 23;
+
+    std::uint32_t bits = float_bits(value);
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    bits &= 0x7fffffffu;
+
+    std::uint16_t result;
+    if (bits >= half_overflow) {
+        // infinity for overflows, quiet NaN for NaNs
+        result = bits > float_infinity ? 0x7e00u : 0x7c00u;
+    } else if (bits < half_normal_min) {
+        const float shifted = bits_float(bits) + bits_float(subnormal_magic);
+        result = static_cast<std::uint16_t>(float_bits(shifted) - subnormal_magic);
+    } else {
+        const std::uint32_t odd_mantissa = (bits >> 13) & 1u;
+        bits += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfffu + odd_mantissa;
+        result = static_cast<std::uint16_t>(bits >> 13);
+    }
+    return static_cast<std::uint16_t>(result | sign);
+#endif
+}
+
+inline float half_bits_to_float(std::uint16_t half) noexcept
+{
+#if defined(__F16C__)
+    return _cvtsh_ss(half);
+#else
+    constexpr std::uint32_t shifted_exponent = 0x7c00u << 13;
+    constexpr float subnormal_magic = 6.103515625e-05f; // 2^-14, float with bits 113 << 23
+
+    std::uint32_t bits = (static_cast<std::uint32_t>(half) & 0x7fffu) << 13;
+    const std::uint32_t exponent = bits & shifted_exponent;
+    bits += static_cast<std::uint32_t>(127 - 15) << 23;
+    float result;
+    if (exponent == shifted_exponent) {
+        // infinity or NaN
+        result = bits_float(bits + (static_cast<std::uint32_t>(128 - 16) << 23));
+    } else if (exponent == 0) {
+        // zero or subnormal, renormalized by float arithmetic
+        result = bits_float(bits + (1u << 23)) - subnormal_magic;
+    } else {
+        result = bits_float(bits);
+    }
+    return bits_float(float_bits(result) | ((static_cast<std::uint32_t>(half) & 0x8000u) << 16));
+#endif
+}
+
+/// bfloat16 encoding of `value`, the upper half of the float rounded to nearest even
+inline std::uint16_t float_to_bfloat16_bits(float value) noexcept
+{
+    const std::uint32_t bits = float_bits(value);
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        // keep NaNs quiet instead of rounding them into infinity
+        return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+    }
+    return static_cast<std::uint16_t>((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+}
+
+inline float bfloat16_bits_to_float(std::uint16_t value) noexcept
+{
+    return bits_float(static_cast<std::uint32_t>(value) << 16);
+}
+} // namespace detail
+
+/** \brief IEEE half precision storage type, 1 sign, 5 exponent and 10 mantissa bits
+
+    Meant for storing large intermediate matrices at a quarter of the size of `double`.
+    Arithmetic happens in `float`, which the type converts to implicitly, and converting back
+    rounds to nearest even. Conversions use F16C instructions when compiled with them enabled
+    (e.g. `-mf16c` or `-march=haswell`), whole rows are converted 8 or 16 elements at a time by
+    `detail::convert_row`.
+*/
+class float16
+{
+  public:
+    float16() = default;
+    float16(float value) noexcept : bits(detail::float_to_half_bits(value)) {}
+
+    operator float() const noexcept { return detail::half_bits_to_float(bits); }
+
+    static float16 from_bits(std::uint16_t bits) noexcept
+    {
+        float16 result;
+        result.bits = bits;
+        return result;
+    }
+
+    std::uint16_t to_bits() const noexcept { return bits; }
+
+  private:
+    std::uint16_t bits;
+};
+
+/** \brief bfloat16 storage type, the upper half of a `float`
+
+    Same range as `float` with only 8 bits of mantissa, thus it does not overflow where
+    `float16` does, e.g. for squared gradients, at the cost of precision. Conversions are plain
+    shifts and vectorize without special instructions.
+*/
+class bfloat16
+{
+  public:
+    bfloat16() = default;
+    bfloat16(float value) noexcept : bits(detail::float_to_bfloat16_bits(value)) {}
+
+    operator float() const noexcept { return detail::bfloat16_bits_to_float(bits); }
+
+    static bfloat16 from_bits(std::uint16_t bits) noexcept
+    {
+        bfloat16 result;
+        result.bits = bits;
+        return result;
+    }
+
+    std::uint16_t to_bits() const noexcept { return bits; }
+
+  private:
+    std::uint16_t bits;
+};
+
+static_assert(sizeof(float16) == 2 && sizeof(bfloat16) == 2,
+              "row conversions reinterpret storage types as 16 bit integers");
+
+template <typename T>
+constexpr bool is_reduced_precision_v =
+    std::is_same_v<T, float16> || std::is_same_v<T, bfloat16>;
+
+namespace detail
+{
+template <typename T>
+auto compute_type()
+{
+    if constexpr (is_reduced_precision_v<T>) {
+        return float{};
+    } else if constexpr (blaze::IsVector_v<T>) {
+        using element_type = decltype(compute_type<blaze::ElementType_t<T>>());
+        return blaze::StaticVector<element_type, T::size()>{};
+    } else {
+        return T{};
+    }
+}
+} // namespace detail
+
+/** \brief The type arithmetic on `T` is done in
+
+    `float` for `float16` and `bfloat16`, `StaticVector`s of the compute type of their elements
+    for vectors, `T` itself otherwise.
+*/
+template <typename T>
+using compute_type_t = decltype(detail::compute_type<T>());
+
+namespace detail
+{
+/// converts between storage and compute types, element by element for vectors
+template <typename Target, typename Source>
+Target convert_element(const Source& value)
+{
+    if constexpr (blaze::IsVector_v<Target>) {
+        Target result;
+        for (std::size_t k = 0; k < Target::size(); ++k) {
+            result[k] = convert_element<blaze::ElementType_t<Target>>(value[k]);
+        }
+        return result;
+    } else {
+        return static_cast<Target>(value);
+    }
+}
+
+template <typename Source, typename Target>
+void convert_row(const Source* source, Target* target, std::size_t count)
+{
+    for (std::size_t j = 0; j < count; ++j) {
+        target[j] = convert_element<Target>(source[j]);
+    }
+}
+
+inline void convert_row(const float16* source, float* target, std::size_t count)
+{
+    std::size_t j = 0;
+#if defined(__AVX512F__)
+    for (; j + 16 <= count; j += 16) {
+        const auto half = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + j));
+        _mm512_storeu_ps(target + j, _mm512_cvtph_ps(half));
+    }
+#endif
+#if defined(__F16C__)
+    for (; j + 8 <= count; j += 8) {
+        const auto half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + j));
+        _mm256_storeu_ps(target + j, _mm256_cvtph_ps(half));
+    }
+#endif
+    for (; j < count; ++j) {
+        target[j] = source[j];
+    }
+}
+
+inline void convert_row(const float* source, float16* target, std::size_t count)
+{
+    std::size_t j = 0;
+#if defined(__AVX512F__)
+    for (; j + 16 <= count; j += 16) {
+        const auto half = _mm512_cvtps_ph(_mm512_loadu_ps(source + j), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + j), half);
+    }
+#endif
+#if defined(__F16C__)
+    for (; j + 8 <= count; j += 8) {
+        const auto half = _mm256_cvtps_ph(_mm256_loadu_ps(source + j), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + j), half);
+    }
+#endif
+    for (; j < count; ++j) {
+        target[j] = source[j];
+    }
+}
+} // namespace detail
+} // namespace flash
+
+#endif
@@ -0,0 +1,371 @@
+#ifndef BLAZING_GIL_HISTOGRAM_HPP
+#define BLAZING_GIL_HISTOGRAM_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/core.hpp>
+#include <flash/lut.hpp>
+#include <flash/parallel.hpp>
+#include <flash/reduction.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flash
+{
+/** \brief Histogram of a single channel with cumulative counts for fast queries
+
+    Bins correspond to values, bin `b` counts occurrences of value `b`. Cumulative counts are
+    computed once on construction, so `cdf` is a lookup and `percentile` a binary search.
+*/
+class histogram
+{
+  public:
+    histogram() = default;
+
+    /// takes the counts of bins, `counts[b]` is the number of occurrences of value `b`
+    explicit histogram(std::vector<std::uint64_t> bin_counts)
+        : counts(std::move(bin_counts)), cumulative(counts.size())
+    {
+        std::uint64_t running = 0;
+        for (std::size_t bin = 0; bin < counts.size(); ++bin) {
+            running += counts[bin];
+            cumulative[bin] = running;
+        }
+    }
+
+    std::size_t bin_count() const noexcept { return counts.size(); }
+
+    std::uint64_t total() const noexcept { return cumulative.empty() ? 0 : cumulative.back(); }
+
+    std::uint64_t operator[](std::size_t bin) const { return counts[bin]; }
+
+    /// number of values less than or equal to `bin`
+    std::uint64_t cumulative_count(std::size_t bin) const { return cumulative[bin]; }
+
+    /// fraction of values less than or equal to `bin`
+    double cdf(std::size_t bin) const
+    {
+        if (total() == 0) {
+            throw std::logic_error("cdf of an empty histogram");
+        }
+        return static_cast<double>(cumulative[bin]) / static_cast<double>(total());
+    }
+
+    /** \brief The smallest value such that at least `p` percent of values are less than or
+        equal to it
+
+        \arg p The percentile in [0, 100], 0 gives the minimum and 100 the maximum
+    */
+    std::size_t percentile(double p) const
+    {
+        if (total() == 0) {
+            throw std::logic_error("percentile of an empty histogram");
+        }
+        if (!(p >= 0 && p <= 100)) {
+            throw std::invalid_argument("percentile must be in [0, 100]");
+        }
+        const auto target = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(total()) / 100)));
+        return static_cast<std::size_t>(
+            std::lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin());
+    }
+
+    /// adds counts of another histogram with the same number of bins
+    histogram& operator+=(const histogram& other)
+    {
+        if (other.bin_count() != bin_count()) {
+            throw std::invalid_argument("histograms must have the same number of bins");
+        }
+        for (std::size_t bin = 0; bin < counts.size(); ++bin) {
+            counts[bin] += other.counts[bin];
+        }
+        *this = histogram(std::move(counts));
+        return *this;
+    }
+
+  private:
+    std::vector<std::uint64_t> counts;
+    std::vector<std::uint64_t> cumulative;
+};
+
+namespace detail
+{
+template <typename T>
+constexpr std::size_t histogram_bins_v = std::size_t(std::numeric_limits<T>::max()) + 1;
+
+/* Consecutive equal values increment the same counter, and the increment has to wait for the
+   previous store to retire. Interleaving several copies of small histograms breaks such chains,
+   for 16 bit values the chance of collision is small and copies would only pollute the cache.
+*/
+template <typename T>
+constexpr std::size_t sub_histogram_count_v = histogram_bins_v<T> <= 256 ? 4 : 1;
+
+template <typename T>
+void check_histogram_type()
+{
+    static_assert(std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) <= 2,
+                  "histograms are supported for 8 and 16 bit unsigned values");
+}
+
+/* Builds histograms of `Channels` channels of a `rows` by `columns` grid. `row_values(i)`
+   returns a callable `(j, channel) -> T` for row `i`. Blocks of rows are counted in parallel
+   into thread local 32 bit sub-histograms, which are then merged in parallel over bin ranges.
+*/
+template <typename T, std::size_t Channels, typename RowValues>
+std::array<histogram, Channels> build_histograms(std::size_t rows, std::size_t columns,
+                                                 RowValues row_values)
+{
+    check_histogram_type<T>();
+    constexpr auto bins = histogram_bins_v<T>;
+    constexpr auto subs = sub_histogram_count_v<T>;
+    constexpr auto local_size = Channels * subs * bins;
+
+    // blocks are made big enough for counting to outweigh clearing and merging
+    const auto block_elements = std::max(reduction_block_elements, local_size * 4);
+    const auto block_rows =
+        std::max<std::size_t>(1, block_elements / std::max<std::size_t>(1, columns));
+    const auto block_count = (rows + block_rows - 1) / block_rows;
+
+    std::vector<std::vector<std::uint32_t>> partials(block_count);
+    parallel_for(0, block_count, [&](std::size_t block) {
+        auto& local = partials[block];
+        local.assign(local_size, 0);
+        const auto last = std::min(rows, (block + 1) * block_rows);
+        for (std::size_t i = block * block_rows; i < last; ++i) {
+            const auto values = row_values(i);
+            for (std::size_t j = 0; j < columns; ++j) {
+                for (std::size_t channel = 0; channel < Channels; ++channel) {
+                    const auto sub = channel * subs + j % subs;
+                    ++local[sub * bins + static_cast<std::size_t>(values(j, channel))];
+                }
+            }
+        }
+    });
+
+    constexpr std::size_t merge_chunk = 4096;
+    std::vector<std::uint64_t> counts(Channels * bins, 0);
+    parallel_for(0, (counts.size() + merge_chunk - 1) / merge_chunk, [&](std::size_t chunk) {
+        const auto last = std::min(counts.size(), (chunk + 1) * merge_chunk);
+        for (std::size_t index = chunk * merge_chunk; index < last; ++index) {
+            const auto channel = index / bins;
+            const auto bin = index % bins;
+            std::uint64_t total = 0;
+            for (const auto& local : partials) {
+                for (std::size_t sub = 0; sub < subs; ++sub) {
+                    total += local[(channel * subs + sub) * bins + bin];
+                }
+            }
+            counts[index] = total;
+        }
+    });
+
+    std::array<histogram, Channels> result;
+    for (std::size_t channel = 0; channel < Channels; ++channel) {
+        result[channel] = histogram(std::vector<std::uint64_t>(
+            counts.begin() + channel * bins, counts.begin() + (channel + 1) * bins));
+    }
+    return result;
+}
+
+template <std::size_t Channels, typename MT, bool SO>
+std::array<histogram, Channels> build_matrix_histograms(const blaze::DenseMatrix<MT, SO>& source)
+{
+    using element_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    using value_type = std::remove_cv_t<blaze::UnderlyingElement_t<element_type>>;
+    blaze::CompositeType_t<MT> matrix(~source);
+    return build_histograms<value_type, Channels>(
+        matrix.rows(), matrix.columns(), [&matrix](std::size_t i) {
+            return [&matrix, i](std::size_t j, [[maybe_unused]] std::size_t channel) {
+                if constexpr (blaze::IsDenseVector_v<element_type>) {
+                    return matrix(i, j)[channel];
+                } else {
+                    return matrix(i, j);
+                }
+            };
+        });
+}
+
+template <typename View>
+auto build_view_histograms(const View& view)
+{
+    constexpr auto channels = boost::gil::num_channels<View>::value;
+    using value_type = view_channel_t<View>;
+    if constexpr (is_basic_view_v<View>) {
+        return build_histograms<value_type, channels>(
+            view.height(), view.width(), [&view](std::size_t i) {
+                std::array<const value_type*, channels> pointers;
+                for (std::size_t channel = 0; channel < channels; ++channel) {
+                    pointers[channel] = channel_pointer(view, i, channel);
+                }
+                return [pointers](std::size_t j, std::size_t channel) {
+                    return pointers[channel][j * channel_step_v<View>];
+                };
+            });
+    } else {
+        return build_histograms<value_type, channels>(
+            view.height(), view.width(), [&view](std::size_t i) {
+                return [&view, i](std::size_t j, std::size_t channel) {
+                    return static_cast<value_type>(view(j, i)[channel]);
+                };
+            });
+    }
+}
+
+template <typename U, std::size_t... indices>
+auto make_percentile_remaps(const std::array<histogram, sizeof...(indices)>& histograms,
+                            double low, double high, U dst_min, U dst_max,
+                            std::index_sequence<indices...>)
+{
+    return std::array<linear_map<U>, sizeof...(indices)>{
+        make_remap(static_cast<double>(histograms[indices].percentile(low)),
+                   static_cast<double>(histograms[indices].percentile(high)),
+                   dst_min,
+                   dst_max)...};
+}
+
+/// maps values so that the result has approximately uniform histogram
+template <typename T>
+std::vector<T> equalization_table(const histogram& source)
+{
+    const auto bins = source.bin_count();
+    std::vector<T> table(bins);
+    std::size_t first = 0;
+    while (first < bins && source[first] == 0) {
+        ++first;
+    }
+    const std::uint64_t below = first < bins ? source.cumulative_count(first) : 0;
+    const auto remaining = source.total() - below;
+    const double top = static_cast<double>(std::numeric_limits<T>::max());
+    for (std::size_t bin = 0; bin < bins; ++bin) {
+        if (bin <= first || remaining == 0) {
+            table[bin] = 0;
+        } else {
+            const double fraction = static_cast<double>(source.cumulative_count(bin) - below) /
+                                    static_cast<double>(remaining);
+            table[bin] = static_cast<T>(std::floor(fraction * top + 0.5));
+        }
+    }
+    return table;
+}
+} // namespace detail
+
+/** \brief Histogram of a matrix of 8 or 16 bit unsigned integers
+
+    \return `histogram` with 256 or 65536 bins
+*/
+template <typename MT, bool SO>
+histogram make_histogram(const blaze::DenseMatrix<MT, SO>& source)
+{
+    static_assert(!blaze::IsDenseVector_v<blaze::ElementType_t<MT>>,
+                  "use make_channelwise_histograms for matrices of vectors");
+    return detail::build_matrix_histograms<1>(source)[0];
+}
+
+/// Histograms of every channel of a matrix of `StaticVector`s, in a single pass
+template <typename MT, bool SO>
+auto make_channelwise_histograms(const blaze::DenseMatrix<MT, SO>& source)
+{
+    using element_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    static_assert(blaze::IsDenseVector_v<element_type>,
+                  "use make_histogram for matrices of scalars");
+    return detail::build_matrix_histograms<element_type::size()>(source);
+}
+
+/// Histogram of a single channel GIL view, read directly without converting to matrix
+template <typename Locator>
+histogram make_histogram(const boost::gil::image_view<Locator>& source)
+{
+    static_assert(boost::gil::num_channels<boost::gil::image_view<Locator>>::value == 1,
+                  "use make_channelwise_histograms for multi-channel views");
+    return detail::build_view_histograms(source)[0];
+}
+
+/// Histograms of every channel of a GIL view, interleaved or planar, in a single pass
+template <typename Locator>
+auto make_channelwise_histograms(const boost::gil::image_view<Locator>& source)
+{
+    return detail::build_view_histograms(source);
+}
+
+/** \brief Contrast stretching that clips at percentiles instead of the minimum and maximum
+
+    Unlike `remap_to`, a few outliers do not compress the range of all other values. Values
+    below the low percentile become `dst_min`, above the high percentile `dst_max`.
+
+    \tparam U The element type of the result
+    \arg source Matrix of 8 or 16 bit unsigned integers
+    \arg low The percentile mapped to `dst_min`, in [0, 100]
+    \arg high The percentile mapped to `dst_max`, in [0, 100]
+
+    \return A lazy Blaze expression with elements of type `U`
+*/
+template <typename U, typename MT, bool SO>
+auto remap_to_percentile(const blaze::DenseMatrix<MT, SO>& source, double low = 1,
+                         double high = 99, U dst_min = std::numeric_limits<U>::min(),
+                         U dst_max = std::numeric_limits<U>::max())
+{
+    const auto source_histogram = make_histogram(source);
+    return remap_to<U>(source,
+                       static_cast<double>(source_histogram.percentile(low)),
+                       static_cast<double>(source_histogram.percentile(high)),
+                       dst_min,
+                       dst_max);
+}
+
+/** \brief Percentile driven contrast stretching of every channel
+
+    Same as `remap_to_percentile`, percentiles are taken per channel.
+
+    \return A `DynamicMatrix<StaticVector<U, N>>`
+*/
+template <typename U, typename MT, bool SO>
+auto remap_to_channeled_percentile(const blaze::DenseMatrix<MT, SO>& source, double low = 1,
+                                   double high = 99, U dst_min = std::numeric_limits<U>::min(),
+                                   U dst_max = std::numeric_limits<U>::max())
+{
+    using source_vector_type = blaze::UnderlyingElement_t<MT>;
+    constexpr auto vector_size = source_vector_type::size();
+    const auto maps = detail::make_percentile_remaps(make_channelwise_histograms(source),
+                                                     low,
+                                                     high,
+                                                     dst_min,
+                                                     dst_max,
+                                                     std::make_index_sequence<vector_size>{});
+
+    return blaze::evaluate(blaze::map((~source), [maps](const source_vector_type& elem) {
+        blaze::StaticVector<U, vector_size> result;
+        for (std::size_t i = 0; i < vector_size; ++i) {
+            result[i] = maps[i](elem[i]);
+        }
+        return result;
+    }));
+}
+
+/** \brief Histogram equalization
+
+    Spreads the values so that the cumulative histogram of the result is approximately linear.
+
+    \arg source Matrix of 8 or 16 bit unsigned integers
+
+    \return A `DynamicMatrix` of the same element type
+*/
+template <typename MT, bool SO>
+auto equalize(const blaze::DenseMatrix<MT, SO>& source)
+{
+    using value_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    const lookup_table<value_type, value_type> table(
+        detail::equalization_table<value_type>(make_histogram(source)));
+    return apply_lut(source, table);
+}
+} // namespace flash
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef BLAZING_GIL_JPEG_HPP
+#define BLAZING_GIL_JPEG_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/core.hpp>
+#include <flash/scaling.hpp>
+
+// includes jpeglib.h with the same extern "C" handling GIL uses
+#include <boost/gil/extension/io/jpeg/tags.hpp>
+
+#include <csetjmp>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace flash
+{
+/** \brief Picks the largest DCT scaling denominator libjpeg supports (1, 2, 4 or 8) that keeps
+    the decoded image at least as big as the target size
+
+    \return The denominator `d`, the decoded image will be `ceil(width / d)` by
+    `ceil(height / d)`
+*/
+inline unsigned int jpeg_scale_denominator(std::size_t width, std::size_t height,
+                                           std::size_t new_width, std::size_t new_height)
+{
+    unsigned int denominator = 8;
+    while (denominator > 1 && ((width + denominator - 1) / denominator < new_width ||
+                               (height + denominator - 1) / denominator < new_height)) {
+        denominator /= 2;
+    }
+    return denominator;
+}
+
+namespace detail
+{
+struct jpeg_error_manager {
+    jpeg_error_mgr base; // must be the first member, libjpeg only knows about it
+    std::jmp_buf jump_buffer;
+    char message[JMSG_LENGTH_MAX];
+};
+
+inline void jpeg_error_exit(j_common_ptr info)
+{
+    auto* errors = reinterpret_cast<jpeg_error_manager*>(info->err);
+    (*info->err->format_message)(info, errors->message);
+    std::longjmp(errors->jump_buffer, 1);
+}
+
+/* libjpeg reports errors by calling error_exit, which must not return. The jump lands in this
+   frame, which has nothing to destroy, and is turned into an exception from here.
+*/
+template <typename Function>
+void jpeg_checked(jpeg_decompress_struct& info, Function function)
+{
+    // volatile, otherwise the pointer might be clobbered by longjmp
+    jpeg_error_manager* volatile errors = reinterpret_cast<jpeg_error_manager*>(info.err);
+    if (setjmp(errors->jump_buffer)) {
+        throw std::runtime_error(std::string("libjpeg: ") + errors->message);
+    }
+    function();
+}
+
+class jpeg_decompressor
+{
+  public:
+    explicit jpeg_decompressor(const std::string& path)
+        : file(std::fopen(path.c_str(), "rb"), &std::fclose)
+    {
+        if (!file) {
+            throw std::runtime_error("cannot open " + path);
+        }
+        info.err = jpeg_std_error(&errors.base);
+        errors.base.error_exit = &jpeg_error_exit;
+        jpeg_checked(info, [this]() { jpeg_create_decompress(&info); });
+        try {
+            jpeg_checked(info, [this]() {
+                jpeg_stdio_src(&info, file.get());
+                jpeg_read_header(&info, TRUE);
+            });
+        } catch (...) {
+            // the destructor does not run for a partially constructed object
+            jpeg_destroy_decompress(&info);
+            throw;
+        }
+    }
+
+    jpeg_decompressor(const jpeg_decompressor&) = delete;
+    jpeg_decompressor& operator=(const jpeg_decompressor&) = delete;
+
+    ~jpeg_decompressor() { jpeg_destroy_decompress(&info); }
+
+    jpeg_decompress_struct info{};
+
+  private:
+    jpeg_error_manager errors{};
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file;
+};
+
+template <typename T>
+void jpeg_row_to_vector(const JSAMPLE* samples, blaze::DynamicVector<T, blaze::rowVector>& row)
+{
+    for (std::size_t j = 0; j < row.size(); ++j) {
+        if constexpr (blaze::IsDenseVector_v<T>) {
+            for (std::size_t channel = 0; channel < T::size(); ++channel) {
+                row[j][channel] = samples[j * T::size() + channel];
+            }
+        } else {
+            row[j] = samples[j];
+        }
+    }
+}
+
+template <typename T, typename Method>
+blaze::DynamicMatrix<T> read_jpeg_scaled(const std::string& path, J_COLOR_SPACE color_space,
+                                         std::size_t new_width, std::size_t new_height,
+                                         Method method, signed_size a)
+{
+    if (new_width == 0 || new_height == 0) {
+        throw std::invalid_argument("cannot scale to an empty image");
+    }
+    jpeg_decompressor decompressor(path);
+    auto& info = decompressor.info;
+    info.out_color_space = color_space;
+    info.scale_num = 1;
+    info.scale_denom = jpeg_scale_denominator(
+        info.image_width, info.image_height, new_width, new_height);
+    jpeg_checked(info, [&info]() { jpeg_start_decompress(&info); });
+
+    const std::size_t decoded_width = info.output_width;
+    const std::size_t decoded_height = info.output_height;
+    std::vector<JSAMPLE> samples(decoded_width * info.output_components);
+    JSAMPROW sample_row = samples.data();
+    blaze::DynamicVector<T, blaze::rowVector> row(decoded_width);
+    auto read_row = [&info, &sample_row, &samples, &row]() {
+        jpeg_checked(info, [&info, &sample_row]() { jpeg_read_scanlines(&info, &sample_row, 1); });
+        jpeg_row_to_vector(samples.data(), row);
+    };
+
+    blaze::DynamicMatrix<T> result(new_height, new_width);
+    if (decoded_width == new_width && decoded_height == new_height) {
+        for (std::size_t i = 0; i < decoded_height; ++i) {
+            read_row();
+            blaze::row(result, i) = row;
+        }
+    } else {
+        scanline_scaler<T, Method> scaler(
+            method, decoded_width, decoded_height, new_width, new_height, a);
+        auto sink = [&result](std::size_t target_row, const auto& target) {
+            blaze::row(result, target_row) = target;
+        };
+        while (info.output_scanline < info.output_height && !scaler.finished()) {
+            read_row();
+            scaler.push_row(row, sink);
+        }
+    }
+
+    if (info.output_scanline < info.output_height) {
+        // the rest of the image is not needed
+        jpeg_abort_decompress(&info);
+    } else {
+        jpeg_checked(info, [&info]() { jpeg_finish_decompress(&info); });
+    }
+
+    return result;
+}
+} // namespace detail
+
+/** \brief Decodes a JPEG file as grayscale at reduced resolution and scales it to the target size
+
+    libjpeg is asked to decode directly at 1/2, 1/4 or 1/8 resolution in the DCT domain, as far as
+    the target size allows, so most of the full resolution decode is skipped. The remaining
+    ratio is handled by `scanline_scaler` while scanlines are being decoded, thus the decoded
+    image is never stored in full.
+
+    \tparam Method One of `nearest_neighbor`, `bilinear_interpolation` or `lanczos_method`
+    \arg path The path to JPEG file
+    \arg new_width The width of the result
+    \arg new_height The height of the result
+    \arg a The Lanczos window size, ignored by other methods
+
+    \return A `DynamicMatrix<std::uint8_t>` of `new_height` rows and `new_width` columns
+*/
+template <typename Method = lanczos_method>
+blaze::DynamicMatrix<std::uint8_t> read_jpeg_scaled(const std::string& path,
+                                                    std::size_t new_width,
+                                                    std::size_t new_height, Method method = {},
+                                                    signed_size a = 3)
+{
+    return detail::read_jpeg_scaled<std::uint8_t>(
+        path, JCS_GRAYSCALE, new_width, new_height, method, a);
+}
+
+/** \brief Decodes a JPEG file as RGB at reduced resolution and scales it to the target size
+
+    Same as `read_jpeg_scaled`, but keeps colors.
+
+    \return A `DynamicMatrix<StaticVector<std::uint8_t, 3>>` of `new_height` rows and
+    `new_width` columns, channels are in RGB order
+*/
+template <typename Method = lanczos_method>
+blaze::DynamicMatrix<blaze::StaticVector<std::uint8_t, 3>>
+read_jpeg_scaled_channeled(const std::string& path, std::size_t new_width, std::size_t new_height,
+                           Method method = {}, signed_size a = 3)
+{
+    return detail::read_jpeg_scaled<blaze::StaticVector<std::uint8_t, 3>>(
+        path, JCS_RGB, new_width, new_height, method, a);
+}
+} // namespace flash
+
+#endif
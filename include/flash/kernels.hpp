@@ -0,0 +1,126 @@
+#ifndef BLAZING_GIL_KERNELS_HPP
+#define BLAZING_GIL_KERNELS_HPP
+
+/* Explicit instantiation declarations of the most common kernels, which are compiled once into
+   the blazing-gil-kernels library instead of in every translation unit using them. Include this
+   header instead of (or in addition to) the individual headers and link blazing-gil::kernels.
+   Other types keep being instantiated from the header templates as usual.
+
+   src/kernels.cpp defines FLASH_KERNELS_EXTERN as empty before including this header, which
+   turns the declarations below into the explicit instantiation definitions.
+
+   Functions returning `auto` (`convolve`, `to_matrix_channeled`, `anisotropic_diffusion`) have
+   to be instantiated wherever they are called to deduce their type, the declarations thus name
+   the `void` or reference returning functions doing their work.
+*/
+#ifndef FLASH_KERNELS_EXTERN
+#define FLASH_KERNELS_EXTERN extern
+#endif
+
+#include <blaze/Blaze.h>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+
+#include <flash/conversion.hpp>
+#include <flash/convolution.hpp>
+#include <flash/core.hpp>
+#include <flash/numeric.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flash
+{
+namespace kernel_types
+{
+using sobel_type = blaze::StaticMatrix<std::int16_t, 3, 3>;
+using rgb8_vector = blaze::StaticVector<std::uint8_t, 3>;
+using rgb_double_vector = blaze::StaticVector<double, 3>;
+
+template <typename T>
+using matrix = blaze::DynamicMatrix<T>;
+
+template <typename T>
+using dense = blaze::DenseMatrix<matrix<T>, blaze::rowMajor>;
+} // namespace kernel_types
+
+// to_matrix of 8 bit views, `view` is passed by value
+FLASH_KERNELS_EXTERN template void to_matrix(boost::gil::gray8_view_t,
+                                             kernel_types::dense<std::uint8_t>&, std::size_t);
+FLASH_KERNELS_EXTERN template void to_matrix(boost::gil::gray8c_view_t,
+                                             kernel_types::dense<std::uint8_t>&, std::size_t);
+FLASH_KERNELS_EXTERN template void to_matrix(boost::gil::rgb8_view_t,
+                                             kernel_types::dense<std::uint8_t>&, std::size_t);
+FLASH_KERNELS_EXTERN template void to_matrix(boost::gil::rgb8c_view_t,
+                                             kernel_types::dense<std::uint8_t>&, std::size_t);
+
+// from_matrix into new 8 bit images
+FLASH_KERNELS_EXTERN template boost::gil::gray8_image_t
+from_matrix<boost::gil::gray8_image_t>(const kernel_types::dense<std::uint8_t>&,
+                                       truncate_conversion);
+FLASH_KERNELS_EXTERN template boost::gil::gray8_image_t
+from_matrix<boost::gil::gray8_image_t>(const kernel_types::dense<std::int16_t>&,
+                                       saturate_round_conversion);
+FLASH_KERNELS_EXTERN template boost::gil::gray8_image_t
+from_matrix<boost::gil::gray8_image_t>(const kernel_types::dense<std::int32_t>&,
+                                       saturate_round_conversion);
+FLASH_KERNELS_EXTERN template boost::gil::gray8_image_t
+from_matrix<boost::gil::gray8_image_t>(const kernel_types::dense<float>&,
+                                       saturate_round_conversion);
+FLASH_KERNELS_EXTERN template boost::gil::gray8_image_t
+from_matrix<boost::gil::gray8_image_t>(const kernel_types::dense<double>&,
+                                       saturate_round_conversion);
+FLASH_KERNELS_EXTERN template boost::gil::rgb8_image_t
+from_matrix<boost::gil::rgb8_image_t>(const kernel_types::dense<kernel_types::rgb8_vector>&,
+                                      truncate_conversion);
+FLASH_KERNELS_EXTERN template boost::gil::rgb8_image_t
+from_matrix<boost::gil::rgb8_image_t>(const kernel_types::dense<kernel_types::rgb_double_vector>&,
+                                      saturate_round_conversion);
+
+namespace detail
+{
+// the row loop of to_matrix_channeled
+FLASH_KERNELS_EXTERN template void
+pixels_to_vectors<3>(const boost::gil::rgb8_view_t&, signed_size, kernel_types::rgb8_vector*);
+FLASH_KERNELS_EXTERN template void
+pixels_to_vectors<3>(const boost::gil::rgb8c_view_t&, signed_size, kernel_types::rgb8_vector*);
+
+// the loops of convolve with the Sobel kernels, including the widening ones of harris
+FLASH_KERNELS_EXTERN template void
+convolve_into(const kernel_types::dense<std::uint8_t>&, const kernel_types::sobel_type&,
+              kernel_types::matrix<std::int16_t>&);
+FLASH_KERNELS_EXTERN template void
+convolve_into(const kernel_types::dense<std::int16_t>&, const kernel_types::sobel_type&,
+              kernel_types::matrix<std::int16_t>&);
+FLASH_KERNELS_EXTERN template void
+convolve_into(const kernel_types::dense<std::int32_t>&, const kernel_types::sobel_type&,
+              kernel_types::matrix<std::int32_t>&);
+FLASH_KERNELS_EXTERN template void
+convolve_into(const kernel_types::dense<float>&, const kernel_types::sobel_type&,
+              kernel_types::matrix<float>&);
+FLASH_KERNELS_EXTERN template void
+convolve_into(const kernel_types::dense<double>&, const kernel_types::sobel_type&,
+              kernel_types::matrix<double>&);
+
+// the iterations of anisotropic_diffusion, in double and in float storage
+FLASH_KERNELS_EXTERN template kernel_types::matrix<double>&
+diffuse(const kernel_types::dense<std::uint8_t>&, kernel_types::matrix<double>&,
+        kernel_types::matrix<double>&, kernel_types::matrix<double>&, double, double,
+        std::uint64_t);
+FLASH_KERNELS_EXTERN template kernel_types::matrix<double>&
+diffuse(const kernel_types::dense<double>&, kernel_types::matrix<double>&,
+        kernel_types::matrix<double>&, kernel_types::matrix<double>&, double, double,
+        std::uint64_t);
+FLASH_KERNELS_EXTERN template kernel_types::matrix<float>&
+diffuse(const kernel_types::dense<float>&, kernel_types::matrix<float>&,
+        kernel_types::matrix<float>&, kernel_types::matrix<float>&, double, double,
+        std::uint64_t);
+FLASH_KERNELS_EXTERN template kernel_types::matrix<kernel_types::rgb_double_vector>&
+diffuse(const kernel_types::dense<kernel_types::rgb8_vector>&,
+        kernel_types::matrix<kernel_types::rgb_double_vector>&,
+        kernel_types::matrix<kernel_types::rgb_double_vector>&,
+        kernel_types::matrix<kernel_types::rgb_double_vector>&, double, double, std::uint64_t);
+} // namespace detail
+} // namespace flash
+
+#endif
@@ -0,0 +1,285 @@
+#ifndef BLAZING_GIL_LUT_HPP
+#define BLAZING_GIL_LUT_HPP
+
+#include <blaze/Blaze.h>
+#include <blaze/math/typetraits/IsDenseVector.h>
+
+#include <flash/core.hpp>
+#include <flash/planar.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace flash
+{
+/** \brief Precomputed values of a function over the full domain of 8 or 16 bit unsigned keys
+
+    Per pixel maps over small domains, like gamma correction, tone curves, thresholds or
+    equalization, are evaluated once per possible value instead of once per pixel, and applied
+    with `apply_lut`, which uses SIMD table lookups where available.
+
+    \tparam T The key type, `std::uint8_t` or `std::uint16_t`
+    \tparam U The value type
+*/
+template <typename T, typename U>
+class lookup_table
+{
+  public:
+    static_assert(std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) <= 2,
+                  "lookup tables are supported for 8 and 16 bit unsigned keys");
+
+    using key_type = T;
+    using value_type = U;
+    static constexpr std::size_t size = std::size_t(std::numeric_limits<T>::max()) + 1;
+
+    /// evaluates `function(key)` for every key, converted to `U` with `static_cast`
+    template <typename Function,
+              typename = std::enable_if_t<std::is_invocable_v<const Function&, T>>>
+    explicit lookup_table(const Function& function) : table(size)
+    {
+        for (std::size_t key = 0; key < size; ++key) {
+            table[key] = static_cast<U>(function(static_cast<T>(key)));
+        }
+    }
+
+    /// adopts precomputed `values`, which must have exactly `size` elements
+    explicit lookup_table(std::vector<U> values) : table(std::move(values))
+    {
+        if (table.size() != size) {
+            throw std::invalid_argument("lookup table must have a value for every key");
+        }
+    }
+
+    U operator()(T key) const noexcept { return table[key]; }
+
+    const U* data() const noexcept { return table.data(); }
+
+  private:
+    std::vector<U> table;
+};
+
+/** \brief Lookup table of `function` over every value of `T`
+
+    \return `lookup_table<T, U>` with `U` the result type of `function`
+*/
+template <typename T, typename Function>
+auto make_lut(const Function& function)
+{
+    using value_type = remove_cvref_t<std::invoke_result_t<const Function&, T>>;
+    return lookup_table<T, value_type>(function);
+}
+
+namespace detail
+{
+#if defined(__SSSE3__)
+/* 256 entry byte tables do not fit into a single shuffle, which indexes 16 bytes. Keys are
+   split into the low nibble, used as shuffle index into each of the 16 slices of the table, and
+   the high nibble, which selects the slice whose result is kept.
+*/
+inline std::size_t lookup_bytes_ssse3(const std::uint8_t* source, std::uint8_t* target,
+                                       std::size_t count, const std::uint8_t* table)
+{
+    std::size_t j = 0;
+#if defined(__AVX2__)
+    __m256i slices256[16];
+    for (std::size_t slice = 0; slice < 16; ++slice) {
+        slices256[slice] = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + slice * 16)));
+    }
+    const auto low_mask256 = _mm256_set1_epi8(0x0f);
+    for (; j + 32 <= count; j += 32) {
+        const auto keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + j));
+        const auto low = _mm256_and_si256(keys, low_mask256);
+        const auto high = _mm256_and_si256(_mm256_srli_epi16(keys, 4), low_mask256);
+        auto result = _mm256_setzero_si256();
+        for (std::size_t slice = 0; slice < 16; ++slice) {
+            const auto selected =
+                _mm256_cmpeq_epi8(high, _mm256_set1_epi8(static_cast<char>(slice)));
+            const auto values = _mm256_shuffle_epi8(slices256[slice], low);
+            result = _mm256_or_si256(result, _mm256_and_si256(selected, values));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + j), result);
+    }
+#endif
+    __m128i slices[16];
+    for (std::size_t slice = 0; slice < 16; ++slice) {
+        slices[slice] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + slice * 16));
+    }
+    const auto low_mask = _mm_set1_epi8(0x0f);
+    for (; j + 16 <= count; j += 16) {
+        const auto keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + j));
+        const auto low = _mm_and_si128(keys, low_mask);
+        const auto high = _mm_and_si128(_mm_srli_epi16(keys, 4), low_mask);
+        auto result = _mm_setzero_si128();
+        for (std::size_t slice = 0; slice < 16; ++slice) {
+            const auto selected = _mm_cmpeq_epi8(high, _mm_set1_epi8(static_cast<char>(slice)));
+            const auto values = _mm_shuffle_epi8(slices[slice], low);
+            result = _mm_or_si128(result, _mm_and_si128(selected, values));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + j), result);
+    }
+    return j;
+}
+#endif
+
+#if defined(__AVX2__)
+/// gathers 8 values of 4 bytes at a time, keys are zero extended to 32 bit indices
+template <typename T, typename U>
+std::size_t lookup_gather_avx2(const T* source, U* target, std::size_t count, const U* table)
+{
+    const auto* base = reinterpret_cast<const int*>(table);
+    std::size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m256i indices;
+        if constexpr (sizeof(T) == 1) {
+            indices = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + j)));
+        } else {
+            indices = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + j)));
+        }
+        const auto values = _mm256_i32gather_epi32(base, indices, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + j), values);
+    }
+    return j;
+}
+#endif
+
+/// `target[j] = table[source[j]]` for a row of `count` keys
+template <typename T, typename U>
+void lookup_row(const T* source, U* target, std::size_t count, const U* table)
+{
+    std::size_t j = 0;
+#if defined(__SSSE3__)
+    if constexpr (sizeof(T) == 1 && sizeof(U) == 1 && std::is_integral_v<U>) {
+        j = lookup_bytes_ssse3(reinterpret_cast<const std::uint8_t*>(source),
+                               reinterpret_cast<std::uint8_t*>(target),
+                               count,
+                               reinterpret_cast<const std::uint8_t*>(table));
+    }
+#endif
+#if defined(__AVX2__)
+    if constexpr (sizeof(U) == 4 && std::is_trivially_copyable_v<U>) {
+        j = lookup_gather_avx2(source, target, count, table);
+    }
+#endif
+    for (; j < count; ++j) {
+        target[j] = table[source[j]];
+    }
+}
+
+template <typename T, typename U, typename MT, bool SO, typename Result>
+void apply_lut_into(const blaze::DenseMatrix<MT, SO>& source, const lookup_table<T, U>& lut,
+                    Result& result)
+{
+    if constexpr (is_row_contiguous_v<MT, SO>) {
+        for (std::size_t i = 0; i < (~source).rows(); ++i) {
+            lookup_row((~source).data(i), result.data(i), (~source).columns(), lut.data());
+        }
+    } else {
+        for (std::size_t i = 0; i < (~source).rows(); ++i) {
+            for (std::size_t j = 0; j < (~source).columns(); ++j) {
+                result(i, j) = lut((~source)(i, j));
+            }
+        }
+    }
+}
+} // namespace detail
+
+/** \brief Maps every element of a matrix through `lut`
+
+    Rows of scalar matrices are looked up with byte shuffles (SSSE3, AVX2) for 8 bit to 8 bit
+    tables and with gathers (AVX2) for 4 byte values, otherwise element by element. Matrices of
+    `StaticVector`s have every channel mapped through the same table.
+
+    \arg source Matrix of `T` or of `StaticVector<T, N>`
+    \return A `DynamicMatrix` of `U` or of `StaticVector<U, N>`, of the same storage order
+*/
+template <typename T, typename U, typename MT, bool SO>
+auto apply_lut(const blaze::DenseMatrix<MT, SO>& source, const lookup_table<T, U>& lut)
+{
+    using element_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    if constexpr (blaze::IsDenseVector_v<element_type>) {
+        static_assert(std::is_same_v<blaze::ElementType_t<element_type>, T>,
+                      "keys of the table must be channels of matrix elements");
+        constexpr auto channels = element_type::size();
+        blaze::DynamicMatrix<blaze::StaticVector<U, channels>, SO> result((~source).rows(),
+                                                                           (~source).columns());
+        for (std::size_t i = 0; i < (~source).rows(); ++i) {
+            for (std::size_t j = 0; j < (~source).columns(); ++j) {
+                const auto& keys = (~source)(i, j);
+                for (std::size_t channel = 0; channel < channels; ++channel) {
+                    result(i, j)[channel] = lut(keys[channel]);
+                }
+            }
+        }
+        return result;
+    } else {
+        static_assert(std::is_same_v<element_type, T>, "keys of the table must be matrix elements");
+        blaze::DynamicMatrix<U, SO> result((~source).rows(), (~source).columns());
+        detail::apply_lut_into(source, lut, result);
+        return result;
+    }
+}
+
+/** \brief Maps every channel of a matrix of `StaticVector`s through its own table
+
+    \arg luts One table per channel
+    \return A `DynamicMatrix<StaticVector<U, N>>`
+*/
+template <typename T, typename U, std::size_t N, typename MT, bool SO>
+auto apply_lut(const blaze::DenseMatrix<MT, SO>& source,
+               const std::array<lookup_table<T, U>, N>& luts)
+{
+    using vector_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    static_assert(blaze::IsDenseVector_v<vector_type> && vector_type::size() == N,
+                  "there must be a table for every channel");
+
+    blaze::DynamicMatrix<blaze::StaticVector<U, N>, SO> result((~source).rows(),
+                                                                (~source).columns());
+    for (std::size_t i = 0; i < (~source).rows(); ++i) {
+        for (std::size_t j = 0; j < (~source).columns(); ++j) {
+            const auto& keys = (~source)(i, j);
+            for (std::size_t channel = 0; channel < N; ++channel) {
+                result(i, j)[channel] = luts[channel](keys[channel]);
+            }
+        }
+    }
+    return result;
+}
+
+/// Maps every channel of a planar matrix through its own table, plane by plane
+template <typename T, typename U, std::size_t N>
+planar_matrix<U, N> apply_lut(const planar_matrix<T, N>& source,
+                              const std::array<lookup_table<T, U>, N>& luts)
+{
+    planar_matrix<U, N> result(source.rows(), source.columns());
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        detail::apply_lut_into(source.plane(channel), luts[channel], result.plane(channel));
+    }
+    return result;
+}
+
+/// Maps every channel of a planar matrix through the same table
+template <typename T, typename U, std::size_t N>
+planar_matrix<U, N> apply_lut(const planar_matrix<T, N>& source, const lookup_table<T, U>& lut)
+{
+    planar_matrix<U, N> result(source.rows(), source.columns());
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        detail::apply_lut_into(source.plane(channel), lut, result.plane(channel));
+    }
+    return result;
+}
+} // namespace flash
+
+#endif
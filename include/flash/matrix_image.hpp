@@ -0,0 +1,187 @@
+#ifndef BLAZING_GIL_MATRIX_IMAGE_HPP
+#define BLAZING_GIL_MATRIX_IMAGE_HPP
+
+#include <blaze/Blaze.h>
+#include <blaze/math/typetraits/IsContiguous.h>
+#include <blaze/math/typetraits/IsVector.h>
+
+#include <flash/core.hpp>
+
+#include <boost/gil/device_n.hpp>
+#include <boost/gil/gray.hpp>
+#include <boost/gil/image_view_factory.hpp>
+#include <boost/gil/pixel.hpp>
+#include <boost/gil/rgb.hpp>
+#include <boost/gil/rgba.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace flash
+{
+namespace detail
+{
+/// inverse of `true_channel_type`, floating point channels get GIL's scoped types
+template <typename T>
+struct gil_channel_type {
+    using type = T;
+};
+
+template <>
+struct gil_channel_type<float> {
+    using type = boost::gil::float32_t;
+};
+
+template <>
+struct gil_channel_type<double> {
+    using type = boost::gil::float64_t;
+};
+
+template <typename T>
+using gil_channel_type_t = typename gil_channel_type<T>::type;
+
+template <std::size_t N>
+struct default_layout {
+    using type = boost::gil::devicen_layout_t<static_cast<int>(N)>;
+};
+
+template <>
+struct default_layout<1> {
+    using type = boost::gil::gray_layout_t;
+};
+
+template <>
+struct default_layout<3> {
+    using type = boost::gil::rgb_layout_t;
+};
+
+template <>
+struct default_layout<4> {
+    using type = boost::gil::rgba_layout_t;
+};
+
+template <typename Element>
+auto matrix_pixel()
+{
+    if constexpr (blaze::IsVector_v<Element>) {
+        using channel_t = gil_channel_type_t<blaze::ElementType_t<Element>>;
+        return boost::gil::pixel<channel_t, typename default_layout<Element::size()>::type>{};
+    } else {
+        return boost::gil::pixel<gil_channel_type_t<Element>, boost::gil::gray_layout_t>{};
+    }
+}
+
+/// GIL pixel of the same layout as a matrix element, gray for scalars, rgb for 3 channels etc.
+template <typename Element>
+using matrix_pixel_t = decltype(matrix_pixel<std::remove_const_t<Element>>());
+
+template <typename Element>
+auto as_view(Element* data, std::size_t rows, std::size_t columns, std::size_t spacing)
+{
+    using pixel_t = matrix_pixel_t<Element>;
+    static_assert(sizeof(pixel_t) == sizeof(Element),
+                  "The function is made to believe that pixel and corresponding element types are"
+                  "layout compatible, but they are not");
+    using pointer = std::conditional_t<std::is_const_v<Element>, const pixel_t*, pixel_t*>;
+    return boost::gil::interleaved_view(columns,
+                                        rows,
+                                        reinterpret_cast<pointer>(data),
+                                        static_cast<std::ptrdiff_t>(spacing * sizeof(Element)));
+}
+} // namespace detail
+
+/** \brief constructs GIL image view out of a row major matrix, the reverse of `as_matrix`
+
+    The view is semantically like pointer, changes in the view are reflected in the matrix and
+    vice versa. Rows of the view are `spacing()` elements apart, so padded and aligned matrices
+    and submatrices of them are viewed without copying. The result can be passed to
+    `gil::write_view` to save the matrix directly.
+
+    Scalar elements give gray pixels, `StaticVector<T, N>` give gray, rgb or rgba pixels for 1, 3
+    and 4 channels and `devicen` pixels otherwise. `float` and `double` become GIL's scoped
+    `float32_t` and `float64_t` channels. As with `as_matrix_channeled`, vectors must be unpadded
+    to be layout compatible with pixels.
+
+    \arg matrix A row major matrix with contiguous rows, e.g. `DynamicMatrix`, `CustomMatrix`
+    \return A view of mutable pixels, or of const pixels for const matrices
+*/
+template <typename MT>
+auto as_view(blaze::DenseMatrix<MT, blaze::rowMajor>& matrix)
+{
+    static_assert(blaze::IsContiguous_v<MT>, "only matrices with contiguous rows can be viewed");
+    return detail::as_view((~matrix).data(), (~matrix).rows(), (~matrix).columns(),
+                           (~matrix).spacing());
+}
+
+template <typename MT>
+auto as_view(const blaze::DenseMatrix<MT, blaze::rowMajor>& matrix)
+{
+    static_assert(blaze::IsContiguous_v<MT>, "only matrices with contiguous rows can be viewed");
+    return detail::as_view((~matrix).data(), (~matrix).rows(), (~matrix).columns(),
+                           (~matrix).spacing());
+}
+
+/** \brief Image that owns a `DynamicMatrix` and exposes it as GIL views
+
+    `gil::image` always allocates its own buffer, this type adopts the buffer of a matrix moved
+    into it instead, so results of a computation can be kept, passed around and written as an
+    image without copying a single pixel. The matrix can be moved back out with `release`.
+
+    \tparam Element The element type of the matrix, a scalar or unpadded `StaticVector`
+*/
+template <typename Element>
+class matrix_image
+{
+  public:
+    using matrix_type = blaze::DynamicMatrix<Element, blaze::rowMajor>;
+    using view_t = decltype(as_view(std::declval<matrix_type&>()));
+    using const_view_t = decltype(as_view(std::declval<const matrix_type&>()));
+
+    matrix_image() = default;
+
+    /// creates `width` by `height` image of zero initialized pixels
+    matrix_image(std::size_t width, std::size_t height) : data(height, width, Element{}) {}
+
+    explicit matrix_image(matrix_type&& source) noexcept : data(std::move(source)) {}
+
+    std::size_t width() const noexcept { return data.columns(); }
+    std::size_t height() const noexcept { return data.rows(); }
+
+    view_t view() { return as_view(data); }
+    const_view_t view() const { return as_view(data); }
+    const_view_t const_view() const { return as_view(data); }
+
+    matrix_type& matrix() noexcept { return data; }
+    const matrix_type& matrix() const noexcept { return data; }
+
+    /// moves the matrix out, the image is left empty
+    matrix_type release() noexcept
+    {
+        matrix_type result(std::move(data));
+        data = matrix_type();
+        return result;
+    }
+
+  private:
+    matrix_type data;
+};
+
+template <typename Element>
+matrix_image(blaze::DynamicMatrix<Element, blaze::rowMajor>&&) -> matrix_image<Element>;
+
+/// GIL style accessors, so that `flash::view(image)` reads like `gil::view(image)`
+template <typename Element>
+auto view(matrix_image<Element>& image)
+{
+    return image.view();
+}
+
+template <typename Element>
+auto const_view(const matrix_image<Element>& image)
+{
+    return image.const_view();
+}
+} // namespace flash
+
+#endif
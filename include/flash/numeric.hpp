@@ -6,14 +6,22 @@
 #include <blaze/math/typetraits/IsVector.h>
 #include <blaze/math/typetraits/UnderlyingElement.h>
 #include <blaze/math/views/Submatrix.h>
+#include <flash/bitmask.hpp>
 #include <flash/convolution.hpp>
+#include <flash/half.hpp>
+#include <flash/range.hpp>
+#include <flash/transpose.hpp>
+#include <flash/workspace.hpp>
 
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <type_traits>
+#include <utility>
 
 namespace flash
 {
@@ -24,77 +32,243 @@ auto compute_diffusivity(Expr& nabla, double kappa)
 {
     return blaze::exp(-(nabla / kappa) % (nabla / kappa));
 }
+
+/// number of channels of a matrix element, 1 for scalars
+template <typename T>
+constexpr std::size_t channel_count()
+{
+    if constexpr (blaze::IsVector_v<T>) {
+        return T::size();
+    } else {
+        return 1;
+    }
+}
+} // namespace detail
+
+namespace detail
+{
+/// the criterion of `nonmax_map` for the window ending before `(i, j)`
+template <typename T>
+bool is_nonmax(const blaze::DynamicMatrix<T>& input, std::size_t i, std::size_t j,
+               std::size_t window_size)
+{
+    const auto middle = window_size / 2 + 1;
+    auto submatrix =
+        blaze::submatrix(input, i - window_size, j - window_size, window_size, window_size);
+    auto max = blaze::max(submatrix);
+    auto other_max_flag = false;
+    for (std::size_t ii = 0; ii < window_size; ++ii) {
+        for (std::size_t jj = 0; jj < window_size; ++jj) {
+            if (ii == middle && jj == middle) {
+                continue;
+            }
+            if (submatrix(ii, jj) == max) {
+                other_max_flag = true;
+                break;
+            }
+        }
+    }
+
+    return other_max_flag && (max == submatrix(middle, middle));
+}
 } // namespace detail
 
 template <typename T>
 blaze::DynamicMatrix<bool> nonmax_map(const blaze::DynamicMatrix<T>& input, std::size_t window_size,
                                       bool padding_value = false)
 {
-    const auto middle = window_size / 2 + 1;
     blaze::DynamicMatrix<bool> result(input.rows(), input.columns(), padding_value);
     // will substract window_size, thus until .rows()
     for (std::size_t i = window_size; i < input.rows(); ++i) {
         // will substract window_size, thus until .columns()
         for (std::size_t j = window_size; j < input.columns(); ++j) {
-            auto submatrix =
-                blaze::submatrix(input, i - window_size, j - window_size, window_size, window_size);
-            auto max = blaze::max(submatrix);
-            auto other_max_flag = false;
-            for (std::size_t ii = 0; ii < window_size; ++ii) {
-                for (std::size_t jj = 0; jj < window_size; ++jj) {
-                    if (ii == middle && jj == middle) {
-                        continue;
-                    }
-                    if (submatrix(ii, jj) == max) {
-                        other_max_flag = true;
-                        break;
-                    }
-                }
-            }
-
-            result(i, j) = other_max_flag && (max == submatrix(middle, middle));
+            result(i, j) = detail::is_nonmax(input, i, j, window_size);
         }
     }
 
     return result;
 }
 
-blaze::DynamicMatrix<std::int64_t> harris(const blaze::DynamicMatrix<std::int64_t>& image, double k)
+/** \brief Same as `nonmax_map`, but packed into a `bitmask`
+
+    Masks of several detectors can then be combined with `&` and `|` 64 pixels at a time, and
+    the marked pixels visited with `bitmask::for_each_set`.
+*/
+template <typename T>
+bitmask nonmax_mask(const blaze::DynamicMatrix<T>& input, std::size_t window_size,
+                    bool padding_value = false)
 {
-    auto dx = flash::convolve(image, flash::sobel_x);
-    auto dy = flash::convolve(image, flash::sobel_y);
+    bitmask result(input.rows(), input.columns(), padding_value);
+    for (std::size_t i = window_size; i < input.rows(); ++i) {
+        for (std::size_t j = window_size; j < input.columns(); ++j) {
+            result.set(i, j, detail::is_nonmax(input, i, j, window_size));
+        }
+    }
 
-    auto dx_2 = dx % dx;
-    auto dy_2 = dy % dy;
+    return result;
+}
 
-    auto dxdy = flash::convolve(dx, flash::sobel_y);
+namespace detail
+{
+/// the returned expression references the gradients, it must be evaluated while they live
+template <typename Response, typename Gradient, typename MixedGradient>
+auto harris_response(const Gradient& dx, const Gradient& dy, const MixedGradient& dxdy, double k)
+{
+    auto widen = [](const auto& x) { return static_cast<Response>(x); };
+    auto dx_2 = blaze::map(dx, widen) % blaze::map(dx, widen);
+    auto dy_2 = blaze::map(dy, widen) % blaze::map(dy, widen);
+    auto dxdy_2 = blaze::map(dxdy, widen) % blaze::map(dxdy, widen);
 
     auto ktrace_2 = (dx_2 + dy_2) % (dx_2 + dy_2) * k;
-    auto det = dx_2 % dy_2 - dxdy % dxdy;
+    auto det = dx_2 % dy_2 - dxdy_2;
     return det - ktrace_2;
 }
 
+/** \brief Worst case ranges and the narrowest types of the Harris detector on `Input` elements
+
+    The response is `det - k * trace^2` with `det = dx^2 dy^2 - dxdy^2`, as `k` is a runtime
+    value only its integral part, `det`, is analysed, `k * trace^2` is computed in `double`.
+*/
+template <typename Input>
+struct harris_types {
+    static constexpr value_range gradient =
+        convolved_range(integral_range_of<Input>(), sobel_x_coefficients);
+    static constexpr value_range mixed = convolved_range(gradient, sobel_y_coefficients);
+    static constexpr value_range squared = gradient * gradient;
+    static constexpr value_range determinant = squared * squared - mixed * mixed;
+
+    using gradient_type = range_accumulator_t<Input, accumulator_index(gradient)>;
+    using mixed_type = range_accumulator_t<Input, accumulator_index(mixed)>;
+    using response_type =
+        std::conditional_t<std::is_floating_point_v<Input>, double,
+                           accumulator_type_t<accumulator_index(determinant)>>;
+};
+
+template <typename Input>
+struct hessian_types {
+    static constexpr value_range gradient =
+        convolved_range(integral_range_of<Input>(), sobel_x_coefficients);
+    static constexpr value_range second = convolved_range(gradient, sobel_x_coefficients);
+    static constexpr value_range determinant = second * second - second * second;
+    static constexpr value_range trace = second + second;
+
+    using gradient_type = range_accumulator_t<Input, accumulator_index(gradient)>;
+    using second_type = range_accumulator_t<Input, accumulator_index(second)>;
+};
+
+/// the second derivatives are widened to `std::int32_t` before multiplying
+template <typename Second, typename Result>
+void hessian_response_into(const Second& ddxx, const Second& dxdy, const Second& ddyy,
+                           Result& determinants, Result& traces)
+{
+    auto widen = [](const auto& x) { return static_cast<std::int32_t>(x); };
+    determinants = blaze::map(ddxx, widen) % blaze::map(ddyy, widen) -
+                   blaze::map(dxdy, widen) % blaze::map(dxdy, widen);
+    traces = blaze::map(ddxx, widen) + blaze::map(ddyy, widen);
+}
+} // namespace detail
+
+/** \brief Harris corner response of a scalar matrix
+
+    Gradients are stored in the narrowest type that cannot overflow for the element type of
+    `image` (see `convolved_range`), e.g. `std::int16_t` for `std::uint8_t` images, and the
+    response in the narrowest type holding its integral part, `std::int64_t` for them. Inputs
+    whose response exceeds 64 bits, like `std::int64_t` images, are computed in `double`.
+    Floating point images keep their type for the gradients.
+
+    \return A `DynamicMatrix` of `detail::harris_types<Element>::response_type`
+*/
+template <typename MT, bool SO>
+auto harris(const blaze::DenseMatrix<MT, SO>& image, double k)
+{
+    using types = detail::harris_types<blaze::ElementType_t<MT>>;
+    using response_type = typename types::response_type;
+
+    auto dx = flash::convolve<typename types::gradient_type>(~image, flash::sobel_x);
+    auto dy = flash::convolve<typename types::gradient_type>(~image, flash::sobel_y);
+    auto dxdy = flash::convolve<typename types::mixed_type>(dx, flash::sobel_y);
+
+    return blaze::DynamicMatrix<response_type>(
+        detail::harris_response<response_type>(dx, dy, dxdy, k));
+}
+
+/** \brief Same as `harris`, but the gradients and the response are taken from `arena`
+
+    \return A `workspace::matrix_type`, valid until `arena` is reset
+*/
+template <typename MT, bool SO>
+auto harris(const blaze::DenseMatrix<MT, SO>& image, double k, workspace& arena)
+{
+    using types = detail::harris_types<blaze::ElementType_t<MT>>;
+    using response_type = typename types::response_type;
+
+    auto dx = flash::convolve<typename types::gradient_type>(~image, flash::sobel_x, arena);
+    auto dy = flash::convolve<typename types::gradient_type>(~image, flash::sobel_y, arena);
+    auto dxdy = flash::convolve<typename types::mixed_type>(dx, flash::sobel_y, arena);
+
+    auto result = arena.matrix<response_type>((~image).rows(), (~image).columns());
+    result = detail::harris_response<response_type>(dx, dy, dxdy, k);
+    return result;
+}
+
 struct hessian_result {
     blaze::DynamicMatrix<std::int32_t> determinants;
     blaze::DynamicMatrix<std::int32_t> traces;
 };
 
-hessian_result hessian(const blaze::DynamicMatrix<std::uint8_t>& input)
+/** \brief Determinants and traces of the Hessian of an 8 bit image
+
+    First derivatives and second derivatives both fit into `std::int16_t`, which is what they
+    are computed in, only the determinant needs 32 bits.
+*/
+inline hessian_result hessian(const blaze::DynamicMatrix<std::uint8_t>& input)
+{
+    using types = detail::hessian_types<std::uint8_t>;
+    using gradient_type = typename types::gradient_type;
+    using second_type = typename types::second_type;
+    static_assert(holds<std::int32_t>(types::determinant) && holds<std::int32_t>(types::trace),
+                  "hessian_result cannot hold the determinants or traces");
+
+    auto dx = flash::convolve<gradient_type>(input, flash::sobel_x);
+    auto dy = flash::convolve<gradient_type>(input, flash::sobel_y);
+
+    auto ddxx = flash::convolve<second_type>(dx, flash::sobel_x);
+    auto dxdy = flash::convolve<second_type>(dx, flash::sobel_y);
+    auto ddyy = flash::convolve<second_type>(dy, flash::sobel_y);
+
+    hessian_result result;
+    detail::hessian_response_into(ddxx, dxdy, ddyy, result.determinants, result.traces);
+    return result;
+}
+
+/// `hessian_result` with matrices taken from a `workspace`, valid until it is reset
+struct hessian_workspace_result {
+    workspace::matrix_type<std::int32_t> determinants;
+    workspace::matrix_type<std::int32_t> traces;
+};
+
+/// same as above with the derivatives, determinants and traces taken from `arena`
+inline hessian_workspace_result hessian(const blaze::DynamicMatrix<std::uint8_t>& input,
+                                        workspace& arena)
 {
-    blaze::DynamicMatrix<std::int32_t> extended = input;
-    auto dx = flash::convolve(extended, flash::sobel_x);
-    auto dy = flash::convolve(extended, flash::sobel_y);
+    using types = detail::hessian_types<std::uint8_t>;
+    using gradient_type = typename types::gradient_type;
+    using second_type = typename types::second_type;
 
-    auto ddxx = flash::convolve(dx, flash::sobel_x);
-    auto dxdy = flash::convolve(dx, flash::sobel_y);
-    auto ddyy = flash::convolve(dy, flash::sobel_y);
+    auto dx = flash::convolve<gradient_type>(input, flash::sobel_x, arena);
+    auto dy = flash::convolve<gradient_type>(input, flash::sobel_y, arena);
 
-    auto det = ddxx % ddyy - dxdy % dxdy;
-    auto trace = ddxx + ddyy;
-    return {det, trace};
+    auto ddxx = flash::convolve<second_type>(dx, flash::sobel_x, arena);
+    auto dxdy = flash::convolve<second_type>(dx, flash::sobel_y, arena);
+    auto ddyy = flash::convolve<second_type>(dy, flash::sobel_y, arena);
+
+    hessian_workspace_result result{arena.matrix<std::int32_t>(input.rows(), input.columns()),
+                                    arena.matrix<std::int32_t>(input.rows(), input.columns())};
+    detail::hessian_response_into(ddxx, dxdy, ddyy, result.determinants, result.traces);
+    return result;
 }
 
-std::vector<double> build_exponent_table(unsigned int channel_count, double sigma)
+inline std::vector<double> build_exponent_table(unsigned int channel_count, double sigma)
 {
     const double sigma_squared = 1.0 / (sigma * sigma);
     std::vector<double> exponent_table(255 * channel_count);
@@ -107,66 +281,223 @@ std::vector<double> build_exponent_table(unsigned int channel_count, double sigm
     return exponent_table;
 }
 
+namespace detail
+{
+/** \brief Diffuses `input` in place of `current`, using `next` as scratch
+
+    Both buffers must have the dimensions of `input`, they are swapped every iteration. Rows are
+    converted from the storage type of the buffers into the compute type (see `compute_type_t`)
+    once when loaded and once when stored, `row_buffers` holds the three input rows and the
+    output row in the compute type. The replicated border is handled by clamping indices into
+    these rows, no padding is materialized.
+
+    \arg row_buffers Row major matrix of the compute type, at least 4 by the columns of `input`
+    \return The buffer holding the result, either `current` or `next`
+*/
+template <typename MT, bool SO, typename Buffer, typename RowBuffers>
+Buffer& diffuse(const blaze::DenseMatrix<MT, SO>& input, Buffer& current, Buffer& next,
+                RowBuffers& row_buffers, double delta_t, double kappa,
+                std::uint64_t iteration_count)
+{
+    using storage_type = blaze::ElementType_t<Buffer>;
+    using compute_element = compute_type_t<storage_type>;
+    using scalar_type = blaze::UnderlyingElement_t<compute_element>;
+
+    const auto rows = (~input).rows();
+    const auto columns = (~input).columns();
+    current = ~input;
+    if (rows == 0 || columns == 0) {
+        return current;
+    }
+
+    const auto inverse_kappa = static_cast<scalar_type>(1 / kappa);
+    const auto step = static_cast<scalar_type>(delta_t);
+    auto flux = [inverse_kappa](const compute_element& difference) {
+        // std::exp for scalar elements, blaze::exp through ADL for vectors
+        using std::exp;
+        const compute_element scaled = difference * inverse_kappa;
+        return compute_element(difference * exp(-(scaled * scaled)));
+    };
+    auto update = [&flux, step](const compute_element& center, const compute_element& up,
+                                const compute_element& down, const compute_element& left,
+                                const compute_element& right) {
+        return compute_element(
+            center +
+            (flux(up - center) + flux(down - center) + flux(left - center) + flux(right - center)) *
+                step);
+    };
+
+    auto load = [columns](const Buffer& matrix, std::size_t i, compute_element* row) {
+        if constexpr (blaze::IsRowMajorMatrix_v<Buffer> && blaze::IsContiguous_v<Buffer>) {
+            convert_row(matrix.data(i), row, columns);
+        } else {
+            for (std::size_t j = 0; j < columns; ++j) {
+                row[j] = convert_element<compute_element>(matrix(i, j));
+            }
+        }
+    };
+    auto store = [columns](const compute_element* row, Buffer& matrix, std::size_t i) {
+        if constexpr (blaze::IsRowMajorMatrix_v<Buffer> && blaze::IsContiguous_v<Buffer>) {
+            convert_row(row, matrix.data(i), columns);
+        } else {
+            for (std::size_t j = 0; j < columns; ++j) {
+                matrix(i, j) = convert_element<storage_type>(row[j]);
+            }
+        }
+    };
+
+    const auto last = columns - 1;
+    // swapping pointers, as swapping CustomMatrix objects through std::swap copies elements
+    Buffer* source = &current;
+    Buffer* target = &next;
+    for (std::uint64_t counter = 0; counter < iteration_count; ++counter) {
+        auto& from = *source;
+        auto& to = *target;
+        compute_element* above = row_buffers.data(0);
+        compute_element* middle = row_buffers.data(1);
+        compute_element* below = row_buffers.data(2);
+        compute_element* result = row_buffers.data(3);
+
+        load(from, 0, middle);
+        std::copy_n(middle, columns, above);
+        for (std::size_t i = 0; i < rows; ++i) {
+            if (i + 1 < rows) {
+                load(from, i + 1, below);
+            } else {
+                std::copy_n(middle, columns, below);
+            }
+
+            result[0] = update(middle[0], above[0], below[0], middle[0], middle[last > 0 ? 1 : 0]);
+            for (std::size_t j = 1; j < last; ++j) {
+                result[j] = update(middle[j], above[j], below[j], middle[j - 1], middle[j + 1]);
+            }
+            if (last > 0) {
+                result[last] =
+                    update(middle[last], above[last], below[last], middle[last - 1], middle[last]);
+            }
+            store(result, to, i);
+
+            std::swap(above, middle);
+            std::swap(middle, below);
+        }
+        std::swap(source, target);
+    }
+
+    return *source;
+}
+
+template <typename MT, typename Storage>
+using diffusion_element_t = std::conditional_t<
+    blaze::IsVector_v<blaze::UnderlyingElement_t<MT>>,
+    blaze::StaticVector<Storage, channel_count<blaze::UnderlyingElement_t<MT>>()>, Storage>;
+} // namespace detail
+
+/** \brief Perona-Malik anisotropic diffusion with exponential diffusivity
+
+    Every iteration moves each element towards its four neighbours, weighted by
+    `exp(-(difference / kappa)^2)`, so that edges are preserved while flat regions are smoothed.
+    Matrices of vectors are diffused channel by channel. Borders replicate the edge elements.
+
+    \tparam Storage The element type of the intermediate and resulting matrices, `double` by
+    default. `float`, `float16` or `bfloat16` shrink the two image sized buffers to a half or a
+    quarter, arithmetic is then done in `float`, see `compute_type_t`.
+    \tparam OutputStorageOrder The storage order of the result, the one of `input` by default
+    \arg input The matrix to diffuse, scalar or `StaticVector` elements
+    \arg delta_t The time step of every iteration
+    \arg kappa The gradient magnitude considered an edge
+    \arg iteration_count The number of iterations
+
+    \return A `DynamicMatrix` of `Storage`, or of `StaticVector<Storage, N>` for vector elements
+*/
+template <typename Storage, typename MT, bool StorageOrder, bool OutputStorageOrder = StorageOrder>
+auto anisotropic_diffusion(const blaze::DenseMatrix<MT, StorageOrder>& input, double delta_t,
+                           double kappa, std::uint64_t iteration_count)
+{
+    using element_type = detail::diffusion_element_t<MT, Storage>;
+    using output_matrix_type = blaze::DynamicMatrix<element_type, OutputStorageOrder>;
+
+    if constexpr (StorageOrder == blaze::columnMajor) {
+        /* Columns would be loaded element by element. The four neighbour stencil and replicated
+           borders are symmetric, so the transpose is diffused instead, whose rows are these
+           columns. Both `trans` are layout preserving copies, no data is transposed.
+        */
+        const auto diffused =
+            anisotropic_diffusion<Storage>(blaze::trans(~input), delta_t, kappa, iteration_count);
+        if constexpr (OutputStorageOrder == blaze::columnMajor) {
+            return output_matrix_type(blaze::trans(diffused));
+        } else {
+            return flash::transpose(diffused);
+        }
+    } else {
+        using buffer_type = blaze::DynamicMatrix<element_type, blaze::rowMajor>;
+        buffer_type current((~input).rows(), (~input).columns());
+        buffer_type next((~input).rows(), (~input).columns());
+        blaze::DynamicMatrix<compute_type_t<element_type>> row_buffers(4, (~input).columns());
+        auto& diffused =
+            detail::diffuse(input, current, next, row_buffers, delta_t, kappa, iteration_count);
+        if constexpr (OutputStorageOrder == blaze::rowMajor) {
+            return output_matrix_type(std::move(diffused));
+        } else {
+            return to_storage_order<blaze::columnMajor>(diffused);
+        }
+    }
+}
+
 template <typename MT, bool StorageOrder, bool OutputStorageOrder = StorageOrder>
 auto anisotropic_diffusion(const blaze::DenseMatrix<MT, StorageOrder>& input, double delta_t,
                            double kappa, std::uint64_t iteration_count)
 {
-    using element_type = blaze::UnderlyingElement_t<MT>;
-    using output_element_type =
-        std::conditional_t<blaze::IsVector_v<element_type>,
-                           blaze::StaticVector<double, element_type::size()>,
-                           double>;
-    auto exponent_table =
-        build_exponent_table(element_type::size(), kappa * element_type::size() * 255.0);
-    spdlog::info("{}", fmt::join(exponent_table, ", "));
-    using compute_element_type = blaze::StaticVector<output_element_type, 8>;
-    using output_matrix_type = blaze::DynamicMatrix<output_element_type, OutputStorageOrder>;
+    return anisotropic_diffusion<double, MT, StorageOrder, OutputStorageOrder>(
+        input, delta_t, kappa, iteration_count);
+}
+
+/** \brief Same as `anisotropic_diffusion`, but all buffers are taken from `arena`
 
+    \return A `workspace::matrix_type`, valid until `arena` is reset
+*/
+template <typename Storage, typename MT, bool StorageOrder, bool OutputStorageOrder = StorageOrder>
+auto anisotropic_diffusion(const blaze::DenseMatrix<MT, StorageOrder>& input, double delta_t,
+                           double kappa, std::uint64_t iteration_count, workspace& arena)
+{
+    using element_type = detail::diffusion_element_t<MT, Storage>;
     const auto rows = (~input).rows();
     const auto columns = (~input).columns();
-    output_matrix_type scratch(rows + 2, columns + 2, output_element_type(0));
-    auto scratch_area = blaze::submatrix(scratch, 1, 1, rows, columns);
-    scratch_area = input;
 
-    output_matrix_type scratch2(rows + 2, columns + 2);
-    auto scratch_area2 = blaze::submatrix(scratch2, 1, 1, rows, columns);
-    for (std::uint64_t counter = 0; counter < iteration_count; ++counter) {
-        // borders
-        blaze::row(scratch, 0) = blaze::row(scratch, 1);
-        blaze::row(scratch, rows + 1) = blaze::row(scratch, rows);
-        blaze::column(scratch, 0) = blaze::column(scratch, 1);
-        blaze::column(scratch, columns + 1) = blaze::column(scratch, columns);
-
-        // corners
-        scratch(0, 0) = scratch(1, 1);
-        scratch(0, columns + 1) = scratch(0, columns);
-        scratch(rows + 1, 0) = scratch(rows, 0);
-        scratch(rows + 1, columns + 1) = scratch(rows, columns);
-
-        scratch_area2 = blaze::generate(
-            rows,
-            columns,
-            [&scratch, &exponent_table, kappa, delta_t](std::size_t absolute_i,
-                                                        std::size_t absolute_j) {
-                auto i = absolute_i + 1;
-                auto j = absolute_j + 1;
-                const auto& current = scratch(i, j);
-                compute_element_type nabla{scratch(i - 1, j) - current,
-                                           scratch(i + 1, j) - current,
-                                           scratch(i, j - 1) - current,
-                                           scratch(i, j + 1) - current};
-                compute_element_type diffusivity =
-                    blaze::map(nabla, [&exponent_table, kappa](auto value) {
-                        value /= kappa;
-                        return output_element_type(blaze::exp(-(value * value)));
-                    });
-
-                return blaze::evaluate(current + blaze::sum(nabla * diffusivity) * delta_t);
-            });
-        std::swap(scratch, scratch2);
+    if constexpr (StorageOrder == blaze::columnMajor) {
+        // diffused on the transpose as above, into a row major matrix of `columns` rows
+        auto diffused = anisotropic_diffusion<Storage>(
+            blaze::trans(~input), delta_t, kappa, iteration_count, arena);
+        if constexpr (OutputStorageOrder == blaze::columnMajor) {
+            // the rows of the transpose are the columns of the result, the memory is reused
+            return workspace::matrix_type<element_type, blaze::columnMajor>(
+                diffused.data(), rows, columns, diffused.spacing());
+        } else {
+            auto result = arena.matrix<element_type>(rows, columns);
+            detail::transpose_storage(diffused, result);
+            return result;
+        }
+    } else {
+        auto current = arena.matrix<element_type>(rows, columns);
+        auto next = arena.matrix<element_type>(rows, columns);
+        auto row_buffers = arena.matrix<compute_type_t<element_type>>(4, columns);
+        auto& diffused =
+            detail::diffuse(input, current, next, row_buffers, delta_t, kappa, iteration_count);
+        if constexpr (OutputStorageOrder == blaze::rowMajor) {
+            return diffused;
+        } else {
+            auto result = arena.matrix<element_type, blaze::columnMajor>(rows, columns);
+            detail::transpose_storage(diffused, result);
+            return result;
+        }
     }
+}
 
-    return output_matrix_type(scratch_area);
+template <typename MT, bool StorageOrder, bool OutputStorageOrder = StorageOrder>
+auto anisotropic_diffusion(const blaze::DenseMatrix<MT, StorageOrder>& input, double delta_t,
+                           double kappa, std::uint64_t iteration_count, workspace& arena)
+{
+    return anisotropic_diffusion<double, MT, StorageOrder, OutputStorageOrder>(
+        input, delta_t, kappa, iteration_count, arena);
 }
 } // namespace flash
 
@@ -0,0 +1,79 @@
+#ifndef BLAZING_GIL_PARALLEL_HPP
+#define BLAZING_GIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flash
+{
+/** \brief Number of threads used by `parallel_for`
+
+    Equal to the number of hardware threads, or 1 if it cannot be determined.
+*/
+inline std::size_t thread_count()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/** \brief Invokes `function(index)` for every index in [begin, end) on multiple threads
+
+    Indices are handed out dynamically, so work items of uneven cost (tiles near image borders,
+    blocks of different sizes) are balanced automatically. Each index is processed exactly
+    once, but the order is unspecified. The first exception thrown by `function` is rethrown
+    in the calling thread after all workers finished.
+
+    \tparam Function Callable with signature `void(std::size_t)`
+*/
+template <typename Function>
+void parallel_for(std::size_t begin, std::size_t end, Function function)
+{
+    if (begin >= end) {
+        return;
+    }
+    const auto worker_count = std::min(thread_count(), end - begin);
+    if (worker_count == 1) {
+        for (auto i = begin; i < end; ++i) {
+            function(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{begin};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+        try {
+            for (auto i = next++; i < end; i = next++) {
+                function(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next = end;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count - 1);
+    for (std::size_t i = 1; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+} // namespace flash
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef BLAZING_GIL_PLANAR_HPP
+#define BLAZING_GIL_PLANAR_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/convolution.hpp>
+#include <flash/core.hpp>
+#include <flash/numeric.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace flash
+{
+/** \brief Multi-channel matrix stored as one matrix per channel (structure of arrays)
+
+    Unlike `DynamicMatrix<StaticVector<T, N>>`, where channels of a pixel are interleaved and
+    each vector is padded by Blaze, every channel is a contiguous, aligned and padded
+    `DynamicMatrix<T>`. Per-channel operations thus run on full SIMD width and do not need layout
+    compatibility between GIL pixels and Blaze vectors.
+
+    \tparam T The element type of every plane
+    \tparam N The number of channels
+*/
+template <typename T, std::size_t N>
+class planar_matrix
+{
+  public:
+    using element_type = T;
+    using plane_type = blaze::DynamicMatrix<T>;
+    using vector_type = blaze::StaticVector<T, N>;
+    static constexpr std::size_t channels = N;
+
+    planar_matrix() = default;
+
+    planar_matrix(std::size_t rows, std::size_t columns)
+    {
+        resize(rows, columns);
+    }
+
+    planar_matrix(std::size_t rows, std::size_t columns, const T& value)
+    {
+        for (auto& plane : planes) {
+            plane.resize(rows, columns, false);
+            plane = value;
+        }
+    }
+
+    std::size_t rows() const noexcept { return planes[0].rows(); }
+    std::size_t columns() const noexcept { return planes[0].columns(); }
+
+    plane_type& plane(std::size_t channel) { return planes[channel]; }
+    const plane_type& plane(std::size_t channel) const { return planes[channel]; }
+
+    /// gathers the channels of a single pixel, slow compared to working on planes
+    vector_type operator()(std::size_t i, std::size_t j) const
+    {
+        vector_type result;
+        for (std::size_t channel = 0; channel < N; ++channel) {
+            result[channel] = planes[channel](i, j);
+        }
+        return result;
+    }
+
+    void resize(std::size_t rows, std::size_t columns)
+    {
+        for (auto& plane : planes) {
+            plane.resize(rows, columns, false);
+        }
+    }
+
+    bool operator==(const planar_matrix& other) const
+    {
+        for (std::size_t channel = 0; channel < N; ++channel) {
+            if (planes[channel] != other.planes[channel]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const planar_matrix& other) const { return !(*this == other); }
+
+  private:
+    std::array<plane_type, N> planes;
+};
+
+/** \brief Converts a view into planar matrix, one plane per channel
+
+    Works with both interleaved and planar GIL views. Do note that it will strip wrapper type
+    around floating point types like gil::float32_t, etc.
+
+    \tparam View The source view type
+    \arg view The source view
+
+    \return A `planar_matrix<ChannelType, num_channels>`
+*/
+template <typename View>
+auto to_planar_matrix(View view)
+{
+    constexpr auto num_channels = boost::gil::num_channels<View>::value;
+    using channel_type = true_channel_type_t<typename boost::gil::channel_type<View>::type>;
+    planar_matrix<channel_type, num_channels> result(view.height(), view.width());
+    for (std::size_t channel = 0; channel < num_channels; ++channel) {
+        to_matrix(view, result.plane(channel), channel);
+    }
+    return result;
+}
+
+/** \brief Writes planar matrix into an interleaved or planar view of the same size
+
+    \arg data The planar matrix with as many channels as the view's pixels
+    \arg view The view to write into
+*/
+template <typename T, std::size_t N, typename ImageView>
+void from_planar_matrix(const planar_matrix<T, N>& data, ImageView view)
+{
+    static_assert(boost::gil::num_channels<ImageView>::value == N,
+                  "The number of channels in the view and in the matrix must be the same");
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        const auto& plane = data.plane(channel);
+        if constexpr (detail::is_basic_view_v<ImageView>) {
+            for (signed_size i = 0; i < view.height(); ++i) {
+                detail::scatter_row<detail::channel_step_v<ImageView>>(
+                    plane.data(i), view.width(), detail::channel_pointer(view, i, channel));
+            }
+        } else {
+            for (signed_size i = 0; i < view.height(); ++i) {
+                for (signed_size j = 0; j < view.width(); ++j) {
+                    view(j, i)[channel] = plane(i, j);
+                }
+            }
+        }
+    }
+}
+
+/** \brief Converts planar matrix into image of specified type
+
+    \tparam ImageType The image type to convert into, either interleaved or planar
+*/
+template <typename ImageType, typename T, std::size_t N>
+ImageType from_planar_matrix(const planar_matrix<T, N>& data)
+{
+    ImageType result(data.columns(), data.rows());
+    from_planar_matrix(data, boost::gil::view(result));
+    return result;
+}
+
+template <typename T, std::size_t N>
+blaze::StaticVector<T, N> channelwise_min(const planar_matrix<T, N>& input)
+{
+    blaze::StaticVector<T, N> result;
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        result[channel] = flash::min(input.plane(channel));
+    }
+    return result;
+}
+
+template <typename T, std::size_t N>
+blaze::StaticVector<T, N> channelwise_max(const planar_matrix<T, N>& input)
+{
+    blaze::StaticVector<T, N> result;
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        result[channel] = flash::max(input.plane(channel));
+    }
+    return result;
+}
+
+/** \brief Remap every plane into another range
+
+    Same semantics as `remap_to_channeled`, minimum and maximum are taken per channel.
+
+    \tparam U The element type of the result
+    \arg dst_min The minimum of the resulting range, do set manually if remapping into wider range
+    \arg dst_max The maximum of the resulting range, do set manually if remapping into wider range
+*/
+template <typename U, typename T, std::size_t N>
+planar_matrix<U, N> remap_to_channeled(const planar_matrix<T, N>& source,
+                                       U dst_min = std::numeric_limits<U>::min(),
+                                       U dst_max = std::numeric_limits<U>::max())
+{
+    planar_matrix<U, N> result;
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        const auto [src_min, src_max] = flash::minmax(source.plane(channel));
+        const auto map = detail::make_channeled_remap(src_min, src_max, dst_min, dst_max);
+        result.plane(channel) = blaze::map(source.plane(channel), map);
+    }
+    return result;
+}
+
+/// Convolves every plane with the same kernel
+template <typename T, std::size_t N, typename Kernel>
+planar_matrix<T, N> convolve(const planar_matrix<T, N>& source, const Kernel& kernel)
+{
+    planar_matrix<T, N> result;
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        result.plane(channel) = convolve(source.plane(channel), kernel);
+    }
+    return result;
+}
+
+/// Transposes every plane, see `transpose`
+template <typename T, std::size_t N>
+planar_matrix<T, N> transpose(const planar_matrix<T, N>& source)
+{
+    planar_matrix<T, N> result;
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        result.plane(channel) = flash::transpose(source.plane(channel));
+    }
+    return result;
+}
+
+/** \brief Anisotropic diffusion of every plane
+
+    Diffusivity is computed per channel in `anisotropic_diffusion` for channeled matrices too,
+    so diffusing planes independently gives the same result, but with scalar planes that can
+    be processed at full SIMD width.
+*/
+template <typename T, std::size_t N>
+planar_matrix<double, N> anisotropic_diffusion(const planar_matrix<T, N>& input, double delta_t,
+                                               double kappa, std::uint64_t iteration_count)
+{
+    planar_matrix<double, N> result;
+    for (std::size_t channel = 0; channel < N; ++channel) {
+        result.plane(channel) =
+            anisotropic_diffusion(input.plane(channel), delta_t, kappa, iteration_count);
+    }
+    return result;
+}
+} // namespace flash
+
+#endif
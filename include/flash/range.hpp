@@ -0,0 +1,165 @@
+#ifndef BLAZING_GIL_RANGE_HPP
+#define BLAZING_GIL_RANGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+namespace flash
+{
+/** \brief Closed interval of values an element can take, for compile time overflow analysis
+
+    Bounds are kept in `double`, which is exact for every integer up to 2^53 and large enough
+    to tell that a range does not fit into 64 bits. All operations are `constexpr`, so that the
+    worst case of a chain of convolutions and products can be computed from the input type and
+    fixed kernel coefficients, and the narrowest type holding it selected via
+    `accumulator_index` and `accumulator_type_t`.
+*/
+struct value_range {
+    double low;
+    double high;
+};
+
+/// every value of arithmetic type `T`
+template <typename T>
+constexpr value_range range_of()
+{
+    static_assert(std::is_arithmetic_v<T>, "only arithmetic types have a range");
+    return {static_cast<double>(std::numeric_limits<T>::lowest()),
+            static_cast<double>(std::numeric_limits<T>::max())};
+}
+
+/** \brief `range_of<T>` for integral types, an empty range at zero for floating point types
+
+    Floating point types are kept by `range_accumulator_t` regardless of the range, this keeps
+    their analysis from overflowing to infinity, which is not a constant expression.
+*/
+template <typename T>
+constexpr value_range integral_range_of()
+{
+    if constexpr (std::is_integral_v<T>) {
+        return range_of<T>();
+    } else {
+        return {0, 0};
+    }
+}
+
+constexpr value_range operator+(value_range lhs, value_range rhs)
+{
+    return {lhs.low + rhs.low, lhs.high + rhs.high};
+}
+
+constexpr value_range operator-(value_range lhs, value_range rhs)
+{
+    return {lhs.low - rhs.high, lhs.high - rhs.low};
+}
+
+constexpr value_range operator*(value_range lhs, value_range rhs)
+{
+    const double products[] = {
+        lhs.low * rhs.low, lhs.low * rhs.high, lhs.high * rhs.low, lhs.high * rhs.high};
+    return {std::min({products[0], products[1], products[2], products[3]}),
+            std::max({products[0], products[1], products[2], products[3]})};
+}
+
+constexpr value_range operator*(double factor, value_range range)
+{
+    return factor < 0 ? value_range{factor * range.high, factor * range.low}
+                      : value_range{factor * range.low, factor * range.high};
+}
+
+/// smallest range containing both `lhs` and `rhs`
+constexpr value_range hull(value_range lhs, value_range rhs)
+{
+    return {std::min(lhs.low, rhs.low), std::max(lhs.high, rhs.high)};
+}
+
+/** \brief Range of a convolution (or correlation) of `input` valued elements with `kernel`
+
+    Every coefficient contributes its product with whichever bound of `input` is the worst case
+    for its sign, thus the result is tight for kernels like `sobel_x_coefficients`.
+*/
+template <typename Coefficient, std::size_t M, std::size_t N>
+constexpr value_range convolved_range(value_range input, const Coefficient (&kernel)[M][N])
+{
+    value_range result{0, 0};
+    for (std::size_t i = 0; i < M; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+            result = result + static_cast<double>(kernel[i][j]) * input;
+        }
+    }
+    return result;
+}
+
+/// whether every value of `range` is representable in `T` without overflow
+template <typename T>
+constexpr bool holds(value_range range)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return range.low >= range_of<T>().low && range.high <= range_of<T>().high;
+    } else {
+        // the maximum of 64 bit types rounds up to 2^63 or 2^64 in double, the comparison stays
+        // strict for them, so that ranges reaching that bound conservatively select a wider type
+        constexpr auto high = range_of<T>().high;
+        constexpr bool exact =
+            std::numeric_limits<T>::digits <= std::numeric_limits<double>::digits;
+        return range.low >= range_of<T>().low && (exact ? range.high <= high : range.high < high);
+    }
+}
+
+namespace detail
+{
+using accumulator_candidates = std::tuple<std::int8_t, std::uint8_t, std::int16_t, std::uint16_t,
+                                          std::int32_t, std::uint32_t, std::int64_t, std::uint64_t,
+                                          double>;
+
+template <std::size_t... Indices>
+constexpr std::size_t first_holding(value_range range, std::index_sequence<Indices...>)
+{
+    std::size_t result = sizeof...(Indices) - 1;
+    // in reverse, so that the narrowest candidate holding the range is assigned last
+    ((result = holds<std::tuple_element_t<sizeof...(Indices) - 1 - Indices,
+                                          accumulator_candidates>>(range)
+                   ? sizeof...(Indices) - 1 - Indices
+                   : result),
+     ...);
+    return result;
+}
+} // namespace detail
+
+/** \brief Index of the narrowest integer type holding every value of `range`
+
+    Candidates are ordered by width, signed before unsigned. Ranges exceeding 64 bits select
+    `double`, which does not overflow but loses exactness above 2^53.
+
+    \return An index to use with `accumulator_type_t`
+*/
+constexpr std::size_t accumulator_index(value_range range)
+{
+    constexpr auto count = std::tuple_size_v<detail::accumulator_candidates>;
+    return detail::first_holding(range, std::make_index_sequence<count>{});
+}
+
+/// the type at `Index`, e.g. `accumulator_type_t<accumulator_index(range)>`
+template <std::size_t Index>
+using accumulator_type_t = std::tuple_element_t<Index, detail::accumulator_candidates>;
+
+/// the narrowest integer type holding `[Low, High]`
+template <std::int64_t Low, std::int64_t High>
+using narrowest_integer_t = accumulator_type_t<accumulator_index(
+    {static_cast<double>(Low), static_cast<double>(High)})>;
+
+/** \brief Narrowest type holding every value of `range`, which was computed from `Input`
+
+    Integral inputs select through `accumulator_index`, floating point inputs keep their type, as
+    their products do not overflow in practice and narrowing them would only lose precision.
+*/
+template <typename Input, std::size_t Index>
+using range_accumulator_t =
+    std::conditional_t<std::is_floating_point_v<Input>, Input, accumulator_type_t<Index>>;
+} // namespace flash
+
+#endif
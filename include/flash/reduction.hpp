@@ -0,0 +1,464 @@
+#ifndef BLAZING_GIL_REDUCTION_HPP
+#define BLAZING_GIL_REDUCTION_HPP
+
+#include <blaze/Blaze.h>
+#include <blaze/math/typetraits/IsContiguous.h>
+#include <blaze/math/typetraits/IsDenseVector.h>
+
+#include <flash/parallel.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flash
+{
+namespace detail
+{
+/// number of independent accumulators per line, breaks the dependency chain for SIMD
+inline constexpr std::size_t reduction_lanes = 16;
+
+/// approximate number of elements reduced by a single task of `parallel_for`
+inline constexpr std::size_t reduction_block_elements = std::size_t(1) << 16;
+
+/// elementwise for `StaticVector`s, so channels are reduced independently
+template <typename T>
+T element_min(const T& lhs, const T& rhs)
+{
+    if constexpr (blaze::IsDenseVector_v<T>) {
+        return T(blaze::min(lhs, rhs));
+    } else {
+        return rhs < lhs ? rhs : lhs;
+    }
+}
+
+template <typename T>
+T element_max(const T& lhs, const T& rhs)
+{
+    if constexpr (blaze::IsDenseVector_v<T>) {
+        return T(blaze::max(lhs, rhs));
+    } else {
+        return lhs < rhs ? rhs : lhs;
+    }
+}
+
+/* Reductions are described by operations with three members:
+   - `start(accumulator, value)` initializes an accumulator with the first value
+   - `accumulate(accumulator, value)` folds another value in
+   - `combine(accumulator, other)` merges another accumulator in
+   and an `accumulator_t<ElementType>` member alias template.
+*/
+
+/// combines `partials` pairwise, (0, 1), (2, 3), ..., then (0, 2), ..., in a fixed order
+template <typename Operation, typename Container>
+auto tree_combine(const Operation& operation, Container partials)
+{
+    for (std::size_t width = 1; width < partials.size(); width *= 2) {
+        for (std::size_t i = 0; i + width < partials.size(); i += 2 * width) {
+            operation.combine(partials[i], partials[i + width]);
+        }
+    }
+    return partials[0];
+}
+
+/* Reduces `count` values of a line, `value(k)` returns the `k`th one. Values are dealt into
+   `reduction_lanes` independent accumulators round robin, so the loop has no dependency chain
+   between consecutive values and is vectorized, then the lanes are combined as a tree.
+*/
+template <typename Accumulator, typename Operation, typename Value>
+Accumulator reduce_line(const Operation& operation, std::size_t count, Value value)
+{
+    if (count < reduction_lanes) {
+        Accumulator result;
+        operation.start(result, value(0));
+        for (std::size_t k = 1; k < count; ++k) {
+            operation.accumulate(result, value(k));
+        }
+        return result;
+    }
+
+    std::array<Accumulator, reduction_lanes> lanes;
+    for (std::size_t lane = 0; lane < reduction_lanes; ++lane) {
+        operation.start(lanes[lane], value(lane));
+    }
+    std::size_t k = reduction_lanes;
+    for (; k + reduction_lanes <= count; k += reduction_lanes) {
+        for (std::size_t lane = 0; lane < reduction_lanes; ++lane) {
+            operation.accumulate(lanes[lane], value(k + lane));
+        }
+    }
+    for (std::size_t lane = 0; k < count; ++k, ++lane) {
+        operation.accumulate(lanes[lane], value(k));
+    }
+    return tree_combine(operation, lanes);
+}
+
+/* Number of lines of the major dimension (rows of row-major, columns of column-major matrices)
+   in a block of roughly `reduction_block_elements` elements. Small matrices end up in a single
+   block and are processed in the calling thread.
+*/
+inline std::size_t reduction_block_lines(std::size_t line_length)
+{
+    return std::max<std::size_t>(1,
+                                 reduction_block_elements / std::max<std::size_t>(line_length, 1));
+}
+
+/// calls `function(first, last)` for blocks of `block_lines` lines in parallel
+template <typename Result, typename Function>
+std::vector<Result> reduce_blocks(std::size_t lines, std::size_t block_lines, Function function)
+{
+    const auto block_count = (lines + block_lines - 1) / block_lines;
+    std::vector<Result> results(block_count);
+    parallel_for(0, block_count, [&](std::size_t block) {
+        const auto first = block * block_lines;
+        results[block] = function(first, std::min(first + block_lines, lines));
+    });
+    return results;
+}
+
+/* The reduction engine. Blocks of `block_lines` lines are fixed by the matrix size only, lines
+   within a block are combined in order and block results as a tree, so the result does not
+   depend on the number of threads, which makes floating point sums reproducible. The block
+   size changes the order of additions only, so with `double` accumulators `float` sums agree
+   to far below `float` precision for any block size.
+*/
+template <typename Operation, typename MT, bool SO>
+auto reduce_matrix(const blaze::DenseMatrix<MT, SO>& source, const Operation& operation,
+                   std::size_t block_lines)
+{
+    using element_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    using accumulator_type = typename Operation::template accumulator_t<element_type>;
+    using composite_type = blaze::CompositeType_t<MT>;
+    using matrix_type = std::remove_cv_t<std::remove_reference_t<composite_type>>;
+    if ((~source).rows() == 0 || (~source).columns() == 0) {
+        throw std::invalid_argument("cannot reduce an empty matrix");
+    }
+
+    composite_type matrix(~source);
+    const std::size_t lines = SO == blaze::rowMajor ? matrix.rows() : matrix.columns();
+    const std::size_t line_length = SO == blaze::rowMajor ? matrix.columns() : matrix.rows();
+    auto reduce_single = [&](std::size_t line) {
+        if constexpr (blaze::IsContiguous_v<matrix_type>) {
+            const auto* values = matrix.data(line);
+            return reduce_line<accumulator_type>(
+                operation, line_length, [values](std::size_t k) { return values[k]; });
+        } else {
+            return reduce_line<accumulator_type>(
+                operation, line_length, [&matrix, line](std::size_t k) -> element_type {
+                    return SO == blaze::rowMajor ? matrix(line, k) : matrix(k, line);
+                });
+        }
+    };
+
+    auto partials = reduce_blocks<accumulator_type>(
+        lines, std::max<std::size_t>(block_lines, 1), [&](std::size_t first, std::size_t last) {
+            auto result = reduce_single(first);
+            for (std::size_t line = first + 1; line < last; ++line) {
+                operation.combine(result, reduce_single(line));
+            }
+            return result;
+        });
+    return tree_combine(operation, std::move(partials));
+}
+
+/// blocks of roughly `reduction_block_elements` elements
+template <typename Operation, typename MT, bool SO>
+auto reduce_matrix(const blaze::DenseMatrix<MT, SO>& source, const Operation& operation)
+{
+    const auto line_length = SO == blaze::rowMajor ? (~source).columns() : (~source).rows();
+    return reduce_matrix(source, operation, reduction_block_lines(line_length));
+}
+
+/* Wide enough to sum images without overflow. `float` is summed in `double`, a `float`
+   accumulator loses the low bits of every value once the partial sum is large, which for a
+   few million pixels is an error of the same order as the values themselves.
+*/
+template <typename T>
+using sum_element_t = std::conditional_t<
+    std::is_integral_v<T>,
+    std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>,
+    std::conditional_t<std::is_same_v<T, float>, double, T>>;
+
+template <typename T, typename = void>
+struct sum_accumulator {
+    using type = sum_element_t<T>;
+};
+
+template <typename T>
+struct sum_accumulator<T, std::enable_if_t<blaze::IsDenseVector_v<T>>> {
+    using type = blaze::StaticVector<sum_element_t<blaze::ElementType_t<T>>, T::size()>;
+};
+
+template <typename T>
+using sum_accumulator_t = typename sum_accumulator<T>::type;
+
+/// `double` for scalars, `StaticVector<double, N>` for vectors
+template <typename T, typename = void>
+struct mean_type {
+    using type = double;
+};
+
+template <typename T>
+struct mean_type<T, std::enable_if_t<blaze::IsDenseVector_v<T>>> {
+    using type = blaze::StaticVector<double, T::size()>;
+};
+
+template <typename T>
+using mean_type_t = typename mean_type<T>::type;
+
+struct sum_operation {
+    template <typename T>
+    using accumulator_t = sum_accumulator_t<T>;
+
+    template <typename A, typename T>
+    void start(A& accumulator, const T& value) const
+    {
+        accumulator = A(value);
+    }
+
+    template <typename A, typename T>
+    void accumulate(A& accumulator, const T& value) const
+    {
+        accumulator += value;
+    }
+
+    template <typename A>
+    void combine(A& accumulator, const A& other) const
+    {
+        accumulator += other;
+    }
+};
+
+struct min_operation {
+    template <typename T>
+    using accumulator_t = T;
+
+    template <typename T>
+    void start(T& accumulator, const T& value) const
+    {
+        accumulator = value;
+    }
+
+    template <typename T>
+    void accumulate(T& accumulator, const T& value) const
+    {
+        accumulator = element_min(accumulator, value);
+    }
+
+    template <typename T>
+    void combine(T& accumulator, const T& other) const
+    {
+        accumulate(accumulator, other);
+    }
+};
+
+struct max_operation {
+    template <typename T>
+    using accumulator_t = T;
+
+    template <typename T>
+    void start(T& accumulator, const T& value) const
+    {
+        accumulator = value;
+    }
+
+    template <typename T>
+    void accumulate(T& accumulator, const T& value) const
+    {
+        accumulator = element_max(accumulator, value);
+    }
+
+    template <typename T>
+    void combine(T& accumulator, const T& other) const
+    {
+        accumulate(accumulator, other);
+    }
+};
+
+struct minmax_operation {
+    template <typename T>
+    using accumulator_t = std::pair<T, T>;
+
+    template <typename T>
+    void start(std::pair<T, T>& accumulator, const T& value) const
+    {
+        accumulator = {value, value};
+    }
+
+    template <typename T>
+    void accumulate(std::pair<T, T>& accumulator, const T& value) const
+    {
+        accumulator.first = element_min(accumulator.first, value);
+        accumulator.second = element_max(accumulator.second, value);
+    }
+
+    template <typename T>
+    void combine(std::pair<T, T>& accumulator, const std::pair<T, T>& other) const
+    {
+        accumulator.first = element_min(accumulator.first, other.first);
+        accumulator.second = element_max(accumulator.second, other.second);
+    }
+};
+
+/// sum of squared differences from a known mean, the second pass of `variance`
+template <typename Mean>
+struct squared_deviation_operation {
+    template <typename T>
+    using accumulator_t = Mean;
+
+    Mean mean;
+
+    template <typename T>
+    Mean deviation(const T& value) const
+    {
+        // elementwise for vectors
+        const Mean difference = Mean(value) - mean;
+        return Mean(difference * difference);
+    }
+
+    template <typename T>
+    void start(Mean& accumulator, const T& value) const
+    {
+        accumulator = deviation(value);
+    }
+
+    template <typename T>
+    void accumulate(Mean& accumulator, const T& value) const
+    {
+        accumulator += deviation(value);
+    }
+
+    void combine(Mean& accumulator, const Mean& other) const { accumulator += other; }
+};
+
+/// applies a binary function of scalars to every channel of vectors
+template <typename Function>
+struct channelwise_operation {
+    template <typename T>
+    using accumulator_t = T;
+
+    Function function;
+
+    template <typename T>
+    void start(T& accumulator, const T& value) const
+    {
+        accumulator = value;
+    }
+
+    template <typename T>
+    void accumulate(T& accumulator, const T& value) const
+    {
+        for (std::size_t i = 0; i < accumulator.size(); ++i) {
+            accumulator[i] = function(accumulator[i], value[i]);
+        }
+    }
+
+    template <typename T>
+    void combine(T& accumulator, const T& other) const
+    {
+        accumulate(accumulator, other);
+    }
+};
+} // namespace detail
+
+/** \brief Sum of all elements, channelwise for matrices of `StaticVector`s
+
+    Integral elements are summed in 64 bit integers, so the result does not overflow for images,
+    `float` elements are summed in `double`. Floating point sums are reproducible, they do not
+    depend on the number of threads.
+
+    \return `std::int64_t` or `std::uint64_t` for integral, `double` for `float` and the element
+    type for other floating point elements, a `StaticVector` of those for vector elements
+*/
+template <typename MT, bool SO>
+auto sum(const blaze::DenseMatrix<MT, SO>& input)
+{
+    return detail::reduce_matrix(input, detail::sum_operation{});
+}
+
+/// Minimum of all elements, channelwise for matrices of `StaticVector`s
+template <typename MT, bool SO>
+auto min(const blaze::DenseMatrix<MT, SO>& input)
+{
+    return detail::reduce_matrix(input, detail::min_operation{});
+}
+
+/// Maximum of all elements, channelwise for matrices of `StaticVector`s
+template <typename MT, bool SO>
+auto max(const blaze::DenseMatrix<MT, SO>& input)
+{
+    return detail::reduce_matrix(input, detail::max_operation{});
+}
+
+/** \brief Minimum and maximum of a matrix, computed in a single pass
+
+    Replaces consecutive `blaze::min` and `blaze::max` calls. Rows (columns for column-major
+    matrices) are split into blocks reduced in parallel, and each contiguous row is folded into
+    multiple independent accumulators, which compilers turn into SIMD min/max instructions.
+
+    \arg input The matrix to reduce, must not be empty
+
+    \return `std::pair` of the minimum and the maximum
+*/
+template <typename MT, bool SO>
+auto minmax(const blaze::DenseMatrix<MT, SO>& input)
+{
+    static_assert(!blaze::IsDenseVector_v<blaze::ElementType_t<MT>>,
+                  "use channelwise_minmax for matrices of vectors");
+    return detail::reduce_matrix(input, detail::minmax_operation{});
+}
+
+/** \brief Minimum and maximum of each channel of a matrix of `StaticVector`s, in a single pass
+
+    Same as `channelwise_min` and `channelwise_max` together, but reads the matrix once.
+
+    \return `std::pair` of vectors of per channel minimums and maximums
+*/
+template <typename MT, bool SO>
+auto channelwise_minmax(const blaze::DenseMatrix<MT, SO>& input)
+{
+    static_assert(blaze::IsDenseVector_v<blaze::ElementType_t<MT>>,
+                  "use minmax for matrices of scalars");
+    return detail::reduce_matrix(input, detail::minmax_operation{});
+}
+
+/** \brief Arithmetic mean of all elements, channelwise for matrices of `StaticVector`s
+
+    \return `double`, or `StaticVector<double, N>` for vector elements
+*/
+template <typename MT, bool SO>
+auto mean(const blaze::DenseMatrix<MT, SO>& input)
+{
+    using mean_type = detail::mean_type_t<std::remove_cv_t<blaze::ElementType_t<MT>>>;
+    const auto count = static_cast<double>((~input).rows() * (~input).columns());
+    return mean_type(mean_type(flash::sum(input)) / count);
+}
+
+/** \brief Sample variance of all elements, channelwise for matrices of `StaticVector`s
+
+    Same definition as `blaze::var`, the sum of squared deviations is divided by `n - 1`. Computed
+    in two passes, the mean first, then the squared deviations from it, which is accurate even
+    when the mean is large compared to the spread.
+
+    \return `double`, or `StaticVector<double, N>` for vector elements
+*/
+template <typename MT, bool SO>
+auto variance(const blaze::DenseMatrix<MT, SO>& input)
+{
+    using mean_type = detail::mean_type_t<std::remove_cv_t<blaze::ElementType_t<MT>>>;
+    const auto count = (~input).rows() * (~input).columns();
+    if (count < 2) {
+        throw std::invalid_argument("variance needs at least two elements");
+    }
+    const detail::squared_deviation_operation<mean_type> operation{flash::mean(input)};
+    const auto deviations = detail::reduce_matrix(input, operation);
+    return mean_type(deviations / static_cast<double>(count - 1));
+}
+} // namespace flash
+
+#endif
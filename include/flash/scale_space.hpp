@@ -0,0 +1,129 @@
+#ifndef BLAZING_GIL_SCALE_SPACE_HPP
+#define BLAZING_GIL_SCALE_SPACE_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/convolution.hpp>
+#include <flash/core.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace flash
+{
+/** \brief Gaussian scale space, organized in octaves
+
+    Each octave holds `intervals + 3` levels, level `k` having blur of
+    `initial_sigma * 2^(k / intervals)` relative to the octave's resolution, so that
+    `intervals + 2` difference of Gaussians levels are available for extrema detection.
+
+    Levels are built incrementally: level `k` is obtained by blurring level `k - 1` with
+    `sqrt(sigma_k^2 - sigma_{k-1}^2)`, which is much smaller than `sigma_k`, so the kernels stay
+    short. The first level of the next octave is level `intervals` (blur `2 * initial_sigma`)
+    of the previous octave with every second row and column dropped, no blurring is needed
+    for it.
+
+    \tparam T The element type of levels
+*/
+template <typename T = float>
+class scale_space
+{
+  public:
+    using matrix_type = blaze::DynamicMatrix<T>;
+
+    /** \brief Builds all levels of all octaves
+
+        \arg source The image to build scale space from
+        \arg octave_count The number of octaves, stops earlier if the image gets too small
+        \arg intervals The number of intervals each octave is divided into
+        \arg initial_sigma The blur of the first level of each octave
+        \arg assumed_blur The blur the source is assumed to already have
+    */
+    template <typename MT, bool SO>
+    scale_space(const blaze::DenseMatrix<MT, SO>& source, std::size_t octave_count,
+                std::size_t intervals = 3, double initial_sigma = 1.6, double assumed_blur = 0.5)
+        : intervals(intervals), initial_sigma(initial_sigma)
+    {
+        if (octave_count == 0 || intervals == 0) {
+            throw std::invalid_argument("scale space needs at least one octave and interval");
+        }
+        if (initial_sigma <= assumed_blur) {
+            throw std::invalid_argument("initial sigma must exceed the blur source already has");
+        }
+
+        // sigma increments between consecutive levels are the same in every octave
+        std::vector<double> increments(level_count());
+        for (std::size_t k = 1; k < level_count(); ++k) {
+            const double previous = relative_sigma(k - 1);
+            const double current = relative_sigma(k);
+            increments[k] = std::sqrt(current * current - previous * previous);
+        }
+
+        matrix_type base = gaussian_blur<T>(
+            source, std::sqrt(initial_sigma * initial_sigma - assumed_blur * assumed_blur));
+        for (std::size_t octave = 0; octave < octave_count; ++octave) {
+            std::vector<matrix_type> levels;
+            levels.reserve(level_count());
+            levels.push_back(std::move(base));
+            for (std::size_t k = 1; k < level_count(); ++k) {
+                levels.push_back(gaussian_blur<T>(levels.back(), increments[k]));
+            }
+
+            const auto& next_base = levels[intervals];
+            const auto rows = next_base.rows() / 2;
+            const auto columns = next_base.columns() / 2;
+            if (rows > 0 && columns > 0) {
+                base = blaze::generate(rows, columns, [&next_base](std::size_t i, std::size_t j) {
+                    return next_base(i * 2, j * 2);
+                });
+            }
+            octaves.push_back(std::move(levels));
+            if (rows == 0 || columns == 0) {
+                break;
+            }
+        }
+    }
+
+    std::size_t octave_count() const noexcept { return octaves.size(); }
+
+    /// number of Gaussian levels per octave
+    std::size_t level_count() const noexcept { return intervals + 3; }
+
+    /// number of difference of Gaussians levels per octave
+    std::size_t dog_count() const noexcept { return intervals + 2; }
+
+    const matrix_type& level(std::size_t octave, std::size_t index) const
+    {
+        return octaves.at(octave).at(index);
+    }
+
+    /** \brief Difference of Gaussians between levels `index + 1` and `index`
+
+        Computed lazily, the returned Blaze expression refers to the levels stored in the scale
+        space and is only evaluated when assigned or read.
+    */
+    auto dog(std::size_t octave, std::size_t index) const
+    {
+        return level(octave, index + 1) - level(octave, index);
+    }
+
+    /// blur of the level relative to the source resolution
+    double sigma(std::size_t octave, std::size_t index) const
+    {
+        return relative_sigma(index) * std::pow(2.0, static_cast<double>(octave));
+    }
+
+  private:
+    double relative_sigma(std::size_t index) const
+    {
+        return initial_sigma * std::pow(2.0, static_cast<double>(index) / intervals);
+    }
+
+    std::size_t intervals;
+    double initial_sigma;
+    std::vector<std::vector<matrix_type>> octaves;
+};
+} // namespace flash
+
+#endif
@@ -2,8 +2,18 @@
 #define BLAZING_GIL_SCALING_HPP
 
 #include <blaze/Blaze.h>
+#include <blaze/math/typetraits/IsDenseVector.h>
 
 #include <flash/core.hpp>
+#include <flash/half.hpp>
+#include <flash/workspace.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace flash
 {
@@ -18,15 +28,16 @@ struct lanczos_method {
 
 namespace detail
 {
-template <typename T>
-blaze::DynamicMatrix<T>
-scale_nearest_neighbor(const blaze::DynamicMatrix<T>& source,
-                       std::size_t new_width, std::size_t new_height)
+/// the new size is taken from `result`
+template <typename T, typename Result>
+void scale_nearest_neighbor_into(const blaze::DynamicMatrix<T>& source, Result& result)
 {
+    const std::size_t new_width = result.columns();
+    const std::size_t new_height = result.rows();
     double ratio_w = source.columns() / static_cast<double>(new_width);
     double ratio_h = source.rows() / static_cast<double>(new_height);
 
-    return blaze::generate(
+    result = blaze::generate(
         new_height,
         new_width,
         [&source, ratio_w, ratio_h](std::size_t i, std::size_t j) {
@@ -34,16 +45,15 @@ scale_nearest_neighbor(const blaze::DynamicMatrix<T>& source,
         });
 }
 
-template <typename T>
-blaze::DynamicMatrix<T>
-scale_bilinear_interpolation(const blaze::DynamicMatrix<T>& source,
-                             std::size_t new_width, std::size_t new_height)
+template <typename T, typename Result>
+void scale_bilinear_interpolation_into(const blaze::DynamicMatrix<T>& source, Result& result)
 {
-    auto padded = flash::pad(source, 1, 0);
+    const std::size_t new_width = result.columns();
+    const std::size_t new_height = result.rows();
     auto ratio_w = source.columns() / static_cast<double>(new_width);
     auto ratio_h = source.rows() / static_cast<double>(new_height);
 
-    return blaze::generate(
+    result = blaze::generate(
         new_height,
         new_width,
         [&source, ratio_w, ratio_h](std::size_t i, std::size_t j) {
@@ -72,7 +82,22 @@ blaze::DynamicMatrix<T> scale(nearest_neighbor,
                               const blaze::DynamicMatrix<T>& source,
                               std::size_t new_width, std::size_t new_height)
 {
-    return detail::scale_nearest_neighbor(source, new_width, new_height);
+    blaze::DynamicMatrix<T> result(new_height, new_width);
+    detail::scale_nearest_neighbor_into(source, result);
+    return result;
+}
+
+/** \brief Same as `scale`, but the result is taken from `arena`
+
+    \return A `workspace::matrix_type<T>`, valid until `arena` is reset
+*/
+template <typename T>
+auto scale(nearest_neighbor, const blaze::DynamicMatrix<T>& source, std::size_t new_width,
+           std::size_t new_height, workspace& arena)
+{
+    auto result = arena.matrix<T>(new_height, new_width);
+    detail::scale_nearest_neighbor_into(source, result);
+    return result;
 }
 
 template <typename T>
@@ -80,7 +105,19 @@ blaze::DynamicMatrix<T> scale(bilinear_interpolation,
                               const blaze::DynamicMatrix<T>& source,
                               std::size_t new_width, std::size_t new_height)
 {
-    return detail::scale_bilinear_interpolation(source, new_width, new_height);
+    blaze::DynamicMatrix<T> result(new_height, new_width);
+    detail::scale_bilinear_interpolation_into(source, result);
+    return result;
+}
+
+/// same as above with the result taken from `arena`
+template <typename T>
+auto scale(bilinear_interpolation, const blaze::DynamicMatrix<T>& source, std::size_t new_width,
+           std::size_t new_height, workspace& arena)
+{
+    auto result = arena.matrix<T>(new_height, new_width);
+    detail::scale_bilinear_interpolation_into(source, result);
+    return result;
 }
 
 inline double normalized_sinc(double x) { return std::sin(x * pi) / (x * pi); }
@@ -91,25 +128,28 @@ inline double lanczos(double x, signed_size a)
         return 1;
 
     if (-a < x && x < a)
-        return normalized_sinc(x) / normalized_sinc(x / static_cast<double>(a));
+        return normalized_sinc(x) * normalized_sinc(x / static_cast<double>(a));
     return 0;
 }
 
-template <typename T>
-blaze::DynamicMatrix<T>
-scale(lanczos_method, const blaze::DynamicMatrix<T>& source,
-      std::size_t new_width, std::size_t new_height, signed_size a)
+namespace detail
 {
+template <typename T, typename Result>
+void scale_lanczos_into(const blaze::DynamicMatrix<T>& source, Result& scaled, signed_size a)
+{
+    const std::size_t new_width = scaled.columns();
+    const std::size_t new_height = scaled.rows();
     double ratio_w = source.columns() / static_cast<double>(new_width);
     double ratio_h = source.rows() / static_cast<double>(new_height);
-    return blaze::generate(
+    scaled = blaze::generate(
         new_height,
         new_width,
         [a, ratio_w, ratio_h, &source](std::size_t target_i,
                                        std::size_t target_j) {
             signed_size original_i = target_i * ratio_h;
             signed_size original_j = target_j * ratio_w;
-            T result{};
+            // `float16` and `bfloat16` would round every partial sum
+            compute_type_t<T> result{};
             for (signed_size i = original_i - a; i <= original_i + a; ++i) {
                 for (signed_size j = original_j - a; j <= original_j + a; ++j) {
                     if (i < 0 || i >= static_cast<signed_size>(source.rows()))
@@ -123,9 +163,348 @@ scale(lanczos_method, const blaze::DynamicMatrix<T>& source,
                              lanczos_response * source(original_i, original_j);
                 }
             }
-            return result;
+            return static_cast<T>(result);
         });
 }
+} // namespace detail
+
+template <typename T>
+blaze::DynamicMatrix<T>
+scale(lanczos_method, const blaze::DynamicMatrix<T>& source,
+      std::size_t new_width, std::size_t new_height, signed_size a)
+{
+    blaze::DynamicMatrix<T> result(new_height, new_width);
+    detail::scale_lanczos_into(source, result, a);
+    return result;
+}
+
+/// same as above with the result taken from `arena`
+template <typename T>
+auto scale(lanczos_method, const blaze::DynamicMatrix<T>& source, std::size_t new_width,
+           std::size_t new_height, signed_size a, workspace& arena)
+{
+    auto result = arena.matrix<T>(new_height, new_width);
+    detail::scale_lanczos_into(source, result, a);
+    return result;
+}
+
+namespace detail
+{
+/** \brief Precomputed 1D resampling filter
+
+    For every target sample stores the first contributing source sample, the number of
+    contributing samples and their normalized weights. Weights are stored in blocks of
+    `taps_per_sample` entries, one block per target sample.
+*/
+struct resampling_taps {
+    std::size_t taps_per_sample = 0;
+    std::vector<std::size_t> first;
+    std::vector<std::size_t> count;
+    std::vector<double> weights;
+
+    std::size_t last(std::size_t target) const { return first[target] + count[target] - 1; }
+};
+
+template <typename WeightFunction>
+resampling_taps make_filter_taps(std::size_t source_length, std::size_t target_length,
+                                 double support, WeightFunction weight)
+{
+    const double ratio = source_length / static_cast<double>(target_length);
+    // stretch the filter when downscaling, otherwise most of the source is skipped
+    const double filter_scale = std::max(ratio, 1.0);
+    const double radius = support * filter_scale;
+    const auto max_index = static_cast<signed_size>(source_length) - 1;
+
+    resampling_taps taps;
+    taps.taps_per_sample = 2 * static_cast<std::size_t>(std::ceil(radius)) + 1;
+    taps.first.resize(target_length);
+    taps.count.resize(target_length);
+    taps.weights.assign(target_length * taps.taps_per_sample, 0.0);
+    for (std::size_t target = 0; target < target_length; ++target) {
+        const double center = target * ratio;
+        auto low = std::max<signed_size>(std::ceil(center - radius), 0);
+        auto high = std::min<signed_size>(std::floor(center + radius), max_index);
+        high = std::max(low, high);
+        high = std::min<signed_size>(high, low + taps.taps_per_sample - 1);
+
+        auto* target_weights = taps.weights.data() + target * taps.taps_per_sample;
+        double total = 0;
+        for (signed_size i = low; i <= high; ++i) {
+            target_weights[i - low] = weight((i - center) / filter_scale);
+            total += target_weights[i - low];
+        }
+        if (total != 0) {
+            std::for_each(target_weights, target_weights + (high - low + 1), [total](double& w) {
+                w /= total;
+            });
+        } else {
+            target_weights[0] = 1;
+        }
+        taps.first[target] = low;
+        taps.count[target] = high - low + 1;
+    }
+
+    return taps;
+}
+
+inline resampling_taps make_resampling_taps(nearest_neighbor, std::size_t source_length,
+                                            std::size_t target_length, signed_size)
+{
+    const double ratio = source_length / static_cast<double>(target_length);
+    resampling_taps taps;
+    taps.taps_per_sample = 1;
+    taps.first.resize(target_length);
+    taps.count.assign(target_length, 1);
+    taps.weights.assign(target_length, 1.0);
+    for (std::size_t target = 0; target < target_length; ++target) {
+        taps.first[target] = std::min<std::size_t>(target * ratio, source_length - 1);
+    }
+
+    return taps;
+}
+
+inline resampling_taps make_resampling_taps(bilinear_interpolation, std::size_t source_length,
+                                            std::size_t target_length, signed_size)
+{
+    const double ratio = source_length / static_cast<double>(target_length);
+    resampling_taps taps;
+    taps.taps_per_sample = 2;
+    taps.first.resize(target_length);
+    taps.count.resize(target_length);
+    taps.weights.assign(target_length * 2, 0.0);
+    for (std::size_t target = 0; target < target_length; ++target) {
+        const double position = target * ratio;
+        const auto low = std::min<std::size_t>(position, source_length - 1);
+        const double fraction = position - low;
+        taps.first[target] = low;
+        if (low + 1 < source_length && fraction > 0) {
+            taps.count[target] = 2;
+            taps.weights[target * 2] = 1 - fraction;
+            taps.weights[target * 2 + 1] = fraction;
+        } else {
+            taps.count[target] = 1;
+            taps.weights[target * 2] = 1;
+        }
+    }
+
+    return taps;
+}
+
+inline resampling_taps make_resampling_taps(lanczos_method, std::size_t source_length,
+                                            std::size_t target_length, signed_size a)
+{
+    return make_filter_taps(
+        source_length, target_length, a, [a](double x) { return lanczos(x, a); });
+}
+
+template <typename T, typename = void>
+struct resampling_accumulator {
+    using type = double;
+};
+
+template <typename T>
+struct resampling_accumulator<T, std::enable_if_t<blaze::IsDenseVector_v<T>>> {
+    using type = blaze::StaticVector<double, T::size()>;
+};
+
+template <typename T>
+using resampling_accumulator_t = typename resampling_accumulator<T>::type;
+
+// integral results are rounded and clamped, negative lobes of Lanczos would wrap otherwise
+template <typename T>
+T from_accumulator(double value)
+{
+    if constexpr (std::is_integral_v<T>) {
+        value = std::clamp(std::round(value),
+                           static_cast<double>(std::numeric_limits<T>::min()),
+                           static_cast<double>(std::numeric_limits<T>::max()));
+    }
+    return static_cast<T>(value);
+}
+
+template <typename T, std::size_t N>
+T from_accumulator(const blaze::StaticVector<double, N>& value)
+{
+    using element_type = blaze::UnderlyingElement_t<T>;
+    T result{};
+    for (std::size_t i = 0; i < N; ++i) {
+        result[i] = from_accumulator<element_type>(value[i]);
+    }
+    return result;
+}
+} // namespace detail
+
+/** \brief Resizes an image one source row at a time
+
+    Source rows are resampled horizontally as they arrive and kept in a ring buffer that is only
+    as tall as the vertical filter support. As soon as all source rows a target row depends on
+    have been pushed, the target row is computed and handed to the sink. Memory usage is thus
+    O(new_width * support) instead of O(image), which makes it possible to resize images that do
+    not fit into memory.
+
+    \tparam T The element type of source and target rows, either scalar or `StaticVector`
+    \tparam Method One of `nearest_neighbor`, `bilinear_interpolation` or `lanczos_method`
+*/
+template <typename T, typename Method>
+class scanline_scaler
+{
+  public:
+    using element_type = T;
+    using row_type = blaze::DynamicVector<T, blaze::rowVector>;
+
+    /** \brief Prepares the filters and the ring buffer
+
+        \arg a The Lanczos window size, ignored by other methods
+    */
+    scanline_scaler(Method method, std::size_t source_width, std::size_t source_height,
+                    std::size_t new_width, std::size_t new_height, signed_size a = 3)
+        : source_width(source_width), source_height(source_height), new_height(new_height)
+    {
+        if (source_width == 0 || source_height == 0 || new_width == 0 || new_height == 0) {
+            throw std::invalid_argument("cannot scale from or to an empty image");
+        }
+        horizontal = detail::make_resampling_taps(method, source_width, new_width, a);
+        vertical = detail::make_resampling_taps(method, source_height, new_height, a);
+        ring.resize(vertical.taps_per_sample, new_width);
+        accumulator.resize(new_width);
+        output_row.resize(new_width);
+    }
+
+    /** \brief Consumes the next source row and emits every target row that became complete
+
+        \arg row The next source row, must have `source_width` elements
+        \arg sink Callable with signature `void(std::size_t target_row, const row_type& row)`
+    */
+    template <typename VT, typename RowSink>
+    void push_row(const blaze::DenseVector<VT, blaze::rowVector>& row, RowSink&& sink)
+    {
+        if ((~row).size() != source_width) {
+            throw std::invalid_argument("row width does not match source width");
+        }
+        if (consumed_rows == source_height) {
+            throw std::logic_error("all source rows have already been consumed");
+        }
+
+        // rows before the first tap of the pending target row are never read, e.g. when
+        // downscaling with nearest neighbor
+        if (next_target_row == new_height || consumed_rows < vertical.first[next_target_row]) {
+            ++consumed_rows;
+            return;
+        }
+
+        const auto slot = consumed_rows % ring.rows();
+        for (std::size_t x = 0; x < ring.columns(); ++x) {
+            const auto* weights = horizontal.weights.data() + x * horizontal.taps_per_sample;
+            accumulator_type sum{};
+            for (std::size_t k = 0; k < horizontal.count[x]; ++k) {
+                sum += weights[k] * (~row)[horizontal.first[x] + k];
+            }
+            ring(slot, x) = sum;
+        }
+        ++consumed_rows;
+
+        while (next_target_row < new_height && vertical.last(next_target_row) < consumed_rows) {
+            const auto* weights =
+                vertical.weights.data() + next_target_row * vertical.taps_per_sample;
+            std::fill(accumulator.begin(), accumulator.end(), accumulator_type{});
+            for (std::size_t k = 0; k < vertical.count[next_target_row]; ++k) {
+                const auto source_row = vertical.first[next_target_row] + k;
+                accumulator += weights[k] * blaze::row(ring, source_row % ring.rows());
+            }
+            for (std::size_t x = 0; x < output_row.size(); ++x) {
+                output_row[x] = detail::from_accumulator<T>(accumulator[x]);
+            }
+            sink(next_target_row, static_cast<const row_type&>(output_row));
+            ++next_target_row;
+        }
+    }
+
+    /// true if every target row has been emitted, remaining source rows need not be pushed
+    bool finished() const noexcept { return next_target_row == new_height; }
+
+    std::size_t rows_consumed() const noexcept { return consumed_rows; }
+
+  private:
+    using accumulator_type = detail::resampling_accumulator_t<T>;
+
+    std::size_t source_width;
+    std::size_t source_height;
+    std::size_t new_height;
+    detail::resampling_taps horizontal;
+    detail::resampling_taps vertical;
+    blaze::DynamicMatrix<accumulator_type> ring;
+    blaze::DynamicVector<accumulator_type, blaze::rowVector> accumulator;
+    row_type output_row;
+    std::size_t consumed_rows = 0;
+    std::size_t next_target_row = 0;
+};
+
+/** \brief Resizes an image whose rows are produced by `reader` and consumed by `sink`
+
+    Convenience wrapper around `scanline_scaler`. Reading stops as soon as the last target row
+    has been emitted.
+
+    \arg reader Callable with signature `void(std::size_t source_row, row_type& row)`, has to fill
+    `row` which is already sized to `source_width`
+    \arg sink Callable with signature `void(std::size_t target_row, const row_type& row)`
+*/
+template <typename T, typename Method, typename RowReader, typename RowSink>
+void scale_streaming(Method method, std::size_t source_width, std::size_t source_height,
+                     std::size_t new_width, std::size_t new_height, RowReader reader,
+                     RowSink sink, signed_size a = 3)
+{
+    scanline_scaler<T, Method> scaler(
+        method, source_width, source_height, new_width, new_height, a);
+    typename scanline_scaler<T, Method>::row_type row(source_width);
+    for (std::size_t i = 0; i < source_height && !scaler.finished(); ++i) {
+        reader(i, row);
+        scaler.push_row(row, sink);
+    }
+}
+/** \brief Resizes `source` directly into a preallocated GIL view
+
+    The new size is taken from `destination`. `source` can be any dense matrix, including
+    `CustomMatrix`es returned by `as_matrix` and `as_matrix_channeled`, thus scaling between two
+    GIL images does not need any intermediate full size matrix. Rows are streamed through
+    `scanline_scaler`.
+
+    \tparam Method One of `nearest_neighbor`, `bilinear_interpolation` or `lanczos_method`
+    \arg source The matrix to scale, either with scalar or `StaticVector` elements
+    \arg destination The view to write result into, must have the same number of channels,
+    thus a single channel for scalar sources
+    \arg a The Lanczos window size, ignored by other methods
+*/
+template <typename Method, typename MT, bool SO, typename Locator>
+void scale(Method method, const blaze::DenseMatrix<MT, SO>& source,
+           const boost::gil::image_view<Locator>& destination, signed_size a = 3)
+{
+    using element_type = blaze::UnderlyingElement_t<MT>;
+    using pixel_type = typename boost::gil::image_view<Locator>::value_type;
+    using row_type = typename scanline_scaler<element_type, Method>::row_type;
+    static_assert(blaze::IsDenseVector_v<element_type> ||
+                      boost::gil::num_channels<pixel_type>::value == 1,
+                  "scalar matrices can only be scaled into single channel views");
+
+    scanline_scaler<element_type, Method> scaler(method,
+                                                 (~source).columns(),
+                                                 (~source).rows(),
+                                                 destination.width(),
+                                                 destination.height(),
+                                                 a);
+    auto sink = [&destination](std::size_t target_row, const row_type& row) {
+        auto it = destination.row_begin(target_row);
+        for (std::size_t j = 0; j < row.size(); ++j) {
+            if constexpr (blaze::IsDenseVector_v<element_type>) {
+                it[j] = vector_to_pixel<pixel_type>(row[j]);
+            } else {
+                it[j][0] = row[j];
+            }
+        }
+    };
+    for (std::size_t i = 0; i < (~source).rows() && !scaler.finished(); ++i) {
+        scaler.push_row(blaze::row(~source, i), sink);
+    }
+}
 } // namespace flash
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,330 @@
+#ifndef BLAZING_GIL_STRIDED_MATRIX_HPP
+#define BLAZING_GIL_STRIDED_MATRIX_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/core.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace flash
+{
+/// Random access iterator over elements `Stride` apart
+template <typename T, std::size_t Stride>
+class strided_iterator
+{
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_const_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    strided_iterator() = default;
+    explicit strided_iterator(T* position) : position(position) {}
+
+    reference operator*() const { return *position; }
+    pointer operator->() const { return position; }
+    reference operator[](difference_type n) const
+    {
+        return position[n * static_cast<difference_type>(Stride)];
+    }
+
+    strided_iterator& operator++()
+    {
+        position += Stride;
+        return *this;
+    }
+    strided_iterator operator++(int)
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+    strided_iterator& operator--()
+    {
+        position -= Stride;
+        return *this;
+    }
+    strided_iterator operator--(int)
+    {
+        auto copy = *this;
+        --*this;
+        return copy;
+    }
+    strided_iterator& operator+=(difference_type n)
+    {
+        position += n * static_cast<difference_type>(Stride);
+        return *this;
+    }
+    strided_iterator& operator-=(difference_type n) { return *this += -n; }
+
+    friend strided_iterator operator+(strided_iterator it, difference_type n) { return it += n; }
+    friend strided_iterator operator+(difference_type n, strided_iterator it) { return it += n; }
+    friend strided_iterator operator-(strided_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return (lhs.position - rhs.position) / static_cast<difference_type>(Stride);
+    }
+
+    friend bool operator==(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.position == rhs.position;
+    }
+    friend bool operator!=(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.position != rhs.position;
+    }
+    friend bool operator<(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return lhs.position < rhs.position;
+    }
+    friend bool operator>(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return rhs < lhs;
+    }
+    friend bool operator<=(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return !(rhs < lhs);
+    }
+    friend bool operator>=(const strided_iterator& lhs, const strided_iterator& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+  private:
+    T* position = nullptr;
+};
+
+/** \brief Row-major dense matrix whose consecutive elements in a row are `Stride` apart
+
+    Non-owning, semantically like a pointer, just like `CustomMatrix`. It is used to look at a
+    single channel of an interleaved image without copying. As `Stride` is known at compile time,
+    element access compiles to constant stride loads and stores, which compilers vectorize
+    without gathers when Blaze or flash loop over rows. Blaze's own SIMD kernels are disabled for
+    the type, as they require contiguous elements.
+
+    \tparam T The element type, const qualified for read-only matrices
+    \tparam Stride The distance between consecutive elements of a row, in elements
+*/
+template <typename T, std::size_t Stride>
+class strided_matrix : public blaze::DenseMatrix<strided_matrix<T, Stride>, blaze::rowMajor>
+{
+  public:
+    using This = strided_matrix;
+    using BaseType = blaze::DenseMatrix<This, blaze::rowMajor>;
+    using ElementType = std::remove_const_t<T>;
+    using ResultType = blaze::DynamicMatrix<ElementType, blaze::rowMajor>;
+    using OppositeType = blaze::DynamicMatrix<ElementType, blaze::columnMajor>;
+    using TransposeType = blaze::DynamicMatrix<ElementType, blaze::columnMajor>;
+    using ReturnType = const ElementType&;
+    using CompositeType = const This&;
+    using Reference = T&;
+    using ConstReference = const ElementType&;
+    using Pointer = T*;
+    using ConstPointer = const ElementType*;
+    using Iterator = strided_iterator<T, Stride>;
+    using ConstIterator = strided_iterator<const ElementType, Stride>;
+
+    static constexpr bool simdEnabled = false;
+    static constexpr bool smpAssignable = false;
+    static constexpr std::size_t stride = Stride;
+
+    /** \arg data Pointer to the first element
+        \arg rows The number of rows
+        \arg columns The number of columns
+        \arg row_stride The distance between the first elements of consecutive rows, in elements
+    */
+    strided_matrix(T* data, std::size_t rows, std::size_t columns, std::size_t row_stride)
+        : data_(data), rows_(rows), columns_(columns), row_stride_(row_stride)
+    {
+    }
+
+    strided_matrix(const strided_matrix&) = default;
+
+    std::size_t rows() const noexcept { return rows_; }
+    std::size_t columns() const noexcept { return columns_; }
+    std::size_t row_stride() const noexcept { return row_stride_; }
+
+    Reference operator()(std::size_t i, std::size_t j) const noexcept
+    {
+        return data_[i * row_stride_ + j * Stride];
+    }
+
+    Reference at(std::size_t i, std::size_t j) const
+    {
+        if (i >= rows_ || j >= columns_) {
+            throw std::out_of_range("Invalid strided_matrix access index");
+        }
+        return (*this)(i, j);
+    }
+
+    /// pointer to the first element of row `i`
+    Pointer data(std::size_t i) const noexcept { return data_ + i * row_stride_; }
+
+    Iterator begin(std::size_t i) const noexcept { return Iterator(data(i)); }
+    Iterator end(std::size_t i) const noexcept { return Iterator(data(i) + columns_ * Stride); }
+    ConstIterator cbegin(std::size_t i) const noexcept { return ConstIterator(data(i)); }
+    ConstIterator cend(std::size_t i) const noexcept
+    {
+        return ConstIterator(data(i) + columns_ * Stride);
+    }
+
+    /// the right hand side is evaluated first only if it can alias, rows are strided stores
+    template <typename MT, bool SO>
+    strided_matrix& operator=(const blaze::Matrix<MT, SO>& rhs)
+    {
+        check_size(rhs);
+        if ((~rhs).canAlias(this)) {
+            return *this = ResultType(~rhs);
+        }
+        if constexpr (detail::is_row_contiguous_v<MT, SO>) {
+            for (std::size_t i = 0; i < rows_; ++i) {
+                detail::scatter_row<Stride>((~rhs).data(i), columns_, data(i));
+            }
+            return *this;
+        } else {
+            return apply(rhs, [](Reference target, const ElementType& value) { target = value; });
+        }
+    }
+
+    strided_matrix& operator=(const strided_matrix& rhs)
+    {
+        return *this = static_cast<const blaze::Matrix<strided_matrix, blaze::rowMajor>&>(rhs);
+    }
+
+    strided_matrix& operator=(const ElementType& value)
+    {
+        for (std::size_t i = 0; i < rows_; ++i) {
+            auto* row = data(i);
+            for (std::size_t j = 0; j < columns_; ++j) {
+                row[j * Stride] = value;
+            }
+        }
+        return *this;
+    }
+
+    template <typename MT, bool SO>
+    strided_matrix& operator+=(const blaze::Matrix<MT, SO>& rhs)
+    {
+        return apply(rhs, [](Reference target, const ElementType& value) { target += value; });
+    }
+
+    template <typename MT, bool SO>
+    strided_matrix& operator-=(const blaze::Matrix<MT, SO>& rhs)
+    {
+        return apply(rhs, [](Reference target, const ElementType& value) { target -= value; });
+    }
+
+    template <typename MT, bool SO>
+    strided_matrix& operator%=(const blaze::Matrix<MT, SO>& rhs)
+    {
+        return apply(rhs, [](Reference target, const ElementType& value) { target *= value; });
+    }
+
+    template <typename Other>
+    bool canAlias(const Other* alias) const noexcept
+    {
+        return static_cast<const void*>(this) == static_cast<const void*>(alias);
+    }
+
+    /// copies and views of other channels of the same image only share memory, not the address
+    template <typename U, std::size_t OtherStride>
+    bool canAlias(const strided_matrix<U, OtherStride>* alias) const noexcept
+    {
+        if (empty() || alias->empty()) {
+            return false;
+        }
+        const std::less<const void*> less;
+        return less(alias->data(0), end_address()) && less(data(0), alias->end_address());
+    }
+
+    template <typename Other>
+    bool isAliased(const Other* alias) const noexcept
+    {
+        return canAlias(alias);
+    }
+
+    bool isAligned() const noexcept { return false; }
+    bool canSMPAssign() const noexcept { return false; }
+
+  private:
+    template <typename, std::size_t>
+    friend class strided_matrix;
+
+    bool empty() const noexcept { return rows_ == 0 || columns_ == 0; }
+
+    /// one past the last element, only valid for non-empty matrices
+    const void* end_address() const noexcept
+    {
+        return data(rows_ - 1) + (columns_ - 1) * Stride + 1;
+    }
+
+    template <typename MT, bool SO>
+    void check_size(const blaze::Matrix<MT, SO>& rhs) const
+    {
+        if ((~rhs).rows() != rows_ || (~rhs).columns() != columns_) {
+            throw std::invalid_argument("Matrix sizes do not match");
+        }
+    }
+
+    template <typename MT, bool SO, typename Operation>
+    strided_matrix& apply(const blaze::Matrix<MT, SO>& rhs, Operation operation)
+    {
+        check_size(rhs);
+        if ((~rhs).canAlias(this)) {
+            return apply(ResultType(~rhs), operation);
+        }
+        // expensive expressions like products are evaluated once, others are read in place
+        const blaze::CompositeType_t<MT> composite(~rhs);
+        for (std::size_t i = 0; i < rows_; ++i) {
+            auto* row = data(i);
+            for (std::size_t j = 0; j < columns_; ++j) {
+                operation(row[j * Stride], composite(i, j));
+            }
+        }
+        return *this;
+    }
+
+    T* data_;
+    std::size_t rows_;
+    std::size_t columns_;
+    std::size_t row_stride_;
+};
+
+/** \brief Zero-copy matrix of a single channel of an image view
+
+    Like `as_matrix`, changes in the matrix are reflected in the view and vice versa, but works
+    for multi-channel views too. For interleaved views the matrix has element stride equal to
+    the number of channels, for planar views the channel's plane is used directly with stride 1.
+    Row padding of the view is respected.
+
+    \tparam Channel The channel to expose, in the pixel's memory order
+    \tparam View A memory based view without x step, e.g. `gil::view` of an image
+    \arg source The view to take the channel from
+
+    \return `strided_matrix<ChannelType, step>`, `ChannelType` is const for const views
+*/
+template <std::size_t Channel, typename View>
+auto as_channel_matrix(View source)
+{
+    static_assert(Channel < boost::gil::num_channels<View>::value,
+                  "channel index exceeds available channels in the view");
+    static_assert(detail::is_basic_view_v<View>,
+                  "only memory based views without x step can be viewed as a matrix");
+    auto* data = detail::channel_pointer(source, 0, Channel);
+    using element_type = std::remove_pointer_t<decltype(data)>;
+    constexpr auto stride = detail::channel_step_v<View>;
+
+    return strided_matrix<element_type, stride>(data,
+                                                source.height(),
+                                                source.width(),
+                                                source.pixels().row_size() / sizeof(element_type));
+}
+} // namespace flash
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef BLAZING_GIL_TRANSPOSE_HPP
+#define BLAZING_GIL_TRANSPOSE_HPP
+
+#include <blaze/Blaze.h>
+#include <blaze/math/typetraits/IsContiguous.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace flash
+{
+namespace detail
+{
+/// elements the tile kernels move as raw bytes, e.g. scalars, `float16` or 4 byte pixels
+template <typename T>
+constexpr bool is_tile_transposable_v =
+    std::is_trivially_copyable_v<T> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+/// side of the square tiles transposed in registers, 0 when `T` is copied element by element
+template <typename T>
+constexpr std::size_t transpose_tile_v()
+{
+#if defined(__AVX2__)
+    if constexpr (is_tile_transposable_v<T> && sizeof(T) == 4) {
+        return 8;
+    }
+#endif
+#if defined(__SSE2__)
+    if constexpr (is_tile_transposable_v<T>) {
+        return 16 / sizeof(T);
+    }
+#endif
+    return 0;
+}
+
+#if defined(__SSE2__)
+template <std::size_t Size>
+__m128i unpack_low(__m128i lhs, __m128i rhs)
+{
+    if constexpr (Size == 1) {
+        return _mm_unpacklo_epi8(lhs, rhs);
+    } else if constexpr (Size == 2) {
+        return _mm_unpacklo_epi16(lhs, rhs);
+    } else if constexpr (Size == 4) {
+        return _mm_unpacklo_epi32(lhs, rhs);
+    } else {
+        return _mm_unpacklo_epi64(lhs, rhs);
+    }
+}
+
+template <std::size_t Size>
+__m128i unpack_high(__m128i lhs, __m128i rhs)
+{
+    if constexpr (Size == 1) {
+        return _mm_unpackhi_epi8(lhs, rhs);
+    } else if constexpr (Size == 2) {
+        return _mm_unpackhi_epi16(lhs, rhs);
+    } else if constexpr (Size == 4) {
+        return _mm_unpackhi_epi32(lhs, rhs);
+    } else {
+        return _mm_unpackhi_epi64(lhs, rhs);
+    }
+}
+
+/* Transposes a tile of `16 / Size` rows of 16 bytes. Interleaving row `i` with row `i + n / 2`
+   into rows `2i` and `2i + 1` rotates the bits of the (row, column) index of every element by
+   one, after log2(n) rounds row and column bits have swapped places. Strides are in bytes.
+*/
+template <std::size_t Size>
+void transpose_tile_sse2(const char* source, std::size_t source_stride, char* target,
+                         std::size_t target_stride)
+{
+    constexpr std::size_t n = 16 / Size;
+    __m128i rows[n];
+    __m128i interleaved[n];
+    for (std::size_t i = 0; i < n; ++i) {
+        rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * source_stride));
+    }
+    for (std::size_t round = 1; round < n; round *= 2) {
+        for (std::size_t i = 0; i < n / 2; ++i) {
+            interleaved[2 * i] = unpack_low<Size>(rows[i], rows[i + n / 2]);
+            interleaved[2 * i + 1] = unpack_high<Size>(rows[i], rows[i + n / 2]);
+        }
+        std::copy_n(interleaved, n, rows);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * target_stride), rows[i]);
+    }
+}
+#endif
+
+#if defined(__AVX2__)
+/// 8x8 tile of 4 byte elements, unpacks within 128 bit lanes and swaps lanes last
+inline void transpose_tile_avx2(const char* source, std::size_t source_stride, char* target,
+                                std::size_t target_stride)
+{
+    __m256i rows[8];
+    for (std::size_t i = 0; i < 8; ++i) {
+        rows[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * source_stride));
+    }
+    __m256i pairs[8];
+    for (std::size_t i = 0; i < 8; i += 2) {
+        pairs[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+        pairs[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+    }
+    __m256i quads[8];
+    for (std::size_t i = 0; i < 8; i += 4) {
+        quads[i] = _mm256_unpacklo_epi64(pairs[i], pairs[i + 2]);
+        quads[i + 1] = _mm256_unpackhi_epi64(pairs[i], pairs[i + 2]);
+        quads[i + 2] = _mm256_unpacklo_epi64(pairs[i + 1], pairs[i + 3]);
+        quads[i + 3] = _mm256_unpackhi_epi64(pairs[i + 1], pairs[i + 3]);
+    }
+    for (std::size_t i = 0; i < 4; ++i) {
+        const auto low = _mm256_permute2x128_si256(quads[i], quads[i + 4], 0x20);
+        const auto high = _mm256_permute2x128_si256(quads[i], quads[i + 4], 0x31);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * target_stride), low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + (i + 4) * target_stride), high);
+    }
+}
+#endif
+
+/// transposes a square tile of `transpose_tile_v<T>()` elements, strides are in elements
+template <typename T>
+void transpose_tile(const T* source, std::size_t source_stride, T* target,
+                    std::size_t target_stride)
+{
+    [[maybe_unused]] const auto* from = reinterpret_cast<const char*>(source);
+    [[maybe_unused]] auto* to = reinterpret_cast<char*>(target);
+#if defined(__AVX2__)
+    if constexpr (sizeof(T) == 4) {
+        transpose_tile_avx2(from, source_stride * sizeof(T), to, target_stride * sizeof(T));
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    transpose_tile_sse2<sizeof(T)>(from, source_stride * sizeof(T), to, target_stride * sizeof(T));
+#endif
+}
+
+/// `target[j * target_stride + i] = source[i * source_stride + j]`, tile by tile
+template <typename T>
+void transpose_block(const T* source, std::size_t source_stride, T* target,
+                     std::size_t target_stride, std::size_t rows, std::size_t columns)
+{
+    constexpr auto tile = transpose_tile_v<T>();
+    std::size_t i = 0;
+    if constexpr (tile != 0) {
+        for (; i + tile <= rows; i += tile) {
+            std::size_t j = 0;
+            for (; j + tile <= columns; j += tile) {
+                transpose_tile(source + i * source_stride + j,
+                               source_stride,
+                               target + j * target_stride + i,
+                               target_stride);
+            }
+            for (; j < columns; ++j) {
+                for (std::size_t k = i; k < i + tile; ++k) {
+                    target[j * target_stride + k] = source[k * source_stride + j];
+                }
+            }
+        }
+    }
+    for (; i < rows; ++i) {
+        for (std::size_t j = 0; j < columns; ++j) {
+            target[j * target_stride + i] = source[i * source_stride + j];
+        }
+    }
+}
+
+/** \brief Transposes `rows` lines of `columns` elements into `columns` lines of `rows` elements
+
+    Cache oblivious: the longer side is halved until both source and target blocks fit into the
+    first level cache, whatever its size, so that every loaded cache line is used completely
+    before being evicted. Blocks are then transposed in register tiles by `transpose_block`.
+*/
+template <typename T>
+void transpose_buffer(const T* source, std::size_t source_stride, T* target,
+                      std::size_t target_stride, std::size_t rows, std::size_t columns)
+{
+    constexpr std::size_t leaf = sizeof(T) <= 4 ? 64 : 32;
+    constexpr std::size_t tile = std::max<std::size_t>(transpose_tile_v<T>(), 1);
+    if (rows <= leaf && columns <= leaf) {
+        transpose_block(source, source_stride, target, target_stride, rows, columns);
+    } else if (rows >= columns) {
+        // halves stay multiples of the tile, so that only the last block has partial tiles
+        const auto half = (rows / 2 + tile - 1) / tile * tile;
+        transpose_buffer(source, source_stride, target, target_stride, half, columns);
+        transpose_buffer(source + half * source_stride,
+                         source_stride,
+                         target + half,
+                         target_stride,
+                         rows - half,
+                         columns);
+    } else {
+        const auto half = (columns / 2 + tile - 1) / tile * tile;
+        transpose_buffer(source, source_stride, target, target_stride, rows, half);
+        transpose_buffer(source + half,
+                         source_stride,
+                         target + half * target_stride,
+                         target_stride,
+                         rows,
+                         columns - half);
+    }
+}
+
+/** \brief Transposes the storage of `source` into `target`, whose layout must be the opposite
+
+    Element `k` of line (row or column, depending on the storage order) `l` of `source` becomes
+    element `l` of line `k` of `target`. Expressions are evaluated first.
+*/
+template <typename MT, bool SO, typename Target>
+void transpose_storage(const blaze::DenseMatrix<MT, SO>& source, Target& target)
+{
+    if constexpr (blaze::IsContiguous_v<MT>) {
+        const auto lines = SO == blaze::rowMajor ? (~source).rows() : (~source).columns();
+        const auto length = SO == blaze::rowMajor ? (~source).columns() : (~source).rows();
+        transpose_buffer(
+            (~source).data(), (~source).spacing(), target.data(), target.spacing(), lines, length);
+    } else {
+        const blaze::DynamicMatrix<std::remove_cv_t<blaze::ElementType_t<MT>>, SO> evaluated(
+            ~source);
+        transpose_storage(evaluated, target);
+    }
+}
+} // namespace detail
+
+/** \brief The transpose of `source`, computed in cache sized blocks of register tiles
+
+    Tiles are 16x16 for 1 byte elements, 8x8 for 2 and 4 byte elements (AVX2, otherwise 4x4)
+    and 2x2 for 8 byte ones, which covers scalars as well as trivially copyable unpadded pixels
+    like `StaticVector<std::uint8_t, 4, columnVector, unaligned, unpadded>`. Blaze pads
+    `StaticVector`s by default, e.g. to 16 bytes for 4 `std::uint8_t`, such elements are copied
+    one by one, but still block by block.
+
+    \return A `DynamicMatrix` of the storage order of `source`
+*/
+template <typename MT, bool SO>
+auto transpose(const blaze::DenseMatrix<MT, SO>& source)
+{
+    using element_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    blaze::DynamicMatrix<element_type, SO> result((~source).columns(), (~source).rows());
+    detail::transpose_storage(source, result);
+    return result;
+}
+
+/** \brief Copy of `source` in the storage order `Order`
+
+    Changing the storage order transposes the memory layout, which is done blockwise as in
+    `transpose` instead of by Blaze's element wise assignment.
+
+    \return A `DynamicMatrix` of `Order` with the elements of `source`
+*/
+template <bool Order, typename MT, bool SO>
+auto to_storage_order(const blaze::DenseMatrix<MT, SO>& source)
+{
+    using element_type = std::remove_cv_t<blaze::ElementType_t<MT>>;
+    if constexpr (Order == SO) {
+        return blaze::DynamicMatrix<element_type, Order>(~source);
+    } else {
+        blaze::DynamicMatrix<element_type, Order> result((~source).rows(), (~source).columns());
+        detail::transpose_storage(source, result);
+        return result;
+    }
+}
+} // namespace flash
+
+#endif
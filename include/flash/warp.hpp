@@ -0,0 +1,321 @@
+#ifndef BLAZING_GIL_WARP_HPP
+#define BLAZING_GIL_WARP_HPP
+
+#include <blaze/Blaze.h>
+
+#include <flash/core.hpp>
+#include <flash/parallel.hpp>
+#include <flash/scaling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace flash
+{
+/// Maps source coordinates (x, y, 1) to destination coordinates
+using affine_transform = blaze::StaticMatrix<double, 2, 3>;
+/// Maps homogeneous source coordinates (x, y, 1) to homogeneous destination coordinates
+using perspective_transform = blaze::StaticMatrix<double, 3, 3>;
+
+/** \brief Precomputed source coordinates for every destination pixel
+
+    Coordinates are stored in 48.16 fixed point and laid out tile by tile, so that warping a
+    tile reads a contiguous part of the table. The table only depends on the transform and
+    destination size, thus it can be built once and reused for every frame warped with the same
+    transform.
+*/
+struct remap_table {
+    /// 64 bit, so that coordinates in sources wider or taller than 16384 pixels are exact
+    using coordinate_type = std::int64_t;
+    static constexpr int fraction_bits = 16;
+    static constexpr coordinate_type one = coordinate_type(1) << fraction_bits;
+
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::size_t tile_size = 0;
+    std::vector<coordinate_type> x;
+    std::vector<coordinate_type> y;
+
+    std::size_t tile_rows() const { return (height + tile_size - 1) / tile_size; }
+    std::size_t tile_columns() const { return (width + tile_size - 1) / tile_size; }
+
+    /// offset of the first entry of the tile in `x` and `y`
+    std::size_t tile_offset(std::size_t tile_row, std::size_t tile_column) const
+    {
+        const auto first_row = tile_row * tile_size;
+        const auto tile_height = std::min(tile_size, height - first_row);
+        return first_row * width + tile_column * tile_size * tile_height;
+    }
+};
+
+namespace detail
+{
+inline remap_table::coordinate_type to_fixed_point(double coordinate)
+{
+    // keep far away points far away instead of overflowing into the image, 2^30 pixels
+    constexpr double limit = static_cast<double>(remap_table::coordinate_type(1) << 46);
+    return static_cast<remap_table::coordinate_type>(
+        std::floor(std::clamp(coordinate * remap_table::one, -limit, limit) + 0.5));
+}
+
+template <typename Mapping>
+remap_table make_remap_table(std::size_t width, std::size_t height, std::size_t tile_size,
+                             Mapping mapping)
+{
+    if (tile_size == 0) {
+        throw std::invalid_argument("tile size must be positive");
+    }
+    remap_table table;
+    table.width = width;
+    table.height = height;
+    table.tile_size = tile_size;
+    table.x.resize(width * height);
+    table.y.resize(width * height);
+
+    const auto tile_columns = table.tile_columns();
+    parallel_for(0, table.tile_rows() * tile_columns, [&table, &mapping, tile_columns](auto tile) {
+        const auto tile_row = tile / tile_columns;
+        const auto tile_column = tile % tile_columns;
+        const auto first_row = tile_row * table.tile_size;
+        const auto first_column = tile_column * table.tile_size;
+        const auto last_row = std::min(first_row + table.tile_size, table.height);
+        const auto last_column = std::min(first_column + table.tile_size, table.width);
+
+        auto offset = table.tile_offset(tile_row, tile_column);
+        for (auto i = first_row; i < last_row; ++i) {
+            for (auto j = first_column; j < last_column; ++j, ++offset) {
+                const auto [source_x, source_y] = mapping(static_cast<double>(j),
+                                                          static_cast<double>(i));
+                table.x[offset] = to_fixed_point(source_x);
+                table.y[offset] = to_fixed_point(source_y);
+            }
+        }
+    });
+
+    return table;
+}
+
+template <typename MT, typename Accumulator>
+bool fetch(const MT& source, signed_size i, signed_size j, Accumulator& value)
+{
+    if (i < 0 || j < 0 || i >= static_cast<signed_size>(source.rows()) ||
+        j >= static_cast<signed_size>(source.columns())) {
+        return false;
+    }
+    value = source(i, j);
+    return true;
+}
+
+template <typename MT, typename Accumulator>
+Accumulator sample(nearest_neighbor, const MT& source, remap_table::coordinate_type x,
+                   remap_table::coordinate_type y, const Accumulator& border_value, signed_size)
+{
+    Accumulator result = border_value;
+    fetch(source, (y + remap_table::one / 2) >> remap_table::fraction_bits,
+          (x + remap_table::one / 2) >> remap_table::fraction_bits, result);
+    return result;
+}
+
+template <typename MT, typename Accumulator>
+Accumulator sample(bilinear_interpolation, const MT& source, remap_table::coordinate_type x,
+                   remap_table::coordinate_type y, const Accumulator& border_value, signed_size)
+{
+    const signed_size i = y >> remap_table::fraction_bits;
+    const signed_size j = x >> remap_table::fraction_bits;
+    const double fraction_y = (y & (remap_table::one - 1)) / static_cast<double>(remap_table::one);
+    const double fraction_x = (x & (remap_table::one - 1)) / static_cast<double>(remap_table::one);
+
+    Accumulator a = border_value;
+    Accumulator b = border_value;
+    Accumulator c = border_value;
+    Accumulator d = border_value;
+    fetch(source, i, j, a);
+    fetch(source, i, j + 1, b);
+    fetch(source, i + 1, j, c);
+    fetch(source, i + 1, j + 1, d);
+    return Accumulator((a * (1 - fraction_x) + b * fraction_x) * (1 - fraction_y) +
+                       (c * (1 - fraction_x) + d * fraction_x) * fraction_y);
+}
+
+template <typename MT, typename Accumulator>
+Accumulator sample(lanczos_method, const MT& source, remap_table::coordinate_type x,
+                   remap_table::coordinate_type y, const Accumulator& border_value, signed_size a)
+{
+    const signed_size i = y >> remap_table::fraction_bits;
+    const signed_size j = x >> remap_table::fraction_bits;
+    const double center_y = y / static_cast<double>(remap_table::one);
+    const double center_x = x / static_cast<double>(remap_table::one);
+
+    Accumulator result{};
+    double total_weight = 0;
+    for (auto ii = i - a + 1; ii <= i + a; ++ii) {
+        const double weight_y = lanczos(center_y - ii, a);
+        for (auto jj = j - a + 1; jj <= j + a; ++jj) {
+            const double weight = weight_y * lanczos(center_x - jj, a);
+            Accumulator value = border_value;
+            fetch(source, ii, jj, value);
+            result += weight * value;
+            total_weight += weight;
+        }
+    }
+    if (total_weight != 0) {
+        result /= total_weight;
+    }
+    return result;
+}
+} // namespace detail
+
+/** \brief Builds remap table for an affine transform
+
+    \arg transform Maps source coordinates to destination coordinates, it is inverted internally
+    \arg width The width of the destination
+    \arg height The height of the destination
+    \arg tile_size The side of square tiles the destination is processed in
+*/
+inline remap_table make_remap_table(const affine_transform& transform, std::size_t width,
+                                    std::size_t height, std::size_t tile_size = 64)
+{
+    const double determinant =
+        transform(0, 0) * transform(1, 1) - transform(0, 1) * transform(1, 0);
+    if (determinant == 0) {
+        throw std::invalid_argument("affine transform is not invertible");
+    }
+    // inverse of the linear part, then the translation mapped back
+    const double a = transform(1, 1) / determinant;
+    const double b = -transform(0, 1) / determinant;
+    const double c = -transform(1, 0) / determinant;
+    const double d = transform(0, 0) / determinant;
+    const double tx = -(a * transform(0, 2) + b * transform(1, 2));
+    const double ty = -(c * transform(0, 2) + d * transform(1, 2));
+
+    return detail::make_remap_table(width, height, tile_size, [=](double x, double y) {
+        return std::pair<double, double>{a * x + b * y + tx, c * x + d * y + ty};
+    });
+}
+
+/** \brief Builds remap table for a perspective transform
+
+    \arg transform Maps homogeneous source coordinates to destination coordinates, it is
+    inverted internally
+    \arg width The width of the destination
+    \arg height The height of the destination
+    \arg tile_size The side of square tiles the destination is processed in
+*/
+inline remap_table make_remap_table(const perspective_transform& transform, std::size_t width,
+                                    std::size_t height, std::size_t tile_size = 64)
+{
+    const auto& m = transform;
+    // adjugate, division by determinant is unnecessary for homogeneous coordinates
+    perspective_transform inverse{
+        {m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1),
+         m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2),
+         m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1)},
+        {m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2),
+         m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0),
+         m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2)},
+        {m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0),
+         m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1),
+         m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)}};
+    const double determinant =
+        m(0, 0) * inverse(0, 0) + m(0, 1) * inverse(1, 0) + m(0, 2) * inverse(2, 0);
+    if (determinant == 0) {
+        throw std::invalid_argument("perspective transform is not invertible");
+    }
+
+    return detail::make_remap_table(width, height, tile_size, [inverse](double x, double y) {
+        const double w = inverse(2, 0) * x + inverse(2, 1) * y + inverse(2, 2);
+        if (w == 0) {
+            // points on the horizon line map to infinity, send them outside the source
+            return std::pair<double, double>{-1e9, -1e9};
+        }
+        const double source_x = inverse(0, 0) * x + inverse(0, 1) * y + inverse(0, 2);
+        const double source_y = inverse(1, 0) * x + inverse(1, 1) * y + inverse(1, 2);
+        return std::pair<double, double>{source_x / w, source_y / w};
+    });
+}
+
+/** \brief Resamples `source` at coordinates stored in `table`
+
+    Tiles of the destination are processed on multiple threads. Samples that fall outside of
+    the source take `border_value`.
+
+    \tparam Method One of `nearest_neighbor`, `bilinear_interpolation` or `lanczos_method`
+    \arg source The matrix to warp, either with scalar or `StaticVector` elements
+    \arg table Remap table built by `make_remap_table`
+    \arg border_value The value of the samples outside of the source
+    \arg a The Lanczos window size, ignored by other methods
+
+    \return A `DynamicMatrix` with `table.height` rows and `table.width` columns
+*/
+template <typename Method, typename MT, bool SO>
+auto warp(const blaze::DenseMatrix<MT, SO>& source, const remap_table& table, Method method,
+          const blaze::UnderlyingElement_t<MT>& border_value = {}, signed_size a = 3)
+{
+    using element_type = blaze::UnderlyingElement_t<MT>;
+    using accumulator_type = detail::resampling_accumulator_t<element_type>;
+
+    const auto& matrix = ~source;
+    const accumulator_type border(border_value);
+    blaze::DynamicMatrix<element_type> result(table.height, table.width);
+    const auto tile_columns = table.tile_columns();
+    parallel_for(0, table.tile_rows() * tile_columns, [&](std::size_t tile) {
+        const auto tile_row = tile / tile_columns;
+        const auto tile_column = tile % tile_columns;
+        const auto first_row = tile_row * table.tile_size;
+        const auto first_column = tile_column * table.tile_size;
+        const auto last_row = std::min(first_row + table.tile_size, table.height);
+        const auto last_column = std::min(first_column + table.tile_size, table.width);
+
+        auto offset = table.tile_offset(tile_row, tile_column);
+        for (auto i = first_row; i < last_row; ++i) {
+            for (auto j = first_column; j < last_column; ++j, ++offset) {
+                result(i, j) = detail::from_accumulator<element_type>(
+                    detail::sample(method, matrix, table.x[offset], table.y[offset], border, a));
+            }
+        }
+    });
+
+    return result;
+}
+
+/** \brief Applies affine transform to `source`
+
+    Convenience function that builds remap table and warps. When the same transform is applied
+    to many frames, build the table once with `make_remap_table` and call `warp` instead.
+
+    \arg transform Maps source coordinates to destination coordinates
+    \arg width The width of the result
+    \arg height The height of the result
+*/
+template <typename Method, typename MT, bool SO>
+auto warp_affine(const blaze::DenseMatrix<MT, SO>& source, const affine_transform& transform,
+                 std::size_t width, std::size_t height, Method method,
+                 const blaze::UnderlyingElement_t<MT>& border_value = {}, signed_size a = 3)
+{
+    return warp(source, make_remap_table(transform, width, height), method, border_value, a);
+}
+
+/** \brief Applies perspective transform to `source`
+
+    Convenience function that builds remap table and warps. When the same transform is applied
+    to many frames, build the table once with `make_remap_table` and call `warp` instead.
+
+    \arg transform Maps homogeneous source coordinates to destination coordinates
+    \arg width The width of the result
+    \arg height The height of the result
+*/
+template <typename Method, typename MT, bool SO>
+auto warp_perspective(const blaze::DenseMatrix<MT, SO>& source,
+                      const perspective_transform& transform, std::size_t width,
+                      std::size_t height, Method method,
+                      const blaze::UnderlyingElement_t<MT>& border_value = {}, signed_size a = 3)
+{
+    return warp(source, make_remap_table(transform, width, height), method, border_value, a);
+}
+} // namespace flash
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef BLAZING_GIL_WORKSPACE_HPP
+#define BLAZING_GIL_WORKSPACE_HPP
+
+#include <blaze/Blaze.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace flash
+{
+/** \brief Arena handing out matrices for intermediate and final results of flash operations
+
+    Buffers are carved out of big 64 byte aligned chunks by bumping an offset, and are all
+    released at once by `reset`, typically between frames. `reset` also merges the chunks
+    allocated during the frame into a single one of the total size, so that once a frame of a
+    given size was processed, processing another one of the same size allocates nothing.
+
+    Matrices returned by `matrix` are non-owning `CustomMatrix`es, semantically like pointers:
+    they are valid until the next `reset` or the destruction of the workspace, whichever comes
+    first. Operations taking a workspace return such matrices too.
+*/
+class workspace
+{
+  public:
+    /// alignment of every buffer, enough for the widest SIMD registers (AVX-512)
+    static constexpr std::size_t alignment = 64;
+
+    template <typename T, bool SO = blaze::rowMajor>
+    using matrix_type = blaze::CustomMatrix<T, blaze::aligned, blaze::padded, SO>;
+
+    /// \arg initial_capacity Bytes to preallocate, e.g. the `high_water_mark` of a previous run
+    explicit workspace(std::size_t initial_capacity = 0)
+    {
+        if (initial_capacity != 0) {
+            add_chunk(initial_capacity);
+        }
+    }
+
+    workspace(const workspace&) = delete;
+    workspace& operator=(const workspace&) = delete;
+    workspace(workspace&&) noexcept = default;
+    workspace& operator=(workspace&&) noexcept = default;
+
+    /** \brief `rows` by `columns` matrix of value initialized elements, zeros for arithmetic
+        types and `StaticVector`s
+
+        Rows (columns for column major matrices) are padded as Blaze expects of `padded`
+        matrices, and the padding is zeroed too.
+    */
+    template <typename T, bool SO = blaze::rowMajor>
+    matrix_type<T, SO> matrix(std::size_t rows, std::size_t columns)
+    {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "workspace never destroys elements, they must be trivially destructible");
+        const auto lines = SO == blaze::rowMajor ? rows : columns;
+        const auto line_length = SO == blaze::rowMajor ? columns : rows;
+        const auto spacing = blaze::nextMultiple(line_length, blaze::SIMDTrait<T>::size);
+        const auto count = lines * spacing;
+
+        auto* data = static_cast<T*>(allocate(std::max<std::size_t>(count, 1) * sizeof(T)));
+        std::uninitialized_value_construct_n(data, count);
+        return matrix_type<T, SO>(data, rows, columns, spacing);
+    }
+
+    /// invalidates every matrix handed out so far and makes their memory available again
+    void reset()
+    {
+        if (chunks.size() > 1) {
+            std::size_t total = 0;
+            for (const auto& current : chunks) {
+                total += current.size;
+            }
+            chunks.clear();
+            add_chunk(total);
+        } else if (!chunks.empty()) {
+            chunks.front().used = 0;
+        }
+        in_use = 0;
+    }
+
+    /// bytes handed out since the last `reset`, including alignment
+    std::size_t used() const noexcept { return in_use; }
+
+    /// bytes owned by the workspace
+    std::size_t capacity() const noexcept
+    {
+        std::size_t total = 0;
+        for (const auto& current : chunks) {
+            total += current.size;
+        }
+        return total;
+    }
+
+    /// the largest `used` ever observed, a good `initial_capacity` for later workspaces
+    std::size_t high_water_mark() const noexcept { return peak; }
+
+  private:
+    struct chunk_deleter {
+        void operator()(std::byte* memory) const noexcept
+        {
+            ::operator delete(memory, std::align_val_t(alignment));
+        }
+    };
+
+    struct chunk {
+        std::unique_ptr<std::byte[], chunk_deleter> memory;
+        std::size_t size;
+        std::size_t used;
+    };
+
+    static std::size_t round_up(std::size_t size) noexcept
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    void add_chunk(std::size_t size)
+    {
+        size = round_up(size);
+        auto* memory = static_cast<std::byte*>(::operator new(size, std::align_val_t(alignment)));
+        chunks.push_back(chunk{std::unique_ptr<std::byte[], chunk_deleter>(memory), size, 0});
+    }
+
+    void* allocate(std::size_t size)
+    {
+        size = round_up(size);
+        if (chunks.empty() || chunks.back().size - chunks.back().used < size) {
+            // geometric growth keeps the number of chunks of a frame logarithmic
+            add_chunk(std::max(size, chunks.empty() ? size : 2 * chunks.back().size));
+        }
+        auto& current = chunks.back();
+        auto* result = current.memory.get() + current.used;
+        current.used += size;
+        in_use += size;
+        peak = std::max(peak, in_use);
+        return result;
+    }
+
+    std::vector<chunk> chunks;
+    std::size_t in_use = 0;
+    std::size_t peak = 0;
+};
+} // namespace flash
+
+#endif
@@ -0,0 +1,172 @@
+#include <flash/dispatch_table.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace flash
+{
+namespace dispatch
+{
+extern const kernel_table baseline_kernels;
+#if defined(FLASH_DISPATCH_SSE42)
+extern const kernel_table sse42_kernels;
+#endif
+#if defined(FLASH_DISPATCH_AVX2)
+extern const kernel_table avx2_kernels;
+#endif
+#if defined(FLASH_DISPATCH_AVX512)
+extern const kernel_table avx512_kernels;
+#endif
+
+namespace
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+isa query_isa() noexcept
+{
+    int registers[4];
+    __cpuid(registers, 0);
+    const int highest = registers[0];
+    if (highest < 1) {
+        return isa::baseline;
+    }
+    // every feature the compiler may use for a variant is checked, not only the headline one
+    auto has = [](int value, int bit) { return (value & (1 << bit)) != 0; };
+    __cpuidex(registers, 1, 0);
+    const int features = registers[2];
+    const bool sse42 = has(features, 20) && has(features, 23); // popcnt
+    const bool osxsave = has(features, 27);
+    const bool avx = has(features, 28) && has(features, 12) && has(features, 29); // fma, f16c
+    if (!sse42) {
+        return isa::baseline;
+    }
+    if (!osxsave || !avx) {
+        return isa::sse42;
+    }
+    // the operating system must save the YMM (and for AVX-512 the ZMM and mask) state
+    const auto xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6 || highest < 7) {
+        return isa::sse42;
+    }
+    __cpuidex(registers, 7, 0);
+    const int extended = registers[1];
+    const bool avx2 = has(extended, 5) && has(extended, 3) && has(extended, 8); // bmi, bmi2
+    // avx512f, avx512dq, avx512bw and avx512vl
+    const bool avx512 =
+        has(extended, 16) && has(extended, 17) && has(extended, 30) && has(extended, 31);
+    if (!avx2) {
+        return isa::sse42;
+    }
+    if (avx512 && (xcr0 & 0xe6) == 0xe6) {
+        return isa::avx512;
+    }
+    return isa::avx2;
+}
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+isa query_isa() noexcept
+{
+    // also checks that the operating system saves the extended register state. Every feature
+    // the compiler may use for a variant is checked (see CMakeLists.txt), as virtual machines
+    // can mask single features while reporting AVX2
+    __builtin_cpu_init();
+    const bool sse42 = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    const bool avx2 = sse42 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                      __builtin_cpu_supports("f16c") && __builtin_cpu_supports("bmi") &&
+                      __builtin_cpu_supports("bmi2");
+    const bool avx512 = avx2 && __builtin_cpu_supports("avx512f") &&
+                        __builtin_cpu_supports("avx512bw") &&
+                        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq");
+    if (avx512) {
+        return isa::avx512;
+    }
+    if (avx2) {
+        return isa::avx2;
+    }
+    if (sse42) {
+        return isa::sse42;
+    }
+    return isa::baseline;
+}
+#else
+isa query_isa() noexcept { return isa::baseline; }
+#endif
+
+/// the level named by `FLASH_ISA`, or `fallback` if it is unset or unknown
+isa requested_isa(isa fallback) noexcept
+{
+    const char* name = std::getenv("FLASH_ISA");
+    if (name == nullptr) {
+        return fallback;
+    }
+    for (auto level : {isa::baseline, isa::sse42, isa::avx2, isa::avx512}) {
+        if (std::strcmp(name, isa_name(level)) == 0) {
+            return level;
+        }
+    }
+    return fallback;
+}
+} // namespace
+
+isa detected_isa() noexcept
+{
+    static const isa level = query_isa();
+    return level;
+}
+
+isa active_isa() noexcept { return kernels().level; }
+
+const kernel_table& kernels() noexcept
+{
+    static const kernel_table& table = []() -> const kernel_table& {
+        const auto detected = detected_isa();
+        const auto requested = requested_isa(detected);
+        return kernels(requested < detected ? requested : detected);
+    }();
+    return table;
+}
+
+const kernel_table& kernels(isa level) noexcept
+{
+    switch (level) {
+    case isa::avx512:
+#if defined(FLASH_DISPATCH_AVX512)
+        return avx512_kernels;
+#endif
+        [[fallthrough]];
+    case isa::avx2:
+#if defined(FLASH_DISPATCH_AVX2)
+        return avx2_kernels;
+#endif
+        [[fallthrough]];
+    case isa::sse42:
+#if defined(FLASH_DISPATCH_SSE42)
+        return sse42_kernels;
+#endif
+        [[fallthrough]];
+    case isa::baseline:
+        break;
+    }
+    return baseline_kernels;
+}
+
+const char* isa_name(isa level) noexcept
+{
+    switch (level) {
+    case isa::sse42:
+        return "sse4.2";
+    case isa::avx2:
+        return "avx2";
+    case isa::avx512:
+        return "avx512";
+    case isa::baseline:
+        break;
+    }
+    return "baseline";
+}
+} // namespace dispatch
+} // namespace flash
@@ -0,0 +1,10 @@
+#include "kernels_impl.hpp"
+
+namespace flash
+{
+namespace dispatch
+{
+extern const kernel_table avx2_kernels;
+const kernel_table avx2_kernels = make_kernel_table(isa::avx2);
+} // namespace dispatch
+} // namespace flash
@@ -0,0 +1,10 @@
+#include "kernels_impl.hpp"
+
+namespace flash
+{
+namespace dispatch
+{
+extern const kernel_table avx512_kernels;
+const kernel_table avx512_kernels = make_kernel_table(isa::avx512);
+} // namespace dispatch
+} // namespace flash
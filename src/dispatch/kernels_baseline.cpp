@@ -0,0 +1,10 @@
+#include "kernels_impl.hpp"
+
+namespace flash
+{
+namespace dispatch
+{
+extern const kernel_table baseline_kernels;
+const kernel_table baseline_kernels = make_kernel_table(isa::baseline);
+} // namespace dispatch
+} // namespace flash
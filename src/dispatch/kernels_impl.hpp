@@ -0,0 +1,146 @@
+/* Kernel implementations shared by every instruction set variant of blazing-gil-dispatch.
+
+   Included once per variant translation unit, each compiled with its own -m flags. Everything
+   here has internal linkage, and nothing but plain loops and builtins is used, so that the
+   compiler vectorizes each copy for its instruction set and no copy can be picked by the linker
+   for another variant. Do not include flash or Blaze headers here.
+*/
+#ifndef BLAZING_GIL_DISPATCH_KERNELS_IMPL_HPP
+#define BLAZING_GIL_DISPATCH_KERNELS_IMPL_HPP
+
+#include <flash/dispatch_table.hpp>
+
+#include <cstddef>
+#include <cstdint>
+// expf of libm instead of std::exp, an inline function shared by every variant
+#include <math.h>
+
+namespace flash
+{
+namespace dispatch
+{
+namespace
+{
+template <typename T>
+T clamp_value(T value, T low, T high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+template <typename T>
+void saturate_round_u8(const T* source, std::uint8_t* target, std::size_t count)
+{
+    for (std::size_t j = 0; j < count; ++j) {
+        // clamped values are not negative, so rounding half away from zero rounds the fraction
+        // left by truncation up from a half, adding a half first is inexact for 0.49999997f
+        const T value = clamp_value(source[j], T(0), T(255));
+        const auto whole = static_cast<std::uint8_t>(value);
+        const T fraction = value - static_cast<T>(whole);
+        target[j] = static_cast<std::uint8_t>(whole + (fraction >= T(0.5) ? 1 : 0));
+    }
+}
+
+void saturate_round_f32_u8(const float* source, std::uint8_t* target, std::size_t count)
+{
+    saturate_round_u8(source, target, count);
+}
+
+void saturate_round_f64_u8(const double* source, std::uint8_t* target, std::size_t count)
+{
+    saturate_round_u8(source, target, count);
+}
+
+float convolve_at(const float* above, const float* middle, const float* below,
+                  const float* kernel, std::size_t left, std::size_t center, std::size_t right)
+{
+    return kernel[0] * above[left] + kernel[1] * above[center] + kernel[2] * above[right] +
+           kernel[3] * middle[left] + kernel[4] * middle[center] + kernel[5] * middle[right] +
+           kernel[6] * below[left] + kernel[7] * below[center] + kernel[8] * below[right];
+}
+
+void convolve_3x3_f32(const float* above, const float* middle, const float* below,
+                      const float* kernel, float* target, std::size_t columns)
+{
+    if (columns == 0) {
+        return;
+    }
+    const auto last = columns - 1;
+    target[0] = convolve_at(above, middle, below, kernel, 0, 0, last > 0 ? 1 : 0);
+    // branch free interior, vectorized
+    for (std::size_t j = 1; j < last; ++j) {
+        target[j] = convolve_at(above, middle, below, kernel, j - 1, j, j + 1);
+    }
+    if (last > 0) {
+        target[last] = convolve_at(above, middle, below, kernel, last - 1, last, last);
+    }
+}
+
+void resample_row_f32(const float* source, const std::size_t* first, const float* weights,
+                      std::size_t taps, float* target, std::size_t count)
+{
+    for (std::size_t j = 0; j < count; ++j) {
+        const float* samples = source + first[j];
+        const float* sample_weights = weights + j * taps;
+        float sum = 0;
+        for (std::size_t k = 0; k < taps; ++k) {
+            sum += sample_weights[k] * samples[k];
+        }
+        target[j] = sum;
+    }
+}
+
+void accumulate_row_f32(const float* source, float weight, float* target, std::size_t count)
+{
+    for (std::size_t j = 0; j < count; ++j) {
+        target[j] += weight * source[j];
+    }
+}
+
+float flux(float difference, float inverse_kappa)
+{
+    const float scaled = difference * inverse_kappa;
+    return difference * expf(-(scaled * scaled));
+}
+
+float diffuse_at(const float* above, const float* middle, const float* below, std::size_t left,
+                 std::size_t center, std::size_t right, float step, float inverse_kappa)
+{
+    const float value = middle[center];
+    return value + step * (flux(above[center] - value, inverse_kappa) +
+                           flux(below[center] - value, inverse_kappa) +
+                           flux(middle[left] - value, inverse_kappa) +
+                           flux(middle[right] - value, inverse_kappa));
+}
+
+void diffuse_row_f32(const float* above, const float* middle, const float* below, float* target,
+                     std::size_t columns, float step, float inverse_kappa)
+{
+    if (columns == 0) {
+        return;
+    }
+    const auto last = columns - 1;
+    target[0] = diffuse_at(above, middle, below, 0, 0, last > 0 ? 1 : 0, step, inverse_kappa);
+    for (std::size_t j = 1; j < last; ++j) {
+        target[j] = diffuse_at(above, middle, below, j - 1, j, j + 1, step, inverse_kappa);
+    }
+    if (last > 0) {
+        target[last] =
+            diffuse_at(above, middle, below, last - 1, last, last, step, inverse_kappa);
+    }
+}
+
+constexpr kernel_table make_kernel_table(isa level)
+{
+    return kernel_table{level,
+                        saturate_round_f32_u8,
+                        saturate_round_f64_u8,
+                        convolve_3x3_f32,
+                        resample_row_f32,
+                        accumulate_row_f32,
+                        diffuse_row_f32};
+}
+} // namespace
+} // namespace dispatch
+} // namespace flash
+
+#endif
@@ -0,0 +1,10 @@
+#include "kernels_impl.hpp"
+
+namespace flash
+{
+namespace dispatch
+{
+extern const kernel_table sse42_kernels;
+const kernel_table sse42_kernels = make_kernel_table(isa::sse42);
+} // namespace dispatch
+} // namespace flash
@@ -0,0 +1,3 @@
+// explicit instantiation definitions of the declarations in flash/kernels.hpp
+#define FLASH_KERNELS_EXTERN
+#include <flash/kernels.hpp>
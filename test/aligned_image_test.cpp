@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/extension/io/png.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/aligned_image.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace gil = boost::gil;
+
+namespace
+{
+template <typename Image>
+bool rows_are_aligned(const Image& image)
+{
+    auto view = gil::const_view(image);
+    for (std::ptrdiff_t i = 0; i < view.height(); ++i) {
+        const auto address = reinterpret_cast<std::uintptr_t>(&*view.row_begin(i));
+        if (address % flash::simd_row_alignment != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST_CASE("aligned_image rows are aligned and padding is zero", "[aligned_image]")
+{
+    flash::aligned_image<gil::gray8_pixel_t> image(13, 5, gil::gray8_pixel_t(7));
+    REQUIRE(rows_are_aligned(image));
+    REQUIRE(image.spacing() == 64);
+
+    const auto* first = reinterpret_cast<const std::uint8_t*>(&gil::const_view(image)(0, 0));
+    for (std::size_t i = 0; i < 5; ++i) {
+        for (std::size_t j = 13; j < image.spacing(); ++j) {
+            REQUIRE(first[i * image.spacing() + j] == 0);
+        }
+    }
+}
+
+TEST_CASE("as_matrix of aligned_image is aligned and padded", "[aligned_image]")
+{
+    flash::aligned_image<gil::gray8_pixel_t> image(13, 5, gil::gray8_pixel_t(3));
+    auto matrix = flash::as_matrix(image);
+    using expected_t = blaze::CustomMatrix<std::uint8_t, blaze::aligned, blaze::padded>;
+    STATIC_REQUIRE(std::is_same_v<decltype(matrix), expected_t>);
+    REQUIRE(matrix.rows() == 5);
+    REQUIRE(matrix.columns() == 13);
+    REQUIRE(blaze::sum(blaze::DynamicMatrix<int>(matrix)) == 3 * 13 * 5);
+
+    matrix(4, 2) = 42; // do not forget Blaze's different indexing
+    REQUIRE(gil::view(image)(2, 4)[0] == 42);
+
+    const auto& const_image = image;
+    auto const_matrix = flash::as_matrix(const_image);
+    REQUIRE(const_matrix(4, 2) == 42);
+}
+
+TEST_CASE("as_matrix_channeled of aligned rgba8 image", "[aligned_image]")
+{
+    flash::aligned_image<gil::rgba8_pixel_t> image(9, 4, gil::rgba8_pixel_t(1, 2, 3, 4));
+    REQUIRE(rows_are_aligned(image));
+    auto matrix = flash::as_matrix_channeled(image);
+    STATIC_REQUIRE(sizeof(blaze::ElementType_t<decltype(matrix)>) == sizeof(gil::rgba8_pixel_t));
+    REQUIRE(matrix.spacing() == image.spacing());
+    REQUIRE(matrix(3, 8) == blaze::StaticVector<std::uint8_t, 4>{1, 2, 3, 4});
+
+    matrix(1, 5) = blaze::StaticVector<std::uint8_t, 4>{5, 6, 7, 8};
+    REQUIRE(gil::view(image)(5, 1) == gil::rgba8_pixel_t(5, 6, 7, 8));
+}
+
+TEST_CASE("aligned rgb8 image keeps whole pixels in a row", "[aligned_image]")
+{
+    flash::aligned_image<gil::rgb8_pixel_t> image(10, 3);
+    REQUIRE(rows_are_aligned(image));
+    REQUIRE(image.spacing() * sizeof(gil::rgb8_pixel_t) % flash::simd_row_alignment == 0);
+}
+
+TEST_CASE("read_image keeps aligned_image aligned", "[aligned_image]")
+{
+    const std::string path = "flash_aligned_image_test.png";
+    gil::gray8_image_t source(21, 6, gil::gray8_pixel_t(99));
+    gil::write_view(path, gil::view(source), gil::png_tag{});
+
+    flash::aligned_image<gil::gray8_pixel_t> image;
+    gil::read_image(path, image, gil::png_tag{});
+    std::remove(path.c_str());
+
+    REQUIRE(image.width() == 21);
+    REQUIRE(image.height() == 6);
+    REQUIRE(rows_are_aligned(image));
+    REQUIRE(gil::equal_pixels(gil::const_view(image), gil::const_view(source)));
+    REQUIRE(blaze::max(flash::as_matrix(image)) == 99);
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+
+#include <flash/core.hpp>
+#include <flash/strided_matrix.hpp>
+
+namespace gil = boost::gil;
+
+namespace
+{
+gil::rgb8_image_t make_rgb_image(std::size_t width, std::size_t height)
+{
+    gil::rgb8_image_t image(width, height);
+    auto view = gil::view(image);
+    for (std::ptrdiff_t i = 0; i < view.height(); ++i) {
+        for (std::ptrdiff_t j = 0; j < view.width(); ++j) {
+            view(j, i) = gil::rgb8_pixel_t(static_cast<std::uint8_t>(i * 10 + j),
+                                           static_cast<std::uint8_t>(i + j * 3),
+                                           static_cast<std::uint8_t>(i * j));
+        }
+    }
+    return image;
+}
+} // namespace
+
+TEST_CASE("as_channel_matrix typecheck for rgb8_image", "[as_channel_matrix]")
+{
+    gil::rgb8_image_t image(16, 16);
+    auto result = flash::as_channel_matrix<1>(gil::view(image));
+    STATIC_REQUIRE(std::is_same_v<decltype(result), flash::strided_matrix<std::uint8_t, 3>>);
+
+    auto const_result = flash::as_channel_matrix<1>(gil::const_view(image));
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(const_result), flash::strided_matrix<const std::uint8_t, 3>>);
+}
+
+TEST_CASE("as_channel_matrix reads the same values as to_matrix", "[as_channel_matrix]")
+{
+    auto image = make_rgb_image(13, 7);
+    auto view = gil::view(image);
+
+    REQUIRE(flash::as_channel_matrix<0>(view) == flash::to_matrix(view, 0));
+    REQUIRE(flash::as_channel_matrix<1>(view) == flash::to_matrix(view, 1));
+    REQUIRE(flash::as_channel_matrix<2>(view) == flash::to_matrix(view, 2));
+}
+
+TEST_CASE("as_channel_matrix writes go into the image", "[as_channel_matrix]")
+{
+    auto image = make_rgb_image(13, 7);
+    auto view = gil::view(image);
+    const auto red = flash::to_matrix(view, 0);
+    const auto blue = flash::to_matrix(view, 2);
+
+    auto green = flash::as_channel_matrix<1>(view);
+    green(3, 2) = 200; // do not forget Blaze's different indexing
+    REQUIRE(view(2, 3)[1] == 200);
+
+    blaze::DynamicMatrix<std::uint8_t> values(7, 13, 42);
+    green = values;
+    REQUIRE(flash::to_matrix(view, 1) == values);
+    REQUIRE(flash::to_matrix(view, 0) == red);
+    REQUIRE(flash::to_matrix(view, 2) == blue);
+}
+
+TEST_CASE("as_channel_matrix of planar image", "[as_channel_matrix]")
+{
+    gil::rgb8_planar_image_t image(9, 5);
+    auto view = gil::view(image);
+    gil::fill_pixels(view, gil::rgb8_pixel_t(1, 2, 3));
+
+    auto blue = flash::as_channel_matrix<2>(view);
+    STATIC_REQUIRE(std::is_same_v<decltype(blue), flash::strided_matrix<std::uint8_t, 1>>);
+    REQUIRE(blaze::max(blue) == 3);
+    REQUIRE(blaze::min(blue) == 3);
+    REQUIRE(blaze::sum(blaze::DynamicMatrix<int>(blue)) == 3 * 9 * 5);
+}
+
+TEST_CASE("as_channel_matrix assignment from an aliasing expression", "[as_channel_matrix]")
+{
+    auto image = make_rgb_image(8, 8);
+    auto view = gil::view(image);
+    const auto green_values = flash::to_matrix(view, 1);
+    const auto blue_values = flash::to_matrix(view, 2);
+
+    // the copy shares memory with the original, transposing in place would read written values
+    auto green = flash::as_channel_matrix<1>(view);
+    const auto copy = green;
+    green = blaze::trans(copy);
+    REQUIRE(flash::to_matrix(view, 1) == blaze::trans(green_values));
+
+    auto blue = flash::as_channel_matrix<2>(view);
+    blaze::DynamicMatrix<std::uint8_t> ones(8, 8, 1);
+    blue += ones;
+    REQUIRE(flash::to_matrix(view, 2) == blue_values + ones);
+    blue -= ones;
+    REQUIRE(flash::to_matrix(view, 2) == blue_values);
+}
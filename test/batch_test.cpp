@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/algorithm.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/batch.hpp>
+#include <flash/convolution.hpp>
+#include <flash/scaling.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace gil = boost::gil;
+
+namespace
+{
+// more images than a group holds, so that the last group is partially filled
+std::vector<blaze::DynamicMatrix<std::uint8_t>> make_images(std::size_t count)
+{
+    std::vector<blaze::DynamicMatrix<std::uint8_t>> images;
+    for (std::size_t index = 0; index < count; ++index) {
+        blaze::DynamicMatrix<std::uint8_t> image(11, 13);
+        for (std::size_t i = 0; i < image.rows(); ++i) {
+            for (std::size_t j = 0; j < image.columns(); ++j) {
+                image(i, j) = static_cast<std::uint8_t>((i * 31 + j * 17 + index * 29) % 256);
+            }
+        }
+        images.push_back(image);
+    }
+    return images;
+}
+} // namespace
+
+TEST_CASE("batch stores images across lanes", "[batch]")
+{
+    const auto images = make_images(19);
+    const auto batch = flash::make_batch(images.begin(), images.end());
+    STATIC_REQUIRE(std::is_same_v<decltype(batch), const flash::image_batch<std::uint8_t>>);
+    REQUIRE(batch.size() == 19);
+    REQUIRE(batch.group_count() == 2);
+    REQUIRE(batch.rows() == 11);
+    REQUIRE(batch.columns() == 13);
+    REQUIRE(batch.lanes_at(1, 4, 5)[2] == images[18](4, 5));
+    for (std::size_t index = 0; index < images.size(); ++index) {
+        REQUIRE(batch.image(index) == images[index]);
+    }
+}
+
+TEST_CASE("batch checks slots", "[batch]")
+{
+    flash::image_batch<float, 4> batch(3, 2, 2);
+    REQUIRE_THROWS_AS(batch.set(3, blaze::DynamicMatrix<float>(2, 2)), std::out_of_range);
+    REQUIRE_THROWS_AS(batch.set(0, blaze::DynamicMatrix<float>(2, 3)), std::invalid_argument);
+}
+
+TEST_CASE("batch round trips through gil images", "[batch]")
+{
+    std::vector<gil::gray8_image_t> images;
+    for (const auto& matrix : make_images(5)) {
+        images.push_back(flash::from_matrix<gil::gray8_image_t>(matrix));
+    }
+    std::vector<gil::gray8c_view_t> views;
+    for (const auto& image : images) {
+        views.push_back(gil::const_view(image));
+    }
+
+    const auto batch = flash::to_batch<float, 4>(views.begin(), views.end());
+    const auto converted = flash::from_batch<gil::gray8_image_t>(batch);
+    REQUIRE(converted.size() == images.size());
+    for (std::size_t index = 0; index < images.size(); ++index) {
+        REQUIRE(gil::equal_pixels(gil::const_view(converted[index]), views[index]));
+    }
+}
+
+TEST_CASE("batch converts into images with a policy", "[batch]")
+{
+    flash::image_batch<float, 4> batch(2, 1, 3);
+    batch.set(0, blaze::DynamicMatrix<float>{{-3.6f, 12.5f, 300.0f}});
+    batch.set(1, blaze::DynamicMatrix<float>{{0.4f, 254.5f, 7.9f}});
+
+    const auto saturated = flash::from_batch<gil::gray8_image_t>(
+        batch, flash::saturate_round_conversion{});
+    REQUIRE(saturated.size() == 2);
+    REQUIRE(gil::const_view(saturated[0])(0, 0) == gil::gray8_pixel_t(0));
+    REQUIRE(gil::const_view(saturated[0])(1, 0) == gil::gray8_pixel_t(13));
+    REQUIRE(gil::const_view(saturated[0])(2, 0) == gil::gray8_pixel_t(255));
+    REQUIRE(gil::const_view(saturated[1])(1, 0) == gil::gray8_pixel_t(255));
+    REQUIRE(gil::const_view(saturated[1])(2, 0) == gil::gray8_pixel_t(8));
+
+    const auto truncated = flash::from_batch<gil::gray8_image_t>(batch);
+    REQUIRE(gil::const_view(truncated[1])(2, 0) == gil::gray8_pixel_t(7));
+}
+
+TEST_CASE("batched convolution matches convolve", "[batch]")
+{
+    const auto images = make_images(19);
+    const auto batch = flash::make_batch(images.begin(), images.end());
+    const auto gradients = flash::convolve<std::int16_t>(batch, flash::sobel_x);
+    STATIC_REQUIRE(
+        std::is_same_v<decltype(gradients), const flash::image_batch<std::int16_t>>);
+    for (std::size_t index = 0; index < images.size(); ++index) {
+        const auto expected = flash::convolve<std::int16_t>(images[index], flash::sobel_x);
+        REQUIRE(gradients.image(index) == expected);
+    }
+}
+
+TEST_CASE("batched scaling matches scaling into views", "[batch]")
+{
+    const auto images = make_images(19);
+    const auto batch = flash::make_batch(images.begin(), images.end());
+    const auto scaled = flash::scale(flash::bilinear_interpolation{}, batch, 7, 20);
+    REQUIRE(scaled.rows() == 20);
+    REQUIRE(scaled.columns() == 7);
+    const auto results = flash::from_batch<gil::gray8_image_t>(scaled);
+    for (std::size_t index = 0; index < images.size(); ++index) {
+        gil::gray8_image_t expected(7, 20);
+        flash::scale(flash::bilinear_interpolation{}, images[index], gil::view(expected));
+        REQUIRE(gil::equal_pixels(gil::const_view(results[index]), gil::const_view(expected)));
+    }
+}
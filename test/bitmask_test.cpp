@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/bitmask.hpp>
+#include <flash/numeric.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+TEST_CASE("bitmask from comparisons", "[bitmask]")
+{
+    // two words per row, the second one partially used
+    blaze::DynamicMatrix<int> values(3, 70);
+    for (std::size_t i = 0; i < values.rows(); ++i) {
+        for (std::size_t j = 0; j < values.columns(); ++j) {
+            values(i, j) = static_cast<int>((i * 31 + j * 7) % 10);
+        }
+    }
+
+    auto mask = flash::make_mask(values, [](int x) { return x >= 5; });
+    REQUIRE(mask.words_per_row() == 2);
+    REQUIRE(flash::to_bool_matrix(mask) == blaze::map(values, [](int x) { return x >= 5; }));
+    REQUIRE(mask.count() == static_cast<std::size_t>(blaze::sum(
+                                blaze::map(values, [](int x) { return x >= 5 ? 1 : 0; }))));
+
+    auto inverted = ~mask;
+    REQUIRE(inverted.count() == values.rows() * values.columns() - mask.count());
+    REQUIRE_FALSE((mask & inverted).any());
+    REQUIRE((mask | inverted) == flash::bitmask(3, 70, true));
+    REQUIRE((mask ^ mask) == flash::bitmask(3, 70));
+    REQUIRE_THROWS_AS(mask &= flash::bitmask(3, 71), std::invalid_argument);
+}
+
+TEST_CASE("for_each_set visits set pixels in order", "[bitmask]")
+{
+    flash::bitmask mask(4, 130);
+    const std::vector<std::pair<std::size_t, std::size_t>> expected{
+        {0, 0}, {0, 63}, {0, 64}, {2, 129}, {3, 5}};
+    for (const auto& [i, j] : expected) {
+        mask.set(i, j);
+    }
+    mask.set(1, 1);
+    mask.set(1, 1, false);
+
+    std::vector<std::pair<std::size_t, std::size_t>> visited;
+    mask.for_each_set([&visited](std::size_t i, std::size_t j) { visited.emplace_back(i, j); });
+    REQUIRE(visited == expected);
+}
+
+TEST_CASE("dilation and erosion", "[bitmask]")
+{
+    flash::bitmask mask(7, 66);
+    mask.set(3, 63);
+    auto dilated = flash::dilate(mask, 1);
+    REQUIRE(dilated.count() == 9);
+    REQUIRE(dilated(2, 62));
+    REQUIRE(dilated(4, 64));
+    REQUIRE_FALSE(dilated(3, 65));
+
+    REQUIRE(flash::erode(dilated, 1) == mask);
+    // the border does not erode
+    REQUIRE(flash::erode(flash::bitmask(5, 5, true), 2) == flash::bitmask(5, 5, true));
+}
+
+TEST_CASE("nonmax_mask matches nonmax_map", "[bitmask]")
+{
+    blaze::DynamicMatrix<std::int32_t> input(12, 12);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<std::int32_t>((i * 5 + j * 3) % 4);
+        }
+    }
+
+    REQUIRE(flash::to_bool_matrix(flash::nonmax_mask(input, 3)) == flash::nonmax_map(input, 3));
+}
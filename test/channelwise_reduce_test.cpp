@@ -65,4 +65,34 @@ TEST_CASE("random min max case", "[channelwise_reduce]")
         REQUIRE(expected_min[i] == the_min[i]);
         REQUIRE(expected_max[i] == the_max[i]);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("fused minmax over multiple blocks", "[channelwise_reduce]")
+{
+    blaze::DynamicMatrix<int> matrix(600, 301, 5);
+    matrix(0, 0) = -3;
+    matrix(599, 300) = 70;
+    matrix(345, 17) = -40;
+    auto [the_min, the_max] = flash::minmax(matrix);
+    REQUIRE(the_min == -40);
+    REQUIRE(the_max == 70);
+
+    blaze::DynamicMatrix<int, blaze::columnMajor> transposed = blaze::trans(matrix);
+    REQUIRE(flash::minmax(transposed) == std::make_pair(-40, 70));
+    REQUIRE(flash::minmax(blaze::submatrix(matrix, 1, 1, 598, 299)) == std::make_pair(-40, 5));
+}
+
+TEST_CASE("fused channelwise minmax agrees with separate reductions", "[channelwise_reduce]")
+{
+    std::mt19937 twister(42);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    blaze::DynamicMatrix<blaze::StaticVector<int, 3>> matrix(37, 29);
+    for (std::size_t i = 0; i < matrix.rows(); ++i) {
+        for (std::size_t j = 0; j < matrix.columns(); ++j) {
+            matrix(i, j) = {dist(twister), dist(twister), dist(twister)};
+        }
+    }
+
+    auto [the_min, the_max] = flash::channelwise_minmax(matrix);
+    REQUIRE(the_min == flash::channelwise_min(matrix));
+    REQUIRE(the_max == flash::channelwise_max(matrix));
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/algorithm.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/image_view_factory.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/color.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace gil = boost::gil;
+
+namespace
+{
+gil::rgb8_image_t make_test_image()
+{
+    gil::rgb8_image_t image(7, 5);
+    auto view = gil::view(image);
+    for (flash::signed_size i = 0; i < view.height(); ++i) {
+        for (flash::signed_size j = 0; j < view.width(); ++j) {
+            view(j, i) = gil::rgb8_pixel_t(static_cast<std::uint8_t>(i * 50 + j),
+                                           static_cast<std::uint8_t>(255 - j * 30),
+                                           static_cast<std::uint8_t>((i * j * 37) % 256));
+        }
+    }
+    view(0, 0) = gil::rgb8_pixel_t(255, 255, 255);
+    view(1, 0) = gil::rgb8_pixel_t(0, 0, 0);
+    return image;
+}
+} // namespace
+
+TEST_CASE("rgb_to_gray matches BT.601 luma", "[color]")
+{
+    auto image = make_test_image();
+    auto view = gil::const_view(image);
+    auto gray = flash::rgb_to_gray<std::uint8_t>(view);
+    REQUIRE(gray.rows() == 5);
+    REQUIRE(gray.columns() == 7);
+    REQUIRE(gray(0, 0) == 255);
+    REQUIRE(gray(0, 1) == 0);
+    for (std::size_t i = 0; i < gray.rows(); ++i) {
+        for (std::size_t j = 0; j < gray.columns(); ++j) {
+            const auto& pixel = view(j, i);
+            const double expected = 0.299 * pixel[0] + 0.587 * pixel[1] + 0.114 * pixel[2];
+            // Q14 weights are within 0.5 / 16384 of the exact ones
+            REQUIRE(std::abs(gray(i, j) - expected) <= 0.55);
+        }
+    }
+}
+
+TEST_CASE("rgb_to_gray handles channel order, element types and matrices", "[color]")
+{
+    auto image = make_test_image();
+    auto expected = flash::rgb_to_gray<std::uint8_t>(gil::const_view(image));
+
+    gil::bgr8_image_t bgr(image.dimensions());
+    gil::copy_pixels(gil::color_converted_view<gil::bgr8_pixel_t>(gil::const_view(image)),
+                     gil::view(bgr));
+    REQUIRE(flash::rgb_to_gray<std::uint8_t>(gil::const_view(bgr)) == expected);
+
+    blaze::DynamicMatrix<std::int16_t> wide(5, 7);
+    flash::rgb_to_gray(gil::const_view(image), wide);
+    REQUIRE(wide == blaze::DynamicMatrix<std::int16_t>(expected));
+
+    auto channeled = flash::to_matrix_channeled(gil::const_view(image));
+    REQUIRE(flash::rgb_to_gray<std::uint8_t>(channeled) == expected);
+
+    blaze::DynamicMatrix<std::uint8_t> wrong_size(3, 3);
+    REQUIRE_THROWS_AS(flash::rgb_to_gray(gil::const_view(image), wrong_size),
+                      std::invalid_argument);
+}
+
+TEST_CASE("rgb_to_ycbcr round trip", "[color]")
+{
+    auto image = make_test_image();
+    auto ycbcr = flash::rgb_to_ycbcr<std::uint8_t>(gil::const_view(image));
+    REQUIRE(ycbcr.plane(0) == flash::rgb_to_gray<std::uint8_t>(gil::const_view(image)));
+    REQUIRE(ycbcr.plane(1)(0, 0) == 128);
+    REQUIRE(ycbcr.plane(2)(0, 0) == 128);
+
+    gil::rgb8_image_t result(image.dimensions());
+    flash::ycbcr_to_rgb(ycbcr, gil::view(result));
+    auto source = gil::const_view(image);
+    auto converted = gil::const_view(result);
+    for (flash::signed_size i = 0; i < source.height(); ++i) {
+        for (flash::signed_size j = 0; j < source.width(); ++j) {
+            for (std::size_t channel = 0; channel < 3; ++channel) {
+                REQUIRE(std::abs(source(j, i)[channel] - converted(j, i)[channel]) <= 2);
+            }
+        }
+    }
+}
+
+TEST_CASE("rgb_to_lab reference values and round trip", "[color]")
+{
+    auto image = make_test_image();
+    auto lab = flash::rgb_to_lab(gil::const_view(image));
+    REQUIRE(lab.plane(0)(0, 0) == Approx(100.0f).margin(0.01));
+    REQUIRE(lab.plane(1)(0, 0) == Approx(0.0f).margin(0.01));
+    REQUIRE(lab.plane(2)(0, 0) == Approx(0.0f).margin(0.01));
+    REQUIRE(lab.plane(0)(0, 1) == Approx(0.0f).margin(0.01));
+
+    gil::rgb8_image_t result(image.dimensions());
+    flash::lab_to_rgb(lab, gil::view(result));
+    auto source = gil::const_view(image);
+    auto converted = gil::const_view(result);
+    for (flash::signed_size i = 0; i < source.height(); ++i) {
+        for (flash::signed_size j = 0; j < source.width(); ++j) {
+            for (std::size_t channel = 0; channel < 3; ++channel) {
+                REQUIRE(std::abs(source(j, i)[channel] - converted(j, i)[channel]) <= 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/conversion.hpp>
+#include <flash/core.hpp>
+
+#include <cstdint>
+#include <limits>
+
+namespace gil = boost::gil;
+
+TEST_CASE("convert_channel policies from floating point", "[conversion]")
+{
+    REQUIRE(flash::convert_channel<std::uint8_t>(12.7, flash::truncate_conversion{}) == 12);
+    REQUIRE(flash::convert_channel<std::uint8_t>(12.5, flash::round_conversion{}) == 13);
+    REQUIRE(flash::convert_channel<std::int8_t>(-12.5, flash::round_conversion{}) == -13);
+    REQUIRE(flash::convert_channel<std::uint8_t>(300.0, flash::saturate_conversion{}) == 255);
+    REQUIRE(flash::convert_channel<std::uint8_t>(-4.0, flash::saturate_conversion{}) == 0);
+    REQUIRE(flash::convert_channel<std::uint8_t>(254.6, flash::saturate_conversion{}) == 254);
+    REQUIRE(flash::convert_channel<std::uint8_t>(254.6, flash::saturate_round_conversion{}) ==
+            255);
+    REQUIRE(flash::convert_channel<std::uint8_t>(255.7, flash::saturate_round_conversion{}) ==
+            255);
+    REQUIRE(flash::convert_channel<float>(0.25, flash::saturate_round_conversion{}) == 0.25f);
+}
+
+TEST_CASE("rounding does not carry from the largest value below a half", "[conversion]")
+{
+    // adding 0.5 to these rounds up to 1 in their own type
+    REQUIRE(flash::convert_channel<std::uint8_t>(0.49999997f, flash::round_conversion{}) == 0);
+    REQUIRE(flash::convert_channel<std::int8_t>(-0.49999997f, flash::round_conversion{}) == 0);
+    REQUIRE(flash::convert_channel<std::uint8_t>(0.49999999999999994,
+                                                 flash::saturate_round_conversion{}) == 0);
+    REQUIRE(flash::convert_channel<std::uint8_t>(2.5f, flash::round_conversion{}) == 3);
+    REQUIRE(flash::convert_channel<std::int8_t>(-2.5, flash::round_conversion{}) == -3);
+    REQUIRE(flash::convert_channel<std::int8_t>(-2.4999, flash::round_conversion{}) == -2);
+}
+
+TEST_CASE("convert_channel saturates floating point above 32 and 64 bit ranges", "[conversion]")
+{
+    constexpr auto int32_max = std::numeric_limits<std::int32_t>::max();
+    constexpr auto int32_min = std::numeric_limits<std::int32_t>::lowest();
+    REQUIRE(flash::convert_channel<std::int32_t>(1e10f, flash::saturate_conversion{}) ==
+            int32_max);
+    REQUIRE(flash::convert_channel<std::int32_t>(-1e10f, flash::saturate_conversion{}) ==
+            int32_min);
+    // float(2^31 - 1) rounds up to 2^31
+    REQUIRE(flash::convert_channel<std::int32_t>(static_cast<float>(int32_max),
+                                                 flash::saturate_conversion{}) == int32_max);
+    REQUIRE(flash::convert_channel<std::int32_t>(2147483520.0f, flash::saturate_conversion{}) ==
+            2147483520);
+    REQUIRE(flash::convert_channel<std::int32_t>(1e10, flash::saturate_round_conversion{}) ==
+            int32_max);
+    REQUIRE(flash::convert_channel<std::int32_t>(2147483646.6, flash::saturate_conversion{}) ==
+            2147483646);
+    REQUIRE(flash::convert_channel<std::int64_t>(1e30, flash::saturate_conversion{}) ==
+            std::numeric_limits<std::int64_t>::max());
+    REQUIRE(flash::convert_channel<std::uint64_t>(1e30f, flash::saturate_conversion{}) ==
+            std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST_CASE("convert_channel saturates between integral types", "[conversion]")
+{
+    REQUIRE(flash::convert_channel<std::uint8_t>(-1, flash::saturate_conversion{}) == 0);
+    REQUIRE(flash::convert_channel<std::uint8_t>(1000, flash::saturate_conversion{}) == 255);
+    REQUIRE(flash::convert_channel<std::int8_t>(200u, flash::saturate_conversion{}) == 127);
+    REQUIRE(flash::convert_channel<std::int16_t>(-40000, flash::saturate_conversion{}) ==
+            -32768);
+    REQUIRE(flash::convert_channel<std::uint16_t>(std::uint64_t{70000},
+                                                  flash::saturate_conversion{}) == 65535);
+    REQUIRE(flash::convert_channel<std::int64_t>(std::uint8_t{200},
+                                                 flash::saturate_conversion{}) == 200);
+}
+
+TEST_CASE("from_matrix with saturate_round_conversion", "[conversion]")
+{
+    blaze::DynamicMatrix<double> input{{-3.0, 0.4, 0.5}, {127.5, 254.5, 1000.0}};
+    auto image = flash::from_matrix<gil::gray8_image_t>(input, flash::saturate_round_conversion{});
+    blaze::DynamicMatrix<std::uint8_t> expected{{0, 0, 1}, {128, 255, 255}};
+    REQUIRE(flash::to_matrix(gil::view(image)) == expected);
+
+    gil::gray8_image_t target(3, 2);
+    flash::from_matrix(input, gil::view(target), flash::saturate_conversion{});
+    blaze::DynamicMatrix<std::uint8_t> saturated{{0, 0, 0}, {127, 254, 255}};
+    REQUIRE(flash::to_matrix(gil::view(target)) == saturated);
+}
+
+TEST_CASE("to_image converts channeled matrices with a policy", "[conversion]")
+{
+    using vector_t = blaze::StaticVector<double, 3>;
+    blaze::DynamicMatrix<vector_t> input(2, 2, vector_t{-1.0, 99.6, 256.0});
+    auto image = flash::to_image<gil::rgb8_image_t>(input, flash::saturate_round_conversion{});
+    REQUIRE(gil::view(image)(1, 1) == gil::rgb8_pixel_t(0, 100, 255));
+
+    auto truncated = flash::to_image<gil::rgb8_image_t>(blaze::DynamicMatrix<vector_t>(
+        2, 2, vector_t{1.9, 2.9, 3.9}));
+    REQUIRE(gil::view(truncated)(0, 0) == gil::rgb8_pixel_t(1, 2, 3));
+}
+
+TEST_CASE("vector_to_pixel with a policy", "[conversion]")
+{
+    blaze::StaticVector<int, 3> vector{-5, 128, 4000};
+    auto pixel = flash::vector_to_pixel<gil::rgb8_pixel_t>(vector, flash::saturate_conversion{});
+    REQUIRE(pixel == gil::rgb8_pixel_t(0, 128, 255));
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/conversion.hpp>
+#include <flash/core.hpp>
+#include <flash/dispatch.hpp>
+#include <flash/numeric.hpp>
+#include <flash/scaling.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace gil = boost::gil;
+using flash::dispatch::isa;
+
+namespace
+{
+blaze::DynamicMatrix<float> make_input(std::size_t rows, std::size_t columns)
+{
+    blaze::DynamicMatrix<float> result(rows, columns);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < columns; ++j) {
+            result(i, j) = static_cast<float>((i * 37 + j * 11) % 300) - 20.25f;
+        }
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("every level converts like saturate_round_conversion", "[dispatch]")
+{
+    auto input = make_input(1, 67);
+    // adding a half to these rounds up to 1 in float, halves and the clamping bounds
+    input(0, 0) = 0.49999997f;
+    input(0, 1) = 0.5f;
+    input(0, 2) = 254.5f;
+    input(0, 3) = 255.49998f;
+    input(0, 4) = -0.49999997f;
+    input(0, 5) = 1.49999988f;
+    for (auto level : {isa::baseline, isa::sse42, isa::avx2, isa::avx512}) {
+        const auto& table = flash::dispatch::kernels(level);
+        REQUIRE(table.level <= level);
+        std::vector<std::uint8_t> result(input.columns());
+        table.saturate_round_f32_u8(input.data(0), result.data(), input.columns());
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(result[j] == flash::convert_channel<std::uint8_t>(
+                                     input(0, j), flash::saturate_round_conversion{}));
+        }
+        REQUIRE(result[0] == 0);
+        REQUIRE(result[1] == 1);
+
+        const double edge = 0.49999999999999994;
+        std::uint8_t rounded = 1;
+        table.saturate_round_f64_u8(&edge, &rounded, 1);
+        REQUIRE(rounded == 0);
+    }
+}
+
+TEST_CASE("active level does not exceed the detected one", "[dispatch]")
+{
+    REQUIRE(flash::dispatch::active_isa() <= flash::dispatch::detected_isa());
+    REQUIRE(flash::dispatch::kernels().level == flash::dispatch::active_isa());
+}
+
+TEST_CASE("dispatched convolution replicates borders", "[dispatch]")
+{
+    const blaze::DynamicMatrix<float> input(5, 19, 2.0f);
+    const float box[3][3] = {{1, 1, 1}, {1, 1, 1}, {1, 1, 1}};
+    REQUIRE(flash::dispatch::convolve_3x3(input, box) == blaze::DynamicMatrix<float>(5, 19, 18));
+
+    const auto ramp = make_input(6, 23);
+    const float derivative[3][3] = {{0, 0, 0}, {1, 0, -1}, {0, 0, 0}};
+    const auto result = flash::dispatch::convolve_3x3(ramp, derivative);
+    REQUIRE(result(2, 5) == Approx(ramp(2, 6) - ramp(2, 4)));
+}
+
+TEST_CASE("dispatched scaling matches scale into a view", "[dispatch]")
+{
+    const auto input = make_input(31, 45);
+    gil::gray32f_image_t expected(20, 13);
+    flash::scale(flash::lanczos_method{}, input, gil::view(expected));
+
+    const auto result = flash::dispatch::scale(flash::lanczos_method{}, input, 20, 13);
+    REQUIRE(result.rows() == 13);
+    REQUIRE(result.columns() == 20);
+    const auto view = gil::const_view(expected);
+    for (std::size_t i = 0; i < result.rows(); ++i) {
+        for (std::size_t j = 0; j < result.columns(); ++j) {
+            REQUIRE(result(i, j) == Approx(static_cast<float>(view(j, i)[0])).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("dispatched diffusion matches anisotropic_diffusion", "[dispatch]")
+{
+    const auto input = make_input(17, 29);
+    const auto expected = flash::anisotropic_diffusion<float>(input, 0.1, 15.0, 5);
+    const auto result = flash::dispatch::anisotropic_diffusion(input, 0.1, 15.0, 5);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(result(i, j) == Approx(expected(i, j)).margin(1e-3));
+        }
+    }
+}
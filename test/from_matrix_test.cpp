@@ -105,6 +105,35 @@ TEST_CASE("Matrix to rgb8 image", "[from_matrix]")
     test_vector_matrix_type<vector_type, image_type>();
 }
 
+TEST_CASE("Matrix to rgb8 planar image", "[from_matrix]")
+{
+    using image_type = gil::rgb8_planar_image_t;
+    using vector_type = blaze::StaticVector<std::uint8_t, 3>;
+    test_vector_matrix_type<vector_type, image_type>();
+}
+
+TEST_CASE("Matrix to rgb16 image", "[from_matrix]")
+{
+    using image_type = gil::rgb16_image_t;
+    using vector_type = blaze::StaticVector<std::uint16_t, 3>;
+    test_vector_matrix_type<vector_type, image_type>();
+}
+
+TEST_CASE("Matrix to rgb8 view through bgr8 pixels", "[from_matrix]")
+{
+    // vectors become bgr8 pixels, GIL then assigns them to the rgb8 pixels by color
+    const blaze::StaticVector<std::uint8_t, 3> default_vector({1, 2, 3});
+    blaze::DynamicMatrix<blaze::StaticVector<std::uint8_t, 3>> input(4, 5, default_vector);
+    input(1, 2) = {10, 20, 30};
+
+    gil::rgb8_image_t result(5, 4);
+    flash::from_matrix<gil::rgb8_view_t, gil::bgr8_pixel_t>(input, gil::view(result));
+
+    gil::rgb8_image_t expected(5, 4, gil::rgb8_pixel_t(3, 2, 1));
+    gil::view(expected)(2, 1) = gil::rgb8_pixel_t(30, 20, 10);
+    REQUIRE(result == expected);
+}
+
 TEST_CASE("Matrix to rgb32f image", "[from_matrix]")
 {
     using image_type = gil::rgb32f_image_t;
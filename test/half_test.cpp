@@ -0,0 +1,200 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/convolution.hpp>
+#include <flash/half.hpp>
+#include <flash/numeric.hpp>
+#include <flash/scaling.hpp>
+#include <flash/workspace.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE("float16 round trips representable values", "[half]")
+{
+    for (float value : {0.0f, -0.0f, 1.0f, -2.5f, 0.333251953125f, 65504.0f, 6.103515625e-05f}) {
+        REQUIRE(static_cast<float>(flash::float16(value)) == value);
+    }
+    REQUIRE(flash::float16(1.0f).to_bits() == 0x3c00u);
+    REQUIRE(flash::float16::from_bits(0xc000u) == -2.0f);
+    // the smallest subnormal
+    REQUIRE(static_cast<float>(flash::float16::from_bits(1)) == std::ldexp(1.0f, -24));
+}
+
+TEST_CASE("float16 rounds to nearest even and saturates to infinity", "[half]")
+{
+    // 2049 lies halfway between 2048 and 2050, the even mantissa wins
+    REQUIRE(static_cast<float>(flash::float16(2049.0f)) == 2048.0f);
+    REQUIRE(static_cast<float>(flash::float16(2051.0f)) == 2052.0f);
+    REQUIRE(std::isinf(static_cast<float>(flash::float16(1e6f))));
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    REQUIRE(std::isnan(static_cast<float>(flash::float16(nan))));
+}
+
+TEST_CASE("bfloat16 keeps the range of float", "[half]")
+{
+    REQUIRE(static_cast<float>(flash::bfloat16(1.0f)) == 1.0f);
+    REQUIRE(static_cast<float>(flash::bfloat16(1e30f)) == Approx(1e30f).epsilon(1.0 / 128));
+    REQUIRE(static_cast<float>(flash::bfloat16(3.14159f)) == Approx(3.14159f).epsilon(1.0 / 128));
+    REQUIRE(flash::bfloat16(-1.0f).to_bits() == 0xbf80u);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    REQUIRE(std::isnan(static_cast<float>(flash::bfloat16(nan))));
+}
+
+TEST_CASE("compute types of storage types", "[half]")
+{
+    STATIC_REQUIRE(std::is_same_v<flash::compute_type_t<flash::float16>, float>);
+    STATIC_REQUIRE(std::is_same_v<flash::compute_type_t<flash::bfloat16>, float>);
+    STATIC_REQUIRE(std::is_same_v<flash::compute_type_t<double>, double>);
+    STATIC_REQUIRE(std::is_same_v<flash::compute_type_t<blaze::StaticVector<flash::float16, 3>>,
+                                  blaze::StaticVector<float, 3>>);
+}
+
+TEST_CASE("convert_row matches element conversions", "[half]")
+{
+    // long enough for the vectorized loops and a scalar tail
+    std::vector<float> source(37);
+    for (std::size_t j = 0; j < source.size(); ++j) {
+        source[j] = static_cast<float>(j) * 0.37f - 5.0f;
+    }
+
+    std::vector<flash::float16> half(source.size());
+    std::vector<float> back(source.size());
+    flash::detail::convert_row(source.data(), half.data(), source.size());
+    flash::detail::convert_row(half.data(), back.data(), half.size());
+    for (std::size_t j = 0; j < source.size(); ++j) {
+        REQUIRE(half[j].to_bits() == flash::float16(source[j]).to_bits());
+        REQUIRE(back[j] == static_cast<float>(flash::float16(source[j])));
+    }
+}
+
+TEST_CASE("anisotropic diffusion with half precision storage", "[half]")
+{
+    blaze::DynamicMatrix<double> input(19, 23);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = (i * 7 + j * 13) % 17 + (j > 11 ? 100.0 : 0.0);
+        }
+    }
+
+    auto expected = flash::anisotropic_diffusion(input, 0.1, 10.0, 8);
+    auto half = flash::anisotropic_diffusion<flash::float16>(input, 0.1, 10.0, 8);
+    STATIC_REQUIRE(std::is_same_v<blaze::ElementType_t<decltype(half)>, flash::float16>);
+
+    flash::workspace arena;
+    auto coarse = flash::anisotropic_diffusion<flash::bfloat16>(input, 0.1, 10.0, 8, arena);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(static_cast<float>(half(i, j)) == Approx(expected(i, j)).margin(0.25));
+            REQUIRE(static_cast<float>(coarse(i, j)) == Approx(expected(i, j)).margin(1.5));
+        }
+    }
+}
+
+TEST_CASE("anisotropic diffusion into the opposite storage order", "[half]")
+{
+    using input_type = blaze::DynamicMatrix<double>;
+    input_type input(11, 14);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = (i * 5 + j * 3) % 13 + (i > 5 ? 50.0 : 0.0);
+        }
+    }
+    const auto expected = flash::anisotropic_diffusion(input, 0.1, 10.0, 4);
+
+    const auto columns =
+        flash::anisotropic_diffusion<input_type, blaze::rowMajor, blaze::columnMajor>(
+            input, 0.1, 10.0, 4);
+    STATIC_REQUIRE(blaze::IsColumnMajorMatrix_v<std::remove_cv_t<decltype(columns)>>);
+    const auto half_columns =
+        flash::anisotropic_diffusion<flash::float16, input_type, blaze::rowMajor,
+                                     blaze::columnMajor>(input, 0.1, 10.0, 4);
+    STATIC_REQUIRE(blaze::IsColumnMajorMatrix_v<std::remove_cv_t<decltype(half_columns)>>);
+    flash::workspace arena;
+    const auto arena_columns =
+        flash::anisotropic_diffusion<input_type, blaze::rowMajor, blaze::columnMajor>(
+            input, 0.1, 10.0, 4, arena);
+    STATIC_REQUIRE(blaze::IsColumnMajorMatrix_v<std::remove_cv_t<decltype(arena_columns)>>);
+
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(columns(i, j) == Approx(expected(i, j)));
+            REQUIRE(arena_columns(i, j) == Approx(expected(i, j)));
+            REQUIRE(static_cast<float>(half_columns(i, j)) ==
+                    Approx(expected(i, j)).margin(0.25));
+        }
+    }
+}
+
+TEST_CASE("convolution with half precision storage", "[half]")
+{
+    blaze::DynamicMatrix<float> input(13, 17);
+    blaze::DynamicMatrix<flash::float16> half_input(13, 17);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<float>((i * 7 + j * 13) % 17) + (j > 8 ? 100.0f : 0.0f);
+            half_input(i, j) = input(i, j);
+        }
+    }
+    const auto kernel = flash::gaussian_kernel(5, 1.0);
+
+    const auto expected = flash::convolve(input, kernel);
+    // accumulated in float, rounded once into the result
+    const auto half = flash::convolve<flash::float16>(input, kernel);
+    STATIC_REQUIRE(std::is_same_v<blaze::ElementType_t<decltype(half)>, flash::float16>);
+    // half precision source, widened to float before multiplying
+    const auto from_half = flash::convolve<float>(half_input, kernel);
+    const auto bordered = flash::convolve<flash::bfloat16>(input, kernel, flash::reflect_border{});
+    const auto expected_bordered = flash::convolve(input, kernel, flash::reflect_border{});
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(static_cast<float>(half(i, j)) == Approx(expected(i, j)).epsilon(1.0 / 1024));
+            REQUIRE(from_half(i, j) == Approx(expected(i, j)));
+            REQUIRE(static_cast<float>(bordered(i, j)) ==
+                    Approx(expected_bordered(i, j)).epsilon(1.0 / 128));
+        }
+    }
+}
+
+TEST_CASE("scaling half precision matrices", "[half]")
+{
+    blaze::DynamicMatrix<float> input(12, 15);
+    blaze::DynamicMatrix<flash::float16> half_input(12, 15);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<float>((i * 5 + j * 3) % 11) * 10.0f;
+            half_input(i, j) = input(i, j);
+        }
+    }
+
+    const auto expected = flash::scale(flash::lanczos_method{}, input, 7, 9, 3);
+    const auto half = flash::scale(flash::lanczos_method{}, half_input, 7, 9, 3);
+    STATIC_REQUIRE(std::is_same_v<blaze::ElementType_t<decltype(half)>, flash::float16>);
+
+    // the streaming scaler accumulates in double whatever the element type
+    blaze::DynamicMatrix<float> streamed(9, 7);
+    blaze::DynamicMatrix<flash::float16> half_streamed(9, 7);
+    auto read = [](const auto& source) {
+        return [&source](std::size_t i, auto& row) { row = blaze::row(source, i); };
+    };
+    auto write = [](auto& target) {
+        return [&target](std::size_t i, const auto& row) { blaze::row(target, i) = row; };
+    };
+    flash::scale_streaming<float>(
+        flash::bilinear_interpolation{}, 15, 12, 7, 9, read(input), write(streamed));
+    flash::scale_streaming<flash::float16>(
+        flash::bilinear_interpolation{}, 15, 12, 7, 9, read(half_input), write(half_streamed));
+
+    for (std::size_t i = 0; i < expected.rows(); ++i) {
+        for (std::size_t j = 0; j < expected.columns(); ++j) {
+            // the margin covers results that underflow into half precision subnormals
+            REQUIRE(static_cast<float>(half(i, j)) ==
+                    Approx(expected(i, j)).epsilon(1.0 / 1024).margin(1e-3));
+            REQUIRE(static_cast<float>(half_streamed(i, j)) ==
+                    Approx(streamed(i, j)).epsilon(1.0 / 1024).margin(1e-3));
+        }
+    }
+}
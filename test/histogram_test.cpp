@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/image.hpp>
+#include <boost/gil/image_view_factory.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/histogram.hpp>
+
+#include <cstdint>
+
+namespace gil = boost::gil;
+
+TEST_CASE("histogram counts and cumulative queries", "[histogram]")
+{
+    blaze::DynamicMatrix<std::uint8_t> matrix(10, 10, 5);
+    for (std::size_t j = 0; j < 10; ++j) {
+        matrix(0, j) = 1;
+        matrix(9, j) = 200;
+    }
+
+    const auto result = flash::make_histogram(matrix);
+    REQUIRE(result.bin_count() == 256);
+    REQUIRE(result.total() == 100);
+    REQUIRE(result[1] == 10);
+    REQUIRE(result[5] == 80);
+    REQUIRE(result[200] == 10);
+    REQUIRE(result.cdf(4) == Approx(0.1));
+    REQUIRE(result.cdf(5) == Approx(0.9));
+    REQUIRE(result.percentile(0) == 1);
+    REQUIRE(result.percentile(10) == 1);
+    REQUIRE(result.percentile(11) == 5);
+    REQUIRE(result.percentile(90) == 5);
+    REQUIRE(result.percentile(91) == 200);
+    REQUIRE(result.percentile(100) == 200);
+}
+
+TEST_CASE("16 bit histogram over multiple blocks", "[histogram]")
+{
+    blaze::DynamicMatrix<std::uint16_t> matrix(700, 700);
+    for (std::size_t i = 0; i < matrix.rows(); ++i) {
+        for (std::size_t j = 0; j < matrix.columns(); ++j) {
+            matrix(i, j) = static_cast<std::uint16_t>((i * 700 + j) % 60000);
+        }
+    }
+
+    const auto result = flash::make_histogram(matrix);
+    REQUIRE(result.bin_count() == 65536);
+    REQUIRE(result.total() == 700 * 700);
+    REQUIRE(result[0] == 9);
+    REQUIRE(result[59999] == 8);
+    REQUIRE(result[60000] == 0);
+}
+
+TEST_CASE("channelwise histograms of matrix and view agree", "[histogram]")
+{
+    gil::rgb8_image_t image(31, 17);
+    auto view = gil::view(image);
+    for (std::ptrdiff_t i = 0; i < view.height(); ++i) {
+        for (std::ptrdiff_t j = 0; j < view.width(); ++j) {
+            view(j, i) = gil::rgb8_pixel_t(static_cast<std::uint8_t>(i * j),
+                                           static_cast<std::uint8_t>(i + j),
+                                           static_cast<std::uint8_t>(7));
+        }
+    }
+
+    const auto from_view = flash::make_channelwise_histograms(view);
+    const auto from_matrix = flash::make_channelwise_histograms(flash::to_matrix_channeled(view));
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        REQUIRE(from_view[channel].total() == 31 * 17);
+        for (std::size_t bin = 0; bin < 256; ++bin) {
+            REQUIRE(from_view[channel][bin] == from_matrix[channel][bin]);
+        }
+    }
+    REQUIRE(from_view[2][7] == 31 * 17);
+
+    // not a basic view, read pixel by pixel
+    const auto green = flash::make_histogram(gil::nth_channel_view(view, 1));
+    REQUIRE(green[10] == from_view[1][10]);
+}
+
+TEST_CASE("percentile remap clips outliers", "[histogram]")
+{
+    blaze::DynamicMatrix<std::uint16_t> matrix(10, 10);
+    for (std::size_t i = 0; i < 10; ++i) {
+        for (std::size_t j = 0; j < 10; ++j) {
+            matrix(i, j) = static_cast<std::uint16_t>(1000 + i * 10 + j);
+        }
+    }
+    matrix(0, 0) = 0;
+    matrix(9, 9) = 65535;
+
+    // with 100 values the 1st percentile would be the minimum itself
+    blaze::DynamicMatrix<std::uint8_t> result =
+        flash::remap_to_percentile<std::uint8_t>(matrix, 2, 98);
+    REQUIRE(result(0, 0) == 0);
+    REQUIRE(result(0, 1) == 0);
+    REQUIRE(result(9, 8) == 255);
+    REQUIRE(result(9, 9) == 255);
+    REQUIRE(result(5, 0) > 100);
+    REQUIRE(result(5, 0) < 155);
+}
+
+TEST_CASE("equalization spreads values over the full range", "[histogram]")
+{
+    blaze::DynamicMatrix<std::uint8_t> matrix(4, 4);
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            matrix(i, j) = static_cast<std::uint8_t>(100 + i * 4 + j);
+        }
+    }
+
+    const auto result = flash::equalize(matrix);
+    REQUIRE(result(0, 0) == 0);
+    REQUIRE(result(3, 3) == 255);
+    REQUIRE(result(0, 1) == 17);
+    for (std::size_t k = 1; k < 16; ++k) {
+        REQUIRE(result(k / 4, k % 4) > result((k - 1) / 4, (k - 1) % 4));
+    }
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/extension/io/jpeg.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/jpeg.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace gil = boost::gil;
+
+TEST_CASE("DCT scale denominator keeps decoded image large enough", "[jpeg]")
+{
+    REQUIRE(flash::jpeg_scale_denominator(800, 600, 800, 600) == 1);
+    REQUIRE(flash::jpeg_scale_denominator(800, 600, 400, 300) == 2);
+    REQUIRE(flash::jpeg_scale_denominator(800, 600, 399, 100) == 2);
+    REQUIRE(flash::jpeg_scale_denominator(800, 600, 100, 75) == 8);
+    REQUIRE(flash::jpeg_scale_denominator(800, 600, 10, 10) == 8);
+    REQUIRE(flash::jpeg_scale_denominator(801, 600, 101, 75) == 8);
+    REQUIRE(flash::jpeg_scale_denominator(801, 600, 102, 75) == 4);
+}
+
+TEST_CASE("reduced resolution decode of constant image", "[jpeg]")
+{
+    const std::string path = "flash_jpeg_test.jpg";
+    gil::rgb8_image_t image(128, 96, gil::rgb8_pixel_t(200, 100, 50));
+    gil::write_view(path, gil::view(image), gil::jpeg_tag{});
+
+    auto gray = flash::read_jpeg_scaled(path, 20, 15);
+    REQUIRE(gray.rows() == 15);
+    REQUIRE(gray.columns() == 20);
+    auto color = flash::read_jpeg_scaled_channeled(path, 16, 12, flash::bilinear_interpolation{});
+    REQUIRE(color.rows() == 12);
+    REQUIRE(color.columns() == 16);
+    std::remove(path.c_str());
+
+    // JPEG is lossy, allow a small deviation
+    REQUIRE(blaze::max(gray) - blaze::min(gray) <= 2);
+    for (std::size_t i = 0; i < color.rows(); ++i) {
+        for (std::size_t j = 0; j < color.columns(); ++j) {
+            REQUIRE(std::abs(color(i, j)[0] - 200) <= 3);
+            REQUIRE(std::abs(color(i, j)[1] - 100) <= 3);
+            REQUIRE(std::abs(color(i, j)[2] - 50) <= 3);
+        }
+    }
+}
+
+TEST_CASE("missing file is reported", "[jpeg]")
+{
+    REQUIRE_THROWS_AS(flash::read_jpeg_scaled("does_not_exist.jpg", 10, 10), std::runtime_error);
+}
+
+TEST_CASE("truncated file is reported", "[jpeg]")
+{
+    const std::string path = "flash_jpeg_truncated_test.jpg";
+    gil::gray8_image_t image(64, 64, gil::gray8_pixel_t(128));
+    gil::write_view(path, gil::view(image), gil::jpeg_tag{});
+
+    // cut inside the header, so that the scan data is missing
+    std::vector<char> bytes(20);
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    REQUIRE(file != nullptr);
+    REQUIRE(std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size());
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "wb");
+    REQUIRE(file != nullptr);
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    std::fclose(file);
+
+    REQUIRE_THROWS_AS(flash::read_jpeg_scaled(path, 10, 10), std::runtime_error);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,53 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/algorithm.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/kernels.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace gil = boost::gil;
+
+TEST_CASE("precompiled to_matrix and from_matrix round trip gray8", "[kernels]")
+{
+    gil::gray8_image_t image(5, 3);
+    auto view = gil::view(image);
+    for (flash::signed_size i = 0; i < view.height(); ++i) {
+        for (flash::signed_size j = 0; j < view.width(); ++j) {
+            view(j, i) = gil::gray8_pixel_t(static_cast<std::uint8_t>(i * 10 + j));
+        }
+    }
+
+    blaze::DynamicMatrix<std::uint8_t> matrix(3, 5);
+    flash::to_matrix(view, matrix);
+    REQUIRE(matrix(2, 4) == 24);
+
+    auto result = flash::from_matrix<gil::gray8_image_t>(matrix, flash::truncate_conversion{});
+    REQUIRE(gil::equal_pixels(gil::const_view(result), gil::const_view(image)));
+}
+
+TEST_CASE("precompiled convolve widens bytes into int16", "[kernels]")
+{
+    // rows of 0 above rows of 255, a horizontal edge
+    blaze::DynamicMatrix<std::uint8_t> source(6, 6, 0);
+    blaze::submatrix(source, 3, 0, 3, 6) = 255;
+
+    auto gradient = flash::convolve<std::int16_t>(source, flash::sobel_x);
+    STATIC_REQUIRE(std::is_same_v<blaze::ElementType_t<decltype(gradient)>, std::int16_t>);
+    REQUIRE(blaze::max(blaze::abs(gradient)) == 1020);
+    REQUIRE(gradient(3, 3) == 0);
+}
+
+TEST_CASE("precompiled diffusion of a float matrix keeps a constant image", "[kernels]")
+{
+    blaze::DynamicMatrix<float> input(4, 7, 42.0f);
+    auto diffused = flash::anisotropic_diffusion<float>(input, 0.1, 15, 5);
+    for (std::size_t i = 0; i < diffused.rows(); ++i) {
+        for (std::size_t j = 0; j < diffused.columns(); ++j) {
+            REQUIRE(diffused(i, j) == Approx(42.0f));
+        }
+    }
+}
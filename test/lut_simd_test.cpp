@@ -0,0 +1,99 @@
+/* The SIMD lookups of lut.hpp are compiled only with -mssse3 or -mavx2, this file is built into an
+   executable per instruction set (see test/CMakeLists.txt). It exits with 77, which ctest reports
+   as skipped, when the host lacks the instruction set.
+*/
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/lut.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#define FLASH_LUT_TEST_ISA "avx2"
+#elif defined(__SSSE3__)
+#define FLASH_LUT_TEST_ISA "ssse3"
+#else
+#error "lut_simd_test.cpp must be compiled with -mssse3 or -mavx2"
+#endif
+
+/// the scalar fallback of `lookup_row`, element by element
+template <typename T, typename U>
+std::vector<U> lookup_scalar(const std::vector<T>& source, const U* table)
+{
+    std::vector<U> result(source.size());
+    for (std::size_t j = 0; j < source.size(); ++j) {
+        result[j] = table[source[j]];
+    }
+    return result;
+}
+
+TEST_CASE("SIMD byte lookup matches the scalar fallback", "[lut]")
+{
+    const auto lut = flash::make_lut<std::uint8_t>(
+        [](std::uint8_t key) { return static_cast<std::uint8_t>(key * 7 + 3); });
+    // every tail length of the 32 and 16 byte loops, keys cover all 16 slices
+    for (std::size_t count = 0; count <= 100; ++count) {
+        std::vector<std::uint8_t> source(count);
+        for (std::size_t j = 0; j < count; ++j) {
+            source[j] = static_cast<std::uint8_t>(j * 37 + 11);
+        }
+        std::vector<std::uint8_t> target(count);
+        flash::detail::lookup_row(source.data(), target.data(), count, lut.data());
+        REQUIRE(target == lookup_scalar(source, lut.data()));
+    }
+}
+
+TEST_CASE("SIMD gather lookup matches the scalar fallback", "[lut]")
+{
+    const auto narrow = flash::make_lut<std::uint8_t>(
+        [](std::uint8_t key) { return static_cast<float>(key) * 0.5f - 3.0f; });
+    const auto wide = flash::make_lut<std::uint16_t>(
+        [](std::uint16_t key) { return static_cast<std::uint32_t>(key) * 2654435761u; });
+    for (std::size_t count = 0; count <= 40; ++count) {
+        std::vector<std::uint8_t> narrow_source(count);
+        std::vector<std::uint16_t> wide_source(count);
+        for (std::size_t j = 0; j < count; ++j) {
+            narrow_source[j] = static_cast<std::uint8_t>(j * 37 + 11);
+            wide_source[j] = static_cast<std::uint16_t>(j * 4099 + 7);
+        }
+        std::vector<float> narrow_target(count);
+        flash::detail::lookup_row(narrow_source.data(), narrow_target.data(), count,
+                                  narrow.data());
+        REQUIRE(narrow_target == lookup_scalar(narrow_source, narrow.data()));
+        std::vector<std::uint32_t> wide_target(count);
+        flash::detail::lookup_row(wide_source.data(), wide_target.data(), count, wide.data());
+        REQUIRE(wide_target == lookup_scalar(wide_source, wide.data()));
+    }
+}
+
+TEST_CASE("apply_lut on SIMD rows matches the table", "[lut]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(5, 71);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<std::uint8_t>(i * 37 + j * 11);
+        }
+    }
+    const auto inverted = flash::make_lut<std::uint8_t>(
+        [](std::uint8_t key) { return static_cast<std::uint8_t>(255 - key); });
+
+    auto result = flash::apply_lut(input, inverted);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(result(i, j) == inverted(input(i, j)));
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports(FLASH_LUT_TEST_ISA)) {
+        return 77;
+    }
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/lut.hpp>
+#include <flash/planar.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("lookup table evaluates the function over every key", "[lut]")
+{
+    const auto gamma = flash::make_lut<std::uint8_t>([](std::uint8_t value) {
+        return static_cast<std::uint8_t>(std::lround(255 * std::pow(value / 255.0, 1 / 2.2)));
+    });
+    REQUIRE(gamma(0) == 0);
+    REQUIRE(gamma(255) == 255);
+    REQUIRE(gamma(128) == 186);
+
+    REQUIRE_THROWS_AS((flash::lookup_table<std::uint8_t, int>(std::vector<int>(255))),
+                      std::invalid_argument);
+}
+
+TEST_CASE("apply_lut on scalar matrices", "[lut]")
+{
+    // wider than the SIMD widths, so that both vectorized and scalar parts are exercised
+    blaze::DynamicMatrix<std::uint8_t> input(5, 71);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<std::uint8_t>(i * 37 + j * 11);
+        }
+    }
+
+    const auto threshold = flash::make_lut<std::uint8_t>(
+        [](std::uint8_t value) -> std::uint8_t { return value > 100 ? 255 : 0; });
+    const auto halves =
+        flash::make_lut<std::uint8_t>([](std::uint8_t value) { return value * 0.5f; });
+    auto thresholded = flash::apply_lut(input, threshold);
+    auto halved = flash::apply_lut(input, halves);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(thresholded(i, j) == (input(i, j) > 100 ? 255 : 0));
+            REQUIRE(halved(i, j) == input(i, j) * 0.5f);
+        }
+    }
+
+    blaze::DynamicMatrix<std::uint16_t, blaze::columnMajor> wide(3, 4, 1000);
+    const auto inverted =
+        flash::make_lut<std::uint16_t>([](std::uint16_t value) { return 65535 - value; });
+    REQUIRE(flash::apply_lut(wide, inverted) ==
+            blaze::DynamicMatrix<int, blaze::columnMajor>(3, 4, 64535));
+}
+
+TEST_CASE("apply_lut on channeled and planar matrices", "[lut]")
+{
+    using vector_t = blaze::StaticVector<std::uint8_t, 3>;
+    blaze::DynamicMatrix<vector_t> input(2, 3, vector_t{10, 20, 30});
+    const std::array<flash::lookup_table<std::uint8_t, std::uint8_t>, 3> luts{
+        flash::lookup_table<std::uint8_t, std::uint8_t>([](std::uint8_t v) { return v + 1; }),
+        flash::lookup_table<std::uint8_t, std::uint8_t>([](std::uint8_t v) { return v + 2; }),
+        flash::lookup_table<std::uint8_t, std::uint8_t>([](std::uint8_t v) { return v + 3; })};
+
+    auto channeled = flash::apply_lut(input, luts);
+    REQUIRE(channeled(1, 2) == blaze::StaticVector<std::uint8_t, 3>{11, 22, 33});
+    auto shared = flash::apply_lut(input, luts[0]);
+    REQUIRE(shared(0, 0) == blaze::StaticVector<std::uint8_t, 3>{11, 21, 31});
+
+    flash::planar_matrix<std::uint8_t, 3> planar(2, 3, 5);
+    auto mapped = flash::apply_lut(planar, luts);
+    REQUIRE(mapped(1, 1) == blaze::StaticVector<std::uint8_t, 3>{6, 7, 8});
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/algorithm.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/core.hpp>
+#include <flash/matrix_image.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace gil = boost::gil;
+
+TEST_CASE("as_view of a scalar matrix", "[matrix_image]")
+{
+    blaze::DynamicMatrix<std::uint8_t> matrix(5, 7);
+    for (std::size_t i = 0; i < matrix.rows(); ++i) {
+        for (std::size_t j = 0; j < matrix.columns(); ++j) {
+            matrix(i, j) = static_cast<std::uint8_t>(i * 10 + j);
+        }
+    }
+
+    auto view = flash::as_view(matrix);
+    STATIC_REQUIRE(std::is_same_v<decltype(view), gil::gray8_view_t>);
+    REQUIRE(view.width() == 7);
+    REQUIRE(view.height() == 5);
+    REQUIRE(view.pixels().row_size() ==
+            static_cast<std::ptrdiff_t>(matrix.spacing() * sizeof(std::uint8_t)));
+    REQUIRE(flash::to_matrix(view) == matrix);
+
+    view(3, 2) = gil::gray8_pixel_t(200);
+    REQUIRE(matrix(2, 3) == 200);
+}
+
+TEST_CASE("as_view of a const matrix is read-only", "[matrix_image]")
+{
+    const blaze::DynamicMatrix<float> matrix(3, 4, 0.5f);
+    auto view = flash::as_view(matrix);
+    STATIC_REQUIRE(std::is_same_v<decltype(view), gil::gray32fc_view_t>);
+    REQUIRE(view(1, 1)[0] == 0.5f);
+}
+
+TEST_CASE("as_view honours submatrix spacing", "[matrix_image]")
+{
+    blaze::DynamicMatrix<std::uint16_t> matrix(6, 6, 1);
+    auto inner = blaze::submatrix(matrix, 1, 2, 3, 3);
+    auto view = flash::as_view(inner);
+    gil::fill_pixels(view, gil::gray16_pixel_t(9));
+    REQUIRE(blaze::sum(blaze::submatrix(matrix, 1, 2, 3, 3)) == 81);
+    REQUIRE(matrix(0, 0) == 1);
+    REQUIRE(matrix(1, 1) == 1);
+    REQUIRE(matrix(4, 2) == 1);
+}
+
+TEST_CASE("as_view of a channeled matrix", "[matrix_image]")
+{
+    using vector_t = blaze::StaticVector<std::uint8_t, 3, blaze::rowVector, blaze::unaligned,
+                                         blaze::unpadded>;
+    blaze::DynamicMatrix<vector_t> matrix(2, 3, vector_t{1, 2, 3});
+    auto view = flash::as_view(matrix);
+    STATIC_REQUIRE(std::is_same_v<decltype(view), gil::rgb8_view_t>);
+    REQUIRE(view(2, 1) == gil::rgb8_pixel_t(1, 2, 3));
+}
+
+TEST_CASE("matrix_image adopts the buffer of a matrix", "[matrix_image]")
+{
+    blaze::DynamicMatrix<std::uint8_t> matrix(4, 6, 42);
+    const auto* buffer = matrix.data();
+
+    flash::matrix_image image(std::move(matrix));
+    REQUIRE(image.width() == 6);
+    REQUIRE(image.height() == 4);
+    REQUIRE(image.matrix().data() == buffer);
+    REQUIRE(&*flash::view(image).begin() == reinterpret_cast<const gil::gray8_pixel_t*>(buffer));
+
+    gil::gray8_image_t expected(6, 4, gil::gray8_pixel_t(42));
+    REQUIRE(gil::equal_pixels(flash::const_view(image), gil::const_view(expected)));
+
+    auto released = image.release();
+    REQUIRE(released.data() == buffer);
+    REQUIRE(image.width() == 0);
+}
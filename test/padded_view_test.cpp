@@ -0,0 +1,175 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/border.hpp>
+#include <flash/convolution.hpp>
+#include <flash/core.hpp>
+#include <flash/numeric.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("padded_view policies on a single row", "[padded_view]")
+{
+    blaze::DynamicMatrix<int> input{{1, 2, 3}};
+
+    SECTION("constant")
+    {
+        blaze::DynamicMatrix<int> result = flash::padded_view(input, 2, flash::constant_border{7});
+        REQUIRE(result.rows() == 5);
+        REQUIRE(result.columns() == 7);
+        REQUIRE(blaze::row(result, 2) == blaze::DynamicVector<int, blaze::rowVector>{
+                                              7, 7, 1, 2, 3, 7, 7});
+        REQUIRE(blaze::row(result, 0) == 7);
+    }
+
+    SECTION("replicate")
+    {
+        blaze::DynamicMatrix<int> result = flash::padded_view(input, 2, flash::replicate_border{});
+        for (std::size_t i = 0; i < result.rows(); ++i) {
+            REQUIRE(blaze::row(result, i) == blaze::DynamicVector<int, blaze::rowVector>{
+                                                 1, 1, 1, 2, 3, 3, 3});
+        }
+    }
+
+    SECTION("reflect")
+    {
+        blaze::DynamicMatrix<int> result = flash::padded_view(input, 2, flash::reflect_border{});
+        REQUIRE(blaze::row(result, 0) == blaze::DynamicVector<int, blaze::rowVector>{
+                                             3, 2, 1, 2, 3, 2, 1});
+    }
+
+    SECTION("wrap")
+    {
+        blaze::DynamicMatrix<int> result = flash::padded_view(input, 2, flash::wrap_border{});
+        REQUIRE(blaze::row(result, 0) == blaze::DynamicVector<int, blaze::rowVector>{
+                                             2, 3, 1, 2, 3, 1, 2});
+    }
+}
+
+TEST_CASE("padded_view get accepts coordinates beyond the padding", "[padded_view]")
+{
+    blaze::DynamicMatrix<int> input{{1, 2}, {3, 4}};
+    auto view = flash::padded_view(input, 1, flash::wrap_border{});
+    REQUIRE(view.get(0, 0) == 1);
+    REQUIRE(view.get(-3, 5) == 4);
+    REQUIRE(view.get(4, -2) == 1);
+    REQUIRE(view(0, 0) == 4);
+    REQUIRE_THROWS(view.at(4, 0));
+}
+
+TEST_CASE("padded_view reflects changes of the source", "[padded_view]")
+{
+    blaze::DynamicMatrix<int> input(3, 3, 5);
+    auto view = flash::padded_view(input, 1, flash::replicate_border{});
+    input(0, 0) = 9;
+    REQUIRE(view(0, 0) == 9);
+    REQUIRE(view(1, 1) == 9);
+}
+
+TEST_CASE("padded_view of an empty matrix throws", "[padded_view]")
+{
+    blaze::DynamicMatrix<int> input;
+    REQUIRE_THROWS_AS(flash::padded_view(input, 1, flash::replicate_border{}),
+                      std::invalid_argument);
+}
+
+TEST_CASE("for_each_border_region visits every element once", "[padded_view]")
+{
+    for (std::size_t size : std::vector<std::size_t>{1, 2, 3, 7}) {
+        blaze::DynamicMatrix<int> visits(size, size + 1, 0);
+        flash::for_each_border_region(
+            visits.rows(),
+            visits.columns(),
+            1,
+            [&](std::size_t i, std::size_t first, std::size_t last) {
+                REQUIRE(i >= 1);
+                REQUIRE(first == 1);
+                REQUIRE(last == visits.columns() - 1);
+                for (std::size_t j = first; j < last; ++j) {
+                    ++visits(i, j);
+                }
+            },
+            [&](std::size_t i, std::size_t j) { ++visits(i, j); });
+        REQUIRE(visits == 1);
+    }
+}
+
+TEST_CASE("convolve with a border policy computes every element", "[padded_view]")
+{
+    blaze::DynamicMatrix<int> input(5, 6);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<int>((i * 7 + j * 3) % 10);
+        }
+    }
+
+    auto check = [&](auto border) {
+        const auto result = flash::convolve(input, flash::sobel_x, border);
+        REQUIRE(result.rows() == input.rows());
+        REQUIRE(result.columns() == input.columns());
+        // the definition of the convolution, centered, read through the lazily padded source
+        const auto padded = flash::padded_view(input, 1, border);
+        for (std::ptrdiff_t i = 0; i < 5; ++i) {
+            for (std::ptrdiff_t j = 0; j < 6; ++j) {
+                int expected = 0;
+                for (std::ptrdiff_t k = 0; k < 3; ++k) {
+                    for (std::ptrdiff_t l = 0; l < 3; ++l) {
+                        expected += padded.get(i + 1 - k, j + 1 - l) * flash::sobel_x(k, l);
+                    }
+                }
+                REQUIRE(result(i, j) == expected);
+            }
+        }
+    };
+    check(flash::constant_border{3});
+    check(flash::replicate_border{});
+    check(flash::reflect_border{});
+    check(flash::wrap_border{});
+}
+
+TEST_CASE("convolve with replicated borders has no gradient at the edges", "[padded_view]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(4, 7, 200);
+    REQUIRE(flash::convolve<std::int16_t>(input, flash::sobel_x, flash::replicate_border{}) ==
+            blaze::DynamicMatrix<std::int16_t>(4, 7, 0));
+    const auto zero_padded =
+        flash::convolve<std::int16_t>(input, flash::sobel_x, flash::constant_border{0});
+    REQUIRE(zero_padded(2, 0) == 800);
+    REQUIRE(zero_padded(2, 3) == 0);
+
+    REQUIRE_THROWS_AS(flash::convolve(input, blaze::DynamicMatrix<int>(2, 2, 1),
+                                      flash::replicate_border{}),
+                      std::invalid_argument);
+}
+
+TEST_CASE("pad is a materialized constant padded_view", "[padded_view]")
+{
+    blaze::DynamicMatrix<int> input{{1, 2, 3}, {4, 5, 6}};
+    blaze::DynamicMatrix<int> expected = flash::padded_view(input, 2, flash::constant_border{-1});
+    REQUIRE(flash::pad(input, 2, -1) == expected);
+}
+
+TEST_CASE("anisotropic diffusion keeps a constant matrix constant", "[padded_view]")
+{
+    blaze::DynamicMatrix<double> input(6, 5, 42.0);
+    auto result = flash::anisotropic_diffusion(input, 0.2, 10.0, 5);
+    REQUIRE(result.rows() == input.rows());
+    REQUIRE(result.columns() == input.columns());
+    REQUIRE(result == input);
+}
+
+TEST_CASE("anisotropic diffusion smooths with replicated borders", "[padded_view]")
+{
+    blaze::DynamicMatrix<double> input(5, 5, 0.0);
+    input(0, 0) = 1.0;
+    auto result = flash::anisotropic_diffusion(input, 0.1, 10.0, 1);
+    // two neighbours of the corner are itself through the replicated border
+    const double flux = -1.0 * std::exp(-(0.1 * 0.1));
+    REQUIRE(result(0, 0) == Approx(1.0 + 2 * flux * 0.1));
+    REQUIRE(result(0, 1) == Approx(-flux * 0.1));
+    REQUIRE(result(1, 1) == 0.0);
+}
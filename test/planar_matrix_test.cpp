@@ -0,0 +1,127 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/planar.hpp>
+
+#include <cstdint>
+
+namespace gil = boost::gil;
+
+template <typename ImageType>
+ImageType make_test_image(flash::signed_size width = 5, flash::signed_size height = 4)
+{
+    ImageType image(width, height);
+    auto view = gil::view(image);
+    for (flash::signed_size i = 0; i < view.height(); ++i) {
+        for (flash::signed_size j = 0; j < view.width(); ++j) {
+            view(j, i)[0] = static_cast<std::uint8_t>(i * 10 + j);
+            view(j, i)[1] = static_cast<std::uint8_t>(100 + i);
+            view(j, i)[2] = static_cast<std::uint8_t>(200 + j);
+        }
+    }
+    return image;
+}
+
+TEST_CASE("interleaved image to planar matrix", "[planar_matrix]")
+{
+    auto image = make_test_image<gil::rgb8_image_t>();
+    auto matrix = flash::to_planar_matrix(gil::view(image));
+    STATIC_REQUIRE(std::is_same_v<decltype(matrix), flash::planar_matrix<std::uint8_t, 3>>);
+
+    REQUIRE(matrix.rows() == 4);
+    REQUIRE(matrix.columns() == 5);
+    REQUIRE(matrix.plane(0)(2, 3) == 23);
+    REQUIRE(matrix.plane(1)(2, 3) == 102);
+    REQUIRE(matrix.plane(2)(2, 3) == 203);
+    REQUIRE(matrix(2, 3) == blaze::StaticVector<std::uint8_t, 3>{23, 102, 203});
+}
+
+TEST_CASE("planar matrix round trip through interleaved and planar images", "[planar_matrix]")
+{
+    auto interleaved = make_test_image<gil::rgb8_image_t>();
+    auto planar = make_test_image<gil::rgb8_planar_image_t>();
+
+    auto from_interleaved = flash::to_planar_matrix(gil::view(interleaved));
+    auto from_planar = flash::to_planar_matrix(gil::view(planar));
+    REQUIRE(from_interleaved == from_planar);
+
+    auto back = flash::from_planar_matrix<gil::rgb8_image_t>(from_planar);
+    REQUIRE(gil::equal_pixels(gil::view(back), gil::view(interleaved)));
+    auto back_planar = flash::from_planar_matrix<gil::rgb8_planar_image_t>(from_interleaved);
+    REQUIRE(gil::equal_pixels(gil::view(back_planar), gil::view(planar)));
+}
+
+TEST_CASE("planar channelwise min and max", "[planar_matrix]")
+{
+    auto image = make_test_image<gil::rgb8_image_t>();
+    auto matrix = flash::to_planar_matrix(gil::view(image));
+
+    REQUIRE(flash::channelwise_min(matrix) == blaze::StaticVector<std::uint8_t, 3>{0, 100, 200});
+    REQUIRE(flash::channelwise_max(matrix) == blaze::StaticVector<std::uint8_t, 3>{34, 103, 204});
+}
+
+TEST_CASE("planar remap matches channeled remap", "[planar_matrix]")
+{
+    auto image = make_test_image<gil::rgb8_image_t>();
+    auto planar = flash::to_planar_matrix(gil::view(image));
+    auto channeled = flash::to_matrix_channeled(gil::view(image));
+
+    auto planar_result = flash::remap_to_channeled<std::uint8_t>(planar);
+    auto channeled_result = flash::remap_to_channeled<std::uint8_t>(channeled);
+    for (std::size_t i = 0; i < planar.rows(); ++i) {
+        for (std::size_t j = 0; j < planar.columns(); ++j) {
+            REQUIRE(planar_result(i, j) == channeled_result(i, j));
+        }
+    }
+}
+
+/// the `channel`th channel of `view` as a scalar matrix, built without `planar_matrix`
+template <typename View>
+blaze::DynamicMatrix<std::uint8_t> channel_matrix(const View& view, std::size_t channel)
+{
+    blaze::DynamicMatrix<std::uint8_t> result(view.height(), view.width());
+    for (flash::signed_size i = 0; i < view.height(); ++i) {
+        for (flash::signed_size j = 0; j < view.width(); ++j) {
+            result(i, j) = view(j, i)[channel];
+        }
+    }
+    return result;
+}
+
+TEST_CASE("planar convolve matches scalar convolve of every plane", "[planar_matrix]")
+{
+    auto image = make_test_image<gil::rgb8_image_t>(9, 7);
+    auto planar = flash::to_planar_matrix(gil::view(image));
+    const auto kernel = flash::gaussian_kernel(3, 1.0);
+
+    auto result = flash::convolve(planar, kernel);
+    STATIC_REQUIRE(std::is_same_v<decltype(result), flash::planar_matrix<std::uint8_t, 3>>);
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        REQUIRE(result.plane(channel) ==
+                flash::convolve(channel_matrix(gil::view(image), channel), kernel));
+    }
+}
+
+TEST_CASE("planar anisotropic diffusion matches scalar and channeled diffusion",
+          "[planar_matrix]")
+{
+    auto image = make_test_image<gil::rgb8_image_t>(9, 7);
+    auto planar = flash::to_planar_matrix(gil::view(image));
+    auto channeled = flash::to_matrix_channeled(gil::view(image));
+
+    auto result = flash::anisotropic_diffusion(planar, 0.1, 20.0, 5);
+    STATIC_REQUIRE(std::is_same_v<decltype(result), flash::planar_matrix<double, 3>>);
+    auto channeled_result = flash::anisotropic_diffusion(channeled, 0.1, 20.0, 5);
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        const auto scalar_result = flash::anisotropic_diffusion(
+            channel_matrix(gil::view(image), channel), 0.1, 20.0, 5);
+        REQUIRE(result.plane(channel) == scalar_result);
+        for (std::size_t i = 0; i < planar.rows(); ++i) {
+            for (std::size_t j = 0; j < planar.columns(); ++j) {
+                REQUIRE(result.plane(channel)(i, j) == Approx(channeled_result(i, j)[channel]));
+            }
+        }
+    }
+}
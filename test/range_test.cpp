@@ -0,0 +1,71 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/convolution.hpp>
+#include <flash/numeric.hpp>
+#include <flash/range.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+TEST_CASE("convolved ranges of the Sobel kernels", "[range]")
+{
+    constexpr auto gradient =
+        flash::convolved_range(flash::range_of<std::uint8_t>(), flash::sobel_x_coefficients);
+    STATIC_REQUIRE(gradient.low == -1020);
+    STATIC_REQUIRE(gradient.high == 1020);
+
+    constexpr auto mixed = flash::convolved_range(gradient, flash::sobel_y_coefficients);
+    STATIC_REQUIRE(mixed.low == -8160);
+    STATIC_REQUIRE(mixed.high == 8160);
+    STATIC_REQUIRE(
+        std::is_same_v<flash::accumulator_type_t<flash::accumulator_index(mixed)>, std::int16_t>);
+}
+
+TEST_CASE("narrowest integer types", "[range]")
+{
+    STATIC_REQUIRE(std::is_same_v<flash::narrowest_integer_t<-100, 100>, std::int8_t>);
+    STATIC_REQUIRE(std::is_same_v<flash::narrowest_integer_t<0, 255>, std::uint8_t>);
+    STATIC_REQUIRE(std::is_same_v<flash::narrowest_integer_t<-1, 255>, std::int16_t>);
+    STATIC_REQUIRE(std::is_same_v<flash::narrowest_integer_t<0, 65536>, std::int32_t>);
+
+    constexpr auto product = flash::range_of<std::int32_t>() * flash::range_of<std::int32_t>();
+    STATIC_REQUIRE(
+        std::is_same_v<flash::accumulator_type_t<flash::accumulator_index(product)>, std::int64_t>);
+    constexpr auto huge = product * product;
+    STATIC_REQUIRE(
+        std::is_same_v<flash::accumulator_type_t<flash::accumulator_index(huge)>, double>);
+}
+
+TEST_CASE("convolve accumulates in the requested type", "[range]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(6, 6, 0);
+    blaze::submatrix(input, 0, 0, 3, 6) = 255;
+
+    auto wrapped = flash::convolve(input, flash::sobel_x);
+    auto gradient = flash::convolve<std::int16_t>(input, flash::sobel_x);
+    STATIC_REQUIRE(std::is_same_v<blaze::ElementType_t<decltype(gradient)>, std::int16_t>);
+    REQUIRE(blaze::max(blaze::abs(gradient)) == 1020);
+    REQUIRE(blaze::max(wrapped) < 255);
+}
+
+TEST_CASE("detectors use the narrowest safe types", "[range]")
+{
+    using harris_types = flash::detail::harris_types<std::uint8_t>;
+    STATIC_REQUIRE(std::is_same_v<harris_types::gradient_type, std::int16_t>);
+    STATIC_REQUIRE(std::is_same_v<harris_types::response_type, std::int64_t>);
+    STATIC_REQUIRE(std::is_same_v<flash::detail::harris_types<float>::gradient_type, float>);
+
+    blaze::DynamicMatrix<std::uint8_t> input(8, 8, 0);
+    blaze::submatrix(input, 4, 4, 4, 4) = 255;
+    blaze::DynamicMatrix<std::int64_t> wide(input);
+
+    auto narrow = flash::harris(input, 0.04);
+    STATIC_REQUIRE(std::is_same_v<blaze::ElementType_t<decltype(narrow)>, std::int64_t>);
+    auto reference = flash::harris(wide, 0.04);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            REQUIRE(static_cast<double>(narrow(i, j)) == Approx(reference(i, j)).margin(1));
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/reduction.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <random>
+#include <type_traits>
+
+TEST_CASE("sum of uint8 matrix does not overflow", "[reduction]")
+{
+    blaze::DynamicMatrix<std::uint8_t> matrix(300, 500, 255);
+    auto total = flash::sum(matrix);
+    STATIC_REQUIRE(std::is_same_v<decltype(total), std::uint64_t>);
+    REQUIRE(total == 255ull * 300 * 500);
+}
+
+TEST_CASE("reductions of channeled matrix", "[reduction]")
+{
+    using vector_type = blaze::StaticVector<std::uint8_t, 3>;
+    blaze::DynamicMatrix<vector_type> matrix(17, 23, vector_type{1, 2, 3});
+    matrix(5, 7) = {0, 200, 3};
+
+    REQUIRE(flash::sum(matrix) ==
+            blaze::StaticVector<std::uint64_t, 3>{17 * 23 - 1, 17 * 23 * 2 + 198, 17 * 23 * 3});
+    REQUIRE(flash::min(matrix) == vector_type{0, 2, 3});
+    REQUIRE(flash::max(matrix) == vector_type{1, 200, 3});
+    const auto mean = flash::mean(matrix);
+    REQUIRE(mean[2] == Approx(3.0));
+    REQUIRE(flash::variance(matrix)[2] == Approx(0.0));
+}
+
+TEST_CASE("mean and variance match Blaze", "[reduction]")
+{
+    std::mt19937 twister(7);
+    std::normal_distribution<double> dist(1000.0, 3.0);
+    blaze::DynamicMatrix<double> matrix(123, 77);
+    for (std::size_t i = 0; i < matrix.rows(); ++i) {
+        for (std::size_t j = 0; j < matrix.columns(); ++j) {
+            matrix(i, j) = dist(twister);
+        }
+    }
+
+    REQUIRE(flash::sum(matrix) == Approx(blaze::sum(matrix)));
+    REQUIRE(flash::mean(matrix) == Approx(blaze::mean(matrix)));
+    REQUIRE(flash::variance(matrix) == Approx(blaze::var(matrix)));
+    REQUIRE(flash::min(matrix) == blaze::min(matrix));
+    REQUIRE(flash::max(matrix) == blaze::max(matrix));
+}
+
+TEST_CASE("floating point sum is reproducible", "[reduction]")
+{
+    std::mt19937 twister(11);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    blaze::DynamicMatrix<float> matrix(700, 333);
+    for (std::size_t i = 0; i < matrix.rows(); ++i) {
+        for (std::size_t j = 0; j < matrix.columns(); ++j) {
+            matrix(i, j) = dist(twister);
+        }
+    }
+
+    // bitwise equal, blocks and combination order do not depend on scheduling
+    const auto first = flash::sum(matrix);
+    STATIC_REQUIRE(std::is_same_v<decltype(first), const double>);
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        REQUIRE(flash::sum(matrix) == first);
+    }
+    // the result depends on values and sizes only, not on the memory it is read from
+    blaze::DynamicMatrix<float> copy = blaze::submatrix(matrix, 0, 0, 700, 333);
+    REQUIRE(flash::sum(copy) == first);
+
+    // from a block per row to a single block, combined in parallel and as a tree
+    for (std::size_t block_lines : {1, 3, 64, 700}) {
+        const auto blocked =
+            flash::detail::reduce_matrix(matrix, flash::detail::sum_operation{}, block_lines);
+        REQUIRE(blocked == Approx(first).epsilon(1e-12));
+        REQUIRE(flash::detail::reduce_matrix(matrix, flash::detail::sum_operation{},
+                                             block_lines) == blocked);
+    }
+}
+
+TEST_CASE("reducing empty matrix throws", "[reduction]")
+{
+    blaze::DynamicMatrix<int> matrix;
+    REQUIRE_THROWS_AS(flash::sum(matrix), std::invalid_argument);
+    REQUIRE_THROWS_AS(flash::minmax(matrix), std::invalid_argument);
+}
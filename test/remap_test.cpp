@@ -74,3 +74,33 @@ TEST_CASE("test remap_to_channeled - linear case", "[remap_test]")
     auto result = flash::remap_to_channeled<std::uint8_t>(matrix);
     REQUIRE(result == expected);
 }
+
+TEST_CASE("test remap_to - writes into view", "[remap_test]")
+{
+    blaze::DynamicMatrix<std::uint16_t> input(4, 5);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<std::uint16_t>(1000 + (i * 5 + j) * 100);
+        }
+    }
+
+    boost::gil::gray8_image_t image(5, 4);
+    flash::remap_to(input, boost::gil::view(image));
+    blaze::DynamicMatrix<std::uint8_t> expected = flash::remap_to<std::uint8_t>(input);
+    REQUIRE(flash::to_matrix(boost::gil::view(image)) == expected);
+    REQUIRE(expected(0, 0) == 0);
+    REQUIRE(expected(3, 4) == 255);
+}
+
+TEST_CASE("test remap_to_channeled - writes into view", "[remap_test]")
+{
+    blaze::DynamicMatrix<blaze::StaticVector<int, 3>> matrix(2, 8, {0, 0, 0});
+    for (unsigned int counter = 0; counter < 16; ++counter) {
+        matrix(counter / 8, counter % 8)[1] = counter;
+    }
+
+    boost::gil::rgb8_image_t image(8, 2);
+    flash::remap_to_channeled(matrix, boost::gil::view(image));
+    auto expected = flash::remap_to_channeled<std::uint8_t>(matrix);
+    REQUIRE(flash::to_matrix_channeled(boost::gil::view(image)) == expected);
+}
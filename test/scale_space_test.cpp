@@ -0,0 +1,47 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/scale_space.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+TEST_CASE("octave layout and sigmas", "[scale_space]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(64, 48, 10);
+    flash::scale_space<> space(input, 3, 3);
+
+    REQUIRE(space.octave_count() == 3);
+    REQUIRE(space.level_count() == 6);
+    REQUIRE(space.dog_count() == 5);
+    REQUIRE(space.level(1, 0).rows() == 32);
+    REQUIRE(space.level(1, 0).columns() == 24);
+    REQUIRE(space.level(2, 0).rows() == 16);
+    REQUIRE(space.sigma(0, 0) == Approx(1.6));
+    REQUIRE(space.sigma(0, 3) == Approx(3.2));
+    REQUIRE(space.sigma(1, 0) == Approx(space.sigma(0, 3)));
+}
+
+TEST_CASE("constant image has zero difference of Gaussians", "[scale_space]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(32, 32, 100);
+    flash::scale_space<> space(input, 2, 2);
+
+    for (std::size_t octave = 0; octave < space.octave_count(); ++octave) {
+        for (std::size_t k = 0; k < space.dog_count(); ++k) {
+            blaze::DynamicMatrix<float> dog = space.dog(octave, k);
+            REQUIRE(blaze::max(blaze::abs(dog)) < 1e-3f);
+        }
+    }
+}
+
+TEST_CASE("incremental blur matches direct blur", "[scale_space]")
+{
+    blaze::DynamicMatrix<float> input(40, 40, 0.0f);
+    input(20, 20) = 1000.0f;
+    flash::scale_space<> space(input, 1, 3, 1.6, 0.0);
+
+    const auto sigma = space.sigma(0, 3);
+    auto direct = flash::gaussian_blur<float>(input, sigma);
+    REQUIRE(blaze::max(blaze::abs(direct - space.level(0, 3))) < 0.5f);
+}
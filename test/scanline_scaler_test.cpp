@@ -0,0 +1,129 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/scaling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+template <typename Method>
+blaze::DynamicMatrix<std::uint8_t> scale_rows(Method method,
+                                              const blaze::DynamicMatrix<std::uint8_t>& source,
+                                              std::size_t new_width, std::size_t new_height)
+{
+    blaze::DynamicMatrix<std::uint8_t> result(new_height, new_width, 0);
+    flash::scale_streaming<std::uint8_t>(
+        method,
+        source.columns(),
+        source.rows(),
+        new_width,
+        new_height,
+        [&source](std::size_t i, auto& row) { row = blaze::row(source, i); },
+        [&result](std::size_t i, const auto& row) { blaze::row(result, i) = row; });
+    return result;
+}
+
+TEST_CASE("constant image stays constant", "[scanline_scaler]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(32, 24, 100);
+    blaze::DynamicMatrix<std::uint8_t> expected(10, 50, 100);
+
+    REQUIRE(scale_rows(flash::nearest_neighbor{}, input, 50, 10) == expected);
+    REQUIRE(scale_rows(flash::bilinear_interpolation{}, input, 50, 10) == expected);
+    REQUIRE(scale_rows(flash::lanczos_method{}, input, 50, 10) == expected);
+}
+
+TEST_CASE("lanczos kernel is the windowed sinc", "[scanline_scaler]")
+{
+    REQUIRE(flash::lanczos(0, 3) == 1);
+    REQUIRE(flash::lanczos(2.5, 3) == Approx(0.0243171).epsilon(1e-5));
+    REQUIRE(flash::lanczos(-0.5, 3) == Approx(0.6079271).epsilon(1e-5));
+    REQUIRE(flash::lanczos(1, 3) == Approx(0).margin(1e-12));
+    REQUIRE(flash::lanczos(3.5, 3) == 0);
+}
+
+TEST_CASE("lanczos upscaling of an impulse yields the normalized kernel", "[scanline_scaler]")
+{
+    constexpr std::size_t width = 16;
+    constexpr std::size_t impulse = 8;
+    blaze::DynamicMatrix<double> input(1, width, 0.0);
+    input(0, impulse) = 1;
+
+    blaze::DynamicMatrix<double> result(1, 2 * width, 0.0);
+    flash::scale_streaming<double>(
+        flash::lanczos_method{},
+        width,
+        1,
+        2 * width,
+        1,
+        [&input](std::size_t i, auto& row) { row = blaze::row(input, i); },
+        [&result](std::size_t i, const auto& row) { blaze::row(result, i) = row; });
+
+    // reference weights of a*sinc(x)*sinc(x/a) / (pi^2 x^2) form, normalized over the taps
+    auto reference = [](double x) {
+        if (x == 0) {
+            return 1.0;
+        }
+        const double px = flash::pi * x;
+        return std::abs(x) < 3 ? 3 * std::sin(px) * std::sin(px / 3) / (px * px) : 0.0;
+    };
+    for (std::size_t target = 0; target < result.columns(); ++target) {
+        const double center = target * 0.5;
+        const auto low = std::max(std::ceil(center - 3), 0.0);
+        const auto high = std::min(std::floor(center + 3), width - 1.0);
+        double total = 0;
+        for (double i = low; i <= high; ++i) {
+            total += reference(i - center);
+        }
+        const bool covered = low <= impulse && impulse <= high;
+        const double expected = covered ? reference(impulse - center) / total : 0.0;
+        REQUIRE(result(0, target) == Approx(expected).margin(1e-12));
+    }
+}
+
+TEST_CASE("nearest neighbor matches in-memory scale", "[scanline_scaler]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(16, 16);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<std::uint8_t>(i * 16 + j);
+        }
+    }
+
+    auto expected = flash::scale(flash::nearest_neighbor{}, input, 7, 5);
+    REQUIRE(scale_rows(flash::nearest_neighbor{}, input, 7, 5) == expected);
+}
+
+TEST_CASE("rows are emitted in order and only once", "[scanline_scaler]")
+{
+    blaze::DynamicMatrix<std::uint8_t> input(64, 8, 1);
+    flash::scanline_scaler<std::uint8_t, flash::lanczos_method> scaler(
+        flash::lanczos_method{}, 8, 64, 8, 16, 3);
+    std::size_t expected_row = 0;
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        scaler.push_row(blaze::row(input, i), [&expected_row](std::size_t row, const auto&) {
+            REQUIRE(row == expected_row);
+            ++expected_row;
+        });
+    }
+
+    REQUIRE(scaler.finished());
+    REQUIRE(expected_row == 16);
+    REQUIRE_THROWS_AS(scaler.push_row(blaze::row(input, 0), [](std::size_t, const auto&) {}),
+                      std::logic_error);
+}
+
+TEST_CASE("scale between views without intermediate matrices", "[scanline_scaler]")
+{
+    namespace gil = boost::gil;
+    gil::rgba8_image_t input(24, 32, gil::rgba8_pixel_t(10, 20, 30, 40));
+    gil::rgba8_image_t output(12, 8);
+    flash::scale(flash::lanczos_method{},
+                 flash::as_matrix_channeled(gil::view(input)),
+                 gil::view(output),
+                 3);
+
+    gil::rgba8_image_t expected(12, 8, gil::rgba8_pixel_t(10, 20, 30, 40));
+    REQUIRE(gil::equal_pixels(gil::view(output), gil::view(expected)));
+}
@@ -80,4 +80,55 @@ TEST_CASE("rgb8 image with differing values to matrix value check", "[to_matrix_
 
     auto result = flash::to_matrix_channeled(gil::view(input));
     REQUIRE(result == expected);
-}
\ No newline at end of file
+}
+
+TEST_CASE("rgb8 planar image with differing values to matrix value check",
+          "[to_matrix_channeled]")
+{
+    gil::rgb8_planar_image_t input(16, 16, gil::rgb8_pixel_t(1, 2, 3));
+    auto view = gil::view(input);
+    view(0, 0) = gil::rgb8_pixel_t(10, 20, 30);
+    view(1, 0) = gil::rgb8_pixel_t(50, 60, 70);
+
+    blaze::StaticVector<std::uint8_t, 3> default_vector({1, 2, 3});
+    blaze::DynamicMatrix<blaze::StaticVector<std::uint8_t, 3>> expected(16, 16, default_vector);
+    expected(0, 0) = {10, 20, 30};
+    expected(0, 1) = {50, 60, 70};
+
+    auto result = flash::to_matrix_channeled(view);
+    STATIC_REQUIRE(std::is_same_v<blaze::StaticVector<std::uint8_t, 3>,
+                                  blaze::UnderlyingElement_t<decltype(result)>>);
+    REQUIRE(result == expected);
+}
+
+TEST_CASE("rgb16 image with differing values to matrix value check", "[to_matrix_channeled]")
+{
+    gil::rgb16_image_t input(16, 16, gil::rgb16_pixel_t(1000, 2000, 3000));
+    auto view = gil::view(input);
+    view(3, 2) = gil::rgb16_pixel_t(40000, 50000, 60000);
+
+    blaze::StaticVector<std::uint16_t, 3> default_vector({1000, 2000, 3000});
+    blaze::DynamicMatrix<blaze::StaticVector<std::uint16_t, 3>> expected(16, 16, default_vector);
+    expected(2, 3) = {40000, 50000, 60000};
+
+    auto result = flash::to_matrix_channeled(view);
+    STATIC_REQUIRE(std::is_same_v<blaze::StaticVector<std::uint16_t, 3>,
+                                  blaze::UnderlyingElement_t<decltype(result)>>);
+    REQUIRE(result == expected);
+}
+
+TEST_CASE("gray32f image with differing values to matrix value check", "[to_matrix_channeled]")
+{
+    gil::gray32f_image_t input(16, 16, gil::gray32f_pixel_t(0.25f));
+    auto view = gil::view(input);
+    view(5, 7) = gil::gray32f_pixel_t(0.75f);
+
+    blaze::DynamicMatrix<blaze::StaticVector<float, 1>> expected(
+        16, 16, blaze::StaticVector<float, 1>{0.25f});
+    expected(7, 5) = {0.75f};
+
+    auto result = flash::to_matrix_channeled(view);
+    STATIC_REQUIRE(std::is_same_v<blaze::StaticVector<float, 1>,
+                                  blaze::UnderlyingElement_t<decltype(result)>>);
+    REQUIRE(result == expected);
+}
@@ -135,4 +135,18 @@ TEST_CASE("rgb8s to_matrix", "[to_matrix]")
     using image_type = gil::rgb8s_image_t;
     test_to_matrix_type<image_type>();
     test_to_matrix_out<image_type>();
-}
\ No newline at end of file
+}
+
+TEST_CASE("rgb8 planar to_matrix", "[to_matrix]")
+{
+    using image_type = gil::rgb8_planar_image_t;
+    test_to_matrix_type<image_type>();
+    test_to_matrix_out<image_type>();
+}
+
+TEST_CASE("gray32f to_matrix", "[to_matrix]")
+{
+    using image_type = gil::gray32f_image_t;
+    test_to_matrix_type<image_type>();
+    test_to_matrix_out<image_type, float>();
+}
@@ -0,0 +1,171 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <flash/core.hpp>
+#include <flash/numeric.hpp>
+#include <flash/planar.hpp>
+#include <flash/transpose.hpp>
+#include <flash/workspace.hpp>
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace gil = boost::gil;
+
+template <typename T>
+blaze::DynamicMatrix<T> make_sequence(std::size_t rows, std::size_t columns)
+{
+    blaze::DynamicMatrix<T> result(rows, columns);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < columns; ++j) {
+            result(i, j) = static_cast<T>(i * 7 + j * 3);
+        }
+    }
+    return result;
+}
+
+TEMPLATE_TEST_CASE("blocked transpose matches blaze::trans", "[transpose]", std::uint8_t,
+                   std::uint16_t, float, double)
+{
+    // partial tiles and several levels of blocks
+    for (auto [rows, columns] : {std::pair<std::size_t, std::size_t>{1, 1},
+                                 {5, 3},
+                                 {16, 16},
+                                 {33, 70},
+                                 {131, 200}}) {
+        const auto source = make_sequence<TestType>(rows, columns);
+        const auto transposed = flash::transpose(source);
+        STATIC_REQUIRE(std::is_same_v<decltype(transposed), const blaze::DynamicMatrix<TestType>>);
+        REQUIRE(transposed == blaze::trans(source));
+
+        const blaze::DynamicMatrix<TestType, blaze::columnMajor> column_source(source);
+        REQUIRE(flash::transpose(column_source) == blaze::trans(source));
+    }
+}
+
+TEST_CASE("transpose of vector elements and expressions", "[transpose]")
+{
+    using vector_type = blaze::StaticVector<std::uint8_t, 3>;
+    blaze::DynamicMatrix<vector_type> source(20, 9);
+    for (std::size_t i = 0; i < source.rows(); ++i) {
+        for (std::size_t j = 0; j < source.columns(); ++j) {
+            source(i, j) = vector_type{std::uint8_t(i), std::uint8_t(j), std::uint8_t(i + j)};
+        }
+    }
+    REQUIRE(flash::transpose(source) == blaze::trans(source));
+
+    const auto sequence = make_sequence<float>(40, 24);
+    REQUIRE(flash::transpose(sequence * 2.0f) == blaze::trans(sequence * 2.0f));
+    REQUIRE(flash::transpose(blaze::submatrix(sequence, 3, 5, 30, 17)) ==
+            blaze::trans(blaze::submatrix(sequence, 3, 5, 30, 17)));
+}
+
+TEST_CASE("transpose of unpadded 4 byte pixels uses the tiles", "[transpose]")
+{
+    using pixel_type = blaze::
+        StaticVector<std::uint8_t, 4, blaze::columnVector, blaze::unaligned, blaze::unpadded>;
+    STATIC_REQUIRE(sizeof(pixel_type) == 4);
+    STATIC_REQUIRE(flash::detail::is_tile_transposable_v<pixel_type>);
+    STATIC_REQUIRE(!flash::detail::is_tile_transposable_v<blaze::StaticVector<std::uint8_t, 4>>);
+
+    blaze::DynamicMatrix<pixel_type> source(37, 29);
+    for (std::size_t i = 0; i < source.rows(); ++i) {
+        for (std::size_t j = 0; j < source.columns(); ++j) {
+            source(i, j) = pixel_type{
+                std::uint8_t(i), std::uint8_t(j), std::uint8_t(i + j), std::uint8_t(i * j)};
+        }
+    }
+    REQUIRE(flash::transpose(source) == blaze::trans(source));
+}
+
+TEST_CASE("storage order conversion keeps the elements", "[transpose]")
+{
+    const auto source = make_sequence<std::int16_t>(70, 45);
+    const auto columns = flash::to_storage_order<blaze::columnMajor>(source);
+    STATIC_REQUIRE(std::is_same_v<decltype(columns),
+                                  const blaze::DynamicMatrix<std::int16_t, blaze::columnMajor>>);
+    REQUIRE(columns == source);
+    REQUIRE(flash::to_storage_order<blaze::rowMajor>(columns) == source);
+}
+
+TEST_CASE("image conversions transpose into and out of column major matrices", "[transpose]")
+{
+    gil::gray8_image_t image(37, 21);
+    auto view = gil::view(image);
+    for (flash::signed_size i = 0; i < view.height(); ++i) {
+        for (flash::signed_size j = 0; j < view.width(); ++j) {
+            view(j, i) = gil::gray8_pixel_t(static_cast<std::uint8_t>(i * 5 + j));
+        }
+    }
+
+    blaze::DynamicMatrix<float, blaze::columnMajor> matrix;
+    flash::to_matrix(view, matrix);
+    REQUIRE(matrix == flash::to_matrix(view));
+
+    auto result = flash::from_matrix<gil::gray8_image_t>(matrix);
+    REQUIRE(gil::equal_pixels(gil::const_view(result), gil::const_view(image)));
+}
+
+TEST_CASE("column major diffusion runs on the transpose", "[transpose]")
+{
+    const auto source = make_sequence<double>(12, 17);
+    const blaze::DynamicMatrix<double, blaze::columnMajor> column_source(source);
+    const auto expected = flash::anisotropic_diffusion(source, 0.1, 15, 3);
+    const auto diffused = flash::anisotropic_diffusion(column_source, 0.1, 15, 3);
+    STATIC_REQUIRE(std::is_same_v<decltype(diffused),
+                                  const blaze::DynamicMatrix<double, blaze::columnMajor>>);
+    for (std::size_t i = 0; i < source.rows(); ++i) {
+        for (std::size_t j = 0; j < source.columns(); ++j) {
+            REQUIRE(diffused(i, j) == Approx(expected(i, j)));
+        }
+    }
+}
+
+TEST_CASE("diffusion output storage order is converted blockwise", "[transpose]")
+{
+    using row_type = blaze::DynamicMatrix<double>;
+    using column_type = blaze::DynamicMatrix<double, blaze::columnMajor>;
+    const auto source = make_sequence<double>(12, 17);
+    const column_type column_source(source);
+    const auto expected = flash::anisotropic_diffusion(source, 0.1, 15, 3);
+
+    const auto rows = flash::anisotropic_diffusion<column_type, blaze::columnMajor,
+                                                   blaze::rowMajor>(column_source, 0.1, 15, 3);
+    STATIC_REQUIRE(std::is_same_v<decltype(rows), const row_type>);
+    const auto columns = flash::anisotropic_diffusion<row_type, blaze::rowMajor,
+                                                      blaze::columnMajor>(source, 0.1, 15, 3);
+    STATIC_REQUIRE(std::is_same_v<decltype(columns), const column_type>);
+
+    flash::workspace arena;
+    const auto arena_rows = flash::anisotropic_diffusion<column_type, blaze::columnMajor,
+                                                         blaze::rowMajor>(
+        column_source, 0.1, 15, 3, arena);
+    const auto arena_columns = flash::anisotropic_diffusion(column_source, 0.1, 15, 3, arena);
+    STATIC_REQUIRE(blaze::IsColumnMajorMatrix_v<std::remove_cv_t<decltype(arena_columns)>>);
+    const auto arena_transposed = flash::anisotropic_diffusion<row_type, blaze::rowMajor,
+                                                               blaze::columnMajor>(
+        source, 0.1, 15, 3, arena);
+
+    for (std::size_t i = 0; i < source.rows(); ++i) {
+        for (std::size_t j = 0; j < source.columns(); ++j) {
+            REQUIRE(rows(i, j) == Approx(expected(i, j)));
+            REQUIRE(columns(i, j) == Approx(expected(i, j)));
+            REQUIRE(arena_rows(i, j) == Approx(expected(i, j)));
+            REQUIRE(arena_columns(i, j) == Approx(expected(i, j)));
+            REQUIRE(arena_transposed(i, j) == Approx(expected(i, j)));
+        }
+    }
+}
+
+TEST_CASE("planar matrices are transposed plane by plane", "[transpose]")
+{
+    flash::planar_matrix<std::uint8_t, 2> source(9, 18);
+    source.plane(0) = make_sequence<std::uint8_t>(9, 18);
+    source.plane(1) = make_sequence<std::uint8_t>(9, 18) * std::uint8_t(2);
+    const auto transposed = flash::transpose(source);
+    REQUIRE(transposed.rows() == 18);
+    REQUIRE(transposed.plane(1) == blaze::trans(source.plane(1)));
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/warp.hpp>
+
+#include <cstdint>
+
+namespace
+{
+blaze::DynamicMatrix<std::uint8_t> make_ramp(std::size_t rows, std::size_t columns)
+{
+    blaze::DynamicMatrix<std::uint8_t> result(rows, columns);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < columns; ++j) {
+            result(i, j) = static_cast<std::uint8_t>(i * columns + j);
+        }
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("identity warp reproduces the source", "[warp]")
+{
+    auto input = make_ramp(13, 17);
+    flash::affine_transform identity{{1, 0, 0}, {0, 1, 0}};
+
+    REQUIRE(flash::warp_affine(input, identity, 17, 13, flash::nearest_neighbor{}) == input);
+    REQUIRE(flash::warp_affine(input, identity, 17, 13, flash::bilinear_interpolation{}) == input);
+}
+
+TEST_CASE("integer translation shifts the source", "[warp]")
+{
+    auto input = make_ramp(8, 8);
+    flash::affine_transform translation{{1, 0, 2}, {0, 1, 1}};
+    auto result = flash::warp_affine(input, translation, 8, 8, flash::nearest_neighbor{}, 0);
+
+    REQUIRE(blaze::submatrix(result, 1, 2, 7, 6) == blaze::submatrix(input, 0, 0, 7, 6));
+    REQUIRE(blaze::isZero(blaze::row(result, 0)));
+    REQUIRE(blaze::isZero(blaze::columns(result, {0, 1})));
+}
+
+TEST_CASE("remap table is reusable across frames", "[warp]")
+{
+    flash::perspective_transform identity{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    auto table = flash::make_remap_table(identity, 70, 65, 16);
+    auto first = make_ramp(65, 70);
+    blaze::DynamicMatrix<std::uint8_t> second(65, 70, 42);
+
+    REQUIRE(flash::warp(first, table, flash::nearest_neighbor{}) == first);
+    REQUIRE(flash::warp(second, table, flash::lanczos_method{}) == second);
+}
+
+TEST_CASE("coordinates beyond 16384 pixels stay exact", "[warp]")
+{
+    // 18000 * 2^16 exceeded the clamp of the former 32 bit fixed point
+    blaze::DynamicMatrix<std::uint8_t> input(2, 20000);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<std::uint8_t>((i + j) % 251);
+        }
+    }
+    flash::affine_transform translation{{1, 0, -18000}, {0, 1, 0}};
+
+    const auto nearest = flash::warp_affine(input, translation, 100, 2, flash::nearest_neighbor{});
+    REQUIRE(nearest == blaze::submatrix(input, 0, 18000, 2, 100));
+    const auto bilinear =
+        flash::warp_affine(input, translation, 100, 2, flash::bilinear_interpolation{});
+    REQUIRE(bilinear == blaze::submatrix(input, 0, 18000, 2, 100));
+}
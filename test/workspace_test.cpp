@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+
+#include <blaze/Blaze.h>
+#include <flash/convolution.hpp>
+#include <flash/core.hpp>
+#include <flash/numeric.hpp>
+#include <flash/scaling.hpp>
+#include <flash/workspace.hpp>
+
+#include <cstdint>
+
+TEST_CASE("workspace matrices are aligned, padded and zeroed", "[workspace]")
+{
+    flash::workspace arena;
+    auto first = arena.matrix<float>(3, 5);
+    auto second = arena.matrix<std::uint8_t>(7, 2);
+    REQUIRE(first.rows() == 3);
+    REQUIRE(first.columns() == 5);
+    REQUIRE(first.spacing() >= 5);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(first.data()) % flash::workspace::alignment == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(second.data()) % flash::workspace::alignment == 0);
+    REQUIRE(blaze::isZero(first));
+    REQUIRE(blaze::isZero(second));
+}
+
+TEST_CASE("workspace reuses memory after reset", "[workspace]")
+{
+    flash::workspace arena;
+    for (int frame = 0; frame < 3; ++frame) {
+        auto a = arena.matrix<double>(64, 64);
+        auto b = arena.matrix<double>(128, 32);
+        auto c = arena.matrix<blaze::StaticVector<double, 3>>(16, 16);
+        a = 1.0;
+        b = 2.0;
+        REQUIRE(blaze::isZero(c));
+        arena.reset();
+        REQUIRE(arena.used() == 0);
+    }
+    const auto capacity = arena.capacity();
+    const auto high_water_mark = arena.high_water_mark();
+    REQUIRE(high_water_mark > 0);
+    REQUIRE(high_water_mark <= capacity);
+
+    arena.matrix<double>(64, 64);
+    arena.matrix<double>(128, 32);
+    arena.matrix<blaze::StaticVector<double, 3>>(16, 16);
+    REQUIRE(arena.capacity() == capacity);
+    REQUIRE(arena.high_water_mark() == high_water_mark);
+}
+
+TEST_CASE("workspace overloads match the allocating ones", "[workspace]")
+{
+    blaze::DynamicMatrix<std::int64_t> input(9, 11);
+    for (std::size_t i = 0; i < input.rows(); ++i) {
+        for (std::size_t j = 0; j < input.columns(); ++j) {
+            input(i, j) = static_cast<std::int64_t>((i * 7 + j * 13) % 17);
+        }
+    }
+
+    flash::workspace arena;
+    REQUIRE(flash::convolve(input, flash::sobel_x, arena) ==
+            flash::convolve(input, flash::sobel_x));
+    REQUIRE(flash::pad(input, 2, 5, arena) == flash::pad(input, 2, 5));
+    REQUIRE(flash::harris(input, 0.04, arena) == flash::harris(input, 0.04));
+
+    blaze::DynamicMatrix<double> values(input);
+    REQUIRE(flash::anisotropic_diffusion(values, 0.1, 5.0, 3, arena) ==
+            flash::anisotropic_diffusion(values, 0.1, 5.0, 3));
+
+    blaze::DynamicMatrix<std::uint8_t> bytes(input);
+    const auto hessian = flash::hessian(bytes, arena);
+    const auto expected_hessian = flash::hessian(bytes);
+    REQUIRE(hessian.determinants == expected_hessian.determinants);
+    REQUIRE(hessian.traces == expected_hessian.traces);
+
+    REQUIRE(flash::scale(flash::nearest_neighbor{}, values, 5, 4, arena) ==
+            flash::scale(flash::nearest_neighbor{}, values, 5, 4));
+    REQUIRE(flash::scale(flash::bilinear_interpolation{}, values, 5, 4, arena) ==
+            flash::scale(flash::bilinear_interpolation{}, values, 5, 4));
+    REQUIRE(flash::scale(flash::lanczos_method{}, values, 5, 4, 3, arena) ==
+            flash::scale(flash::lanczos_method{}, values, 5, 4, 3));
+}